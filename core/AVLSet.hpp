@@ -16,16 +16,30 @@
 // in your data structure.  Instead, you'll need to implement your AVL tree
 // using your own dynamically-allocated nodes, with pointers connecting them,
 // and with your own balancing algorithms used.
+//
+// The nodes come from a NodePool owned by the set, so they're allocated in
+// blocks rather than one at a time, and are all freed together when the
+// set is destroyed.  Each node points to its parent as well as its
+// children, so the traversals and iterators can walk the tree without
+// recursion or a stack, no matter how deep it is.
 
 #ifndef AVLSET_HPP
 #define AVLSET_HPP
 
+#include <algorithm>
 #include <functional>
+#include <future>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <utility>
 #include <typeinfo>
 #include <string>
+#include <system_error>
+#include <thread>
+#include "NodePool.hpp"
 #include "Set.hpp"
+#include "SetException.hpp"
 
 
 
@@ -44,19 +58,44 @@ public:
     // Cleans up the AVLSet so that it leaks no memory.
     virtual ~AVLSet() noexcept;
 
-    // Initializes a new AVLSet to be a copy of an existing one.
+    // Initializes a new AVLSet to be a copy of an existing one.  The copy
+    // has the same shape as the original, and all of its nodes come from a
+    // single allocation, laid out in preorder.
     AVLSet(const AVLSet& s);
 
     // Initializes a new AVLSet whose contents are moved from an
-    // expiring one.
+    // expiring one.  The nodes are taken over as-is, so this runs in
+    // constant time and allocates nothing; the expiring AVLSet is left
+    // empty.
     AVLSet(AVLSet&& s) noexcept;
 
-    // Assigns an existing AVLSet into another.
+    // Assigns an existing AVLSet into another.  If copying fails partway
+    // through (e.g., because memory runs out), the set is left unchanged.
     AVLSet& operator=(const AVLSet& s);
 
-    // Assigns an expiring AVLSet into another.
+    // Assigns an expiring AVLSet into another, in constant time (plus
+    // the time it takes to destroy what was there before), leaving the
+    // expiring one empty.
     AVLSet& operator=(AVLSet&& s) noexcept;
 
+    // swap() exchanges the contents of two AVLSets in constant time,
+    // without allocating anything.
+    void swap(AVLSet& s) noexcept;
+
+
+    // assignSorted() replaces the contents of the set with the elements in
+    // the range [first, last), which must be in ascending order.  Rather
+    // than adding them one at a time in O(n log n) time, it builds a
+    // perfectly balanced tree directly, in O(n) time; when the range can be
+    // measured up front, every node comes from one allocation.  If
+    // verifySorted is true, each element is compared against the one
+    // before it: repeats are skipped, and one that's smaller than the one
+    // before it causes a SetException to be thrown, leaving the set
+    // unchanged.  If verifySorted is false, no comparisons are made at all,
+    // so the elements must be strictly ascending.
+    template <typename Iterator>
+    void assignSorted(Iterator first, Iterator last, bool verifySorted = true);
+
 
     // isImplemented() should be modified to return true if you've
     // decided to implement an AVLSet, false otherwise.
@@ -79,9 +118,23 @@ public:
     virtual unsigned int size() const noexcept override;
 
 
+    // clear() removes every element from the set.  The nodes are freed a
+    // block at a time rather than one by one, so when the elements have
+    // no destructors to run (e.g., ints), this doesn't have to touch each
+    // node at all.
+    void clear() noexcept;
+
+
     // height() returns the height of the AVL tree.  Note that, by definition,
-    // the height of an empty tree is -1.
-    int height() const;
+    // the height of an empty tree is -1.  The height is kept up to date as
+    // elements are added, so this function runs in constant time.
+    int height() const noexcept;
+
+
+    // nodeBlockCount() returns the number of blocks the set's nodes have
+    // been allocated in (see NodePool), which says something about how
+    // close together in memory they are.
+    unsigned int nodeBlockCount() const noexcept;
 
 
     // preorder() calls the given "visit" function for each of the elements
@@ -102,6 +155,138 @@ public:
     void postorder(VisitFunction visit) const;
 
 
+    // These do the same as the traversals above, but take any callable
+    // object (such as a lambda) directly, rather than wrapped in a
+    // VisitFunction, so that the compiler can inline the calls to it.  All
+    // six traversals follow parent pointers rather than recursing, so they
+    // use no extra memory however tall the tree is.  The set mustn't be
+    // changed during a traversal.
+    template <typename Visitor>
+    void preorder(Visitor visit) const;
+
+    template <typename Visitor>
+    void inorder(Visitor visit) const;
+
+    template <typename Visitor>
+    void postorder(Visitor visit) const;
+
+
+private:
+    struct AVLNode;
+
+public:
+    // A const_iterator visits the elements of an AVLSet in ascending order,
+    // in either direction.  It's just a pointer to a node (plus one to the
+    // set, so that the end can be backed away from); moving it follows
+    // child and parent pointers, so it never allocates and takes amortized
+    // constant time per step.  Adding to the set invalidates every
+    // iterator into it.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ElementType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ElementType*;
+        using reference = const ElementType&;
+
+        const_iterator() noexcept;
+
+        reference operator*() const noexcept;
+        pointer operator->() const noexcept;
+
+        const_iterator& operator++() noexcept;
+        const_iterator operator++(int) noexcept;
+        const_iterator& operator--() noexcept;
+        const_iterator operator--(int) noexcept;
+
+        bool operator==(const const_iterator& other) const noexcept;
+        bool operator!=(const const_iterator& other) const noexcept;
+
+    private:
+        friend class AVLSet;
+        const_iterator(const AVLSet* set, const AVLNode* node) noexcept;
+
+        const AVLSet* set;
+        const AVLNode* node;
+    };
+
+    using iterator = const_iterator;
+
+
+    // begin() and end() allow an AVLSet to be iterated (e.g., by a
+    // range-based for loop) in ascending order.
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+
+
+    // lowerBound() returns an iterator to the smallest element that isn't
+    // less than the given one, and upperBound() one to the smallest element
+    // that's greater than it; either returns end() if there's no such
+    // element.  Iterating from lowerBound(a) up to lowerBound(b) visits
+    // every element in [a, b).  Both run in O(log n) time.
+    const_iterator lowerBound(const ElementType& element) const;
+    const_iterator upperBound(const ElementType& element) const;
+
+
+    // forEachWithPrefix() calls visit for each element that begins with
+    // the given prefix, in ascending order, stopping after limit of them,
+    // and returns how many were visited.  It finds the first one in
+    // O(log n) time and then walks forward, so visiting k elements takes
+    // O(log n + k) time.  The elements are expected to be string-like:
+    // anything with data() and size(), such as a std::string.
+    template <typename Visitor>
+    unsigned int forEachWithPrefix(
+        const ElementType& prefix, Visitor visit,
+        unsigned int limit = std::numeric_limits<unsigned int>::max()) const;
+
+
+    // rank() returns the number of elements in the set that are less than
+    // the given one, which, for an element in the set, is its position in
+    // ascending order (counting from 0).  select() goes the other way,
+    // returning an iterator to the element at the given position, or end()
+    // if the position isn't less than size().  Each node keeps track of
+    // how many nodes are in its subtree, so both of these run in O(log n)
+    // time when the tree is balanced.
+    unsigned int rank(const ElementType& element) const;
+    const_iterator select(unsigned int position) const;
+
+
+    // unionWith(), intersect(), and difference() change the set into its
+    // union with another set, its intersection with it, or its difference
+    // from it (the elements of this set that aren't in the other).  Rather
+    // than adding or searching for the other set's elements one at a time,
+    // they split this tree around the other's elements and join the pieces
+    // back together, which takes O(m log(n/m + 1)) time when the other set
+    // has m elements and this one has n >= m.  Separate pieces are worked on
+    // in parallel when they're big enough to be worth it.  Both sets must
+    // be balanced, or a SetException is thrown.
+    //
+    // unionWith() copies the other set's nodes before it changes anything,
+    // so if copying fails, the set is left unchanged.  The nodes of
+    // elements that are dropped (the set's own copy of an element that's
+    // in both, for unionWith(), or the elements that intersect() and
+    // difference() remove) stay in the set's NodePool for a while, but
+    // once they outnumber the elements that are left, the elements that
+    // are left are copied into a pool of their own and the old one is
+    // freed.  So the pool never holds much more than twice as many nodes
+    // as the set has elements, and the copying costs O(1) per node
+    // dropped, but iterators into the set don't survive these calls.
+    void unionWith(const AVLSet& s);
+    void intersect(const AVLSet& s);
+    void difference(const AVLSet& s);
+
+
+    // join() moves every element of another set into this one, leaving
+    // the other set empty.  Every element of the other set must be greater
+    // than every element of this one; if not, or if either set isn't
+    // balanced, a SetException is thrown and neither set is changed.  The
+    // other set's nodes are taken over as they are, so this runs in
+    // O(log n) time (plus time proportional to the number of blocks in the
+    // other set's NodePool) and allocates nothing.
+    void join(AVLSet&& s);
+
+
 private:
     // You'll no doubt want to add member variables and "helper" member
     // functions here.
@@ -110,15 +295,65 @@ private:
         ElementType value;
         AVLNode* LeftNode = nullptr;
         AVLNode* RightNode = nullptr;
+        AVLNode* ParentNode = nullptr;
+        // height of the subtree rooted here (0 for a leaf); only kept up
+        // to date when balancing
+        int height = 0;
+        // number of nodes in the subtree rooted here, including this one
+        unsigned int count = 1;
     };
+
+    // no balanced tree with fewer than 2^32 nodes is taller than 45, so
+    // this many links is always enough to remember the path from the root
+    // down to a new node
+    static constexpr unsigned int MAX_BALANCED_DEPTH = 64;
+
+    NodePool<AVLNode> nodes;
     int sz;
-    void copy_this_foo_recursively(const AVLNode* target, AVLNode* og);
-    void copy_this_dying_foo_recursively(AVLNode* target, AVLNode* og);
-    void delete_this_foo_entirely_recursively(AVLNode* node);
-    int find_this_foos_height(AVLNode* node) const;
-    void recurse_pre(VisitFunction visit, AVLNode* node) const;
-    void recurse_post(VisitFunction visit, AVLNode* node) const;
-    void recurse_in(VisitFunction visit, AVLNode* node) const;
+    bool should_balance;
+    // height of the tree when it's not being balanced, which is the
+    // depth of the deepest node added so far
+    int deepest_depth;
+    void clone_this_foo(const AVLSet& s);
+    void add_without_balancing(const ElementType& element);
+    void add_and_balance(const ElementType& element);
+    static int height_of(const AVLNode* node) noexcept;
+    static unsigned int count_of(const AVLNode* node) noexcept;
+    static void update_height_and_count(AVLNode* node) noexcept;
+    static AVLNode* rotate_this_foo_left(AVLNode* node) noexcept;
+    static AVLNode* rotate_this_foo_right(AVLNode* node) noexcept;
+    static AVLNode* rebalance_this_foo(AVLNode* node) noexcept;
+    static AVLNode* link_this_sorted_chain(AVLNode*& chain, unsigned int n) noexcept;
+
+    template <typename Iterator>
+    static void reserve_for_range(NodePool<AVLNode>& pool, Iterator first, Iterator last, std::forward_iterator_tag);
+    template <typename Iterator>
+    static void reserve_for_range(NodePool<AVLNode>& pool, Iterator first, Iterator last, std::input_iterator_tag);
+    // below this many elements, splitting and joining two trees isn't
+    // worth handing to another thread
+    static constexpr unsigned int PARALLEL_GRAIN = 16384;
+
+    void check_that_these_are_balanced(const AVLSet& s, const char* operation) const;
+    void take_this_root(AVLNode* root) noexcept;
+    void compact_this_foo() noexcept;
+    static unsigned int forks_for_this_machine() noexcept;
+    template <typename Left, typename Right>
+    static void fork_and_join(bool parallel, Left left, Right right);
+    static AVLNode* link_this_foo(AVLNode* left, AVLNode* middle, AVLNode* right) noexcept;
+    static AVLNode* join_this_foo(AVLNode* left, AVLNode* middle, AVLNode* right) noexcept;
+    static AVLNode* join_this_foo_right(AVLNode* left, AVLNode* middle, AVLNode* right) noexcept;
+    static AVLNode* join_this_foo_left(AVLNode* left, AVLNode* middle, AVLNode* right) noexcept;
+    static AVLNode* join_these_two(AVLNode* left, AVLNode* right) noexcept;
+    static AVLNode* split_off_the_last(AVLNode* tree, AVLNode*& last) noexcept;
+    static AVLNode* split_this_foo(AVLNode* tree, const ElementType& element, AVLNode*& less, AVLNode*& greater);
+    static AVLNode* union_of(AVLNode* ours, AVLNode* theirs, unsigned int forks);
+    static AVLNode* intersection_of(AVLNode* ours, const AVLNode* theirs, unsigned int forks);
+    static AVLNode* difference_of(AVLNode* ours, const AVLNode* theirs, unsigned int forks);
+    static const AVLNode* leftmost_of_this_foo(const AVLNode* node) noexcept;
+    static const AVLNode* rightmost_of_this_foo(const AVLNode* node) noexcept;
+    static const AVLNode* first_postorder_of_this_foo(const AVLNode* node) noexcept;
+    static const AVLNode* next_inorder(const AVLNode* node) noexcept;
+    static const AVLNode* previous_inorder(const AVLNode* node) noexcept;
     AVLNode* head_ptr;
 
 
@@ -127,151 +362,236 @@ private:
 
 template <typename ElementType>
 AVLSet<ElementType>::AVLSet(bool shouldBalance)
-    :sz{0}, head_ptr{nullptr}
+    :sz{0}, should_balance{shouldBalance}, deepest_depth{-1}, head_ptr{nullptr}
 {
     // make size 0
     // make head pointer null
 }
 
 template <typename ElementType>
-void AVLSet<ElementType>::delete_this_foo_entirely_recursively(AVLNode* node)
+AVLSet<ElementType>::~AVLSet() noexcept
 {
-    // base case
-    if (node != nullptr && node->RightNode == nullptr && node->LeftNode == nullptr)
-    {
-        // empty node deletion
-        delete node;
-    }
-    // recursion case left
-    else if (node->LeftNode != nullptr)
-    {
-        // left node recursion
-        delete_this_foo_entirely_recursively(node->LeftNode);
-    }
-    //recursion case right
-    else if (node->RightNode != nullptr)
-    {
-        // right node recursion
-        delete_this_foo_entirely_recursively(node->RightNode);
-    }
+    // the pool frees every node
 }
 
+
 template <typename ElementType>
-AVLSet<ElementType>::~AVLSet() noexcept
+void AVLSet<ElementType>::clone_this_foo(const AVLSet& s)
 {
-    if (head_ptr != nullptr)
-    {
-        // only delete if head isnt null
-        delete_this_foo_entirely_recursively(head_ptr);
-    }
-    else
+    // expects this set to be empty
+    if (s.head_ptr == nullptr)
     {
-        // else just delete the head pointer
-        delete head_ptr;
+        return;
     }
-}
 
+    // one block for every node, filled in preorder
+    nodes.reserve(s.sz);
 
-template <typename ElementType>
-void AVLSet<ElementType>::copy_this_foo_recursively(const AVLNode* target, AVLNode* og)
-{
-    while (target != nullptr)
+    // walk the original in preorder (the same way preorder() does), with
+    // "to" following along in the copy: each step down makes the matching
+    // child in the copy, and each step up follows the copy's parent
+    const AVLNode* from = s.head_ptr;
+    AVLNode* to = nodes.make(from->value, nullptr, nullptr, nullptr, from->height, from->count);
+    head_ptr = to;
+
+    for (;;)
     {
-        // og is the new node
-        og = new AVLNode;
-        og->value = target->value;
-        if (target->LeftNode != nullptr)
+        if (from->LeftNode != nullptr)
+        {
+            from = from->LeftNode;
+            to->LeftNode = nodes.make(from->value, nullptr, nullptr, to, from->height, from->count);
+            to = to->LeftNode;
+        }
+        else if (from->RightNode != nullptr)
         {
-            // recursive call to left
-            copy_this_foo_recursively(target->LeftNode, og->LeftNode);
+            from = from->RightNode;
+            to->RightNode = nodes.make(from->value, nullptr, nullptr, to, from->height, from->count);
+            to = to->RightNode;
         }
-        else if (target->RightNode != nullptr)
+        else
         {
-            // recursive call to right
-            copy_this_foo_recursively(target->RightNode, og->RightNode);
+            while (from->ParentNode != nullptr
+                   && (from == from->ParentNode->RightNode || from->ParentNode->RightNode == nullptr))
+            {
+                from = from->ParentNode;
+                to = to->ParentNode;
+            }
+
+            if (from->ParentNode == nullptr)
+            {
+                break;
+            }
+
+            from = from->ParentNode->RightNode;
+            to = to->ParentNode;
+            to->RightNode = nodes.make(from->value, nullptr, nullptr, to, from->height, from->count);
+            to = to->RightNode;
         }
     }
 }
 
+
 template <typename ElementType>
 AVLSet<ElementType>::AVLSet(const AVLSet& s)
+    : sz{s.sz}, should_balance{s.should_balance}, deepest_depth{s.deepest_depth}, head_ptr{nullptr}
 {
-    // set to null // will reassign in copy
-    sz = s.sz;
-    head_ptr = nullptr;
-    // use copy recursion
-    copy_this_foo_recursively(s.head_ptr, head_ptr);
-    
+    // if this throws, the pool frees whatever was copied so far
+    clone_this_foo(s);
 }
 
+
 template <typename ElementType>
-void AVLSet<ElementType>::copy_this_dying_foo_recursively(AVLNode* target, AVLNode* og)
+AVLSet<ElementType>::AVLSet(AVLSet&& s) noexcept
+    : nodes{std::move(s.nodes)}, sz{s.sz}, should_balance{s.should_balance},
+    deepest_depth{s.deepest_depth}, head_ptr{s.head_ptr}
+{
+    // the expiring set keeps nothing
+    s.sz = 0;
+    s.deepest_depth = -1;
+    s.head_ptr = nullptr;
+}
+
+
+template <typename ElementType>
+AVLSet<ElementType>& AVLSet<ElementType>::operator=(const AVLSet& s)
 {
-    while (target != nullptr)
-    {
-        // og is new node
-        og = new AVLNode;
-        og->value = std::move(target->value);
-        if (target->LeftNode != nullptr)
-        {
-            //recursive call to left
-            copy_this_foo_recursively(target->LeftNode, og->LeftNode);
-        }
-        else if (target->RightNode != nullptr)
-        {
-            // recursive call to right
-            copy_this_foo_recursively(target->RightNode, og->RightNode);
-        }
 
+    if (this != &s)
+    {
+        // copy first, so nothing changes if copying fails, then trade
+        // with the copy; our old nodes are destroyed along with it
+        AVLSet copy{s};
+        swap(copy);
     }
 
+    return *this;
 }
 
 
 template <typename ElementType>
-AVLSet<ElementType>::AVLSet(AVLSet&& s) noexcept
+AVLSet<ElementType>& AVLSet<ElementType>::operator=(AVLSet&& s) noexcept
 {
-    sz = s.sz;
-    head_ptr = nullptr;
-    copy_this_dying_foo_recursively(s.head_ptr, head_ptr);
+    if (this != &s)
+    {
+        // steal the expiring set's nodes into a temporary, then trade
+        // with it; our old nodes are destroyed along with it
+        AVLSet stolen{std::move(s)};
+        swap(stolen);
+    }
 
+    return *this;
 }
 
 
 template <typename ElementType>
-AVLSet<ElementType>& AVLSet<ElementType>::operator=(const AVLSet& s)
+void AVLSet<ElementType>::swap(AVLSet& s) noexcept
 {
+    nodes.swap(s.nodes);
+    std::swap(sz, s.sz);
+    std::swap(should_balance, s.should_balance);
+    std::swap(deepest_depth, s.deepest_depth);
+    std::swap(head_ptr, s.head_ptr);
+}
 
-    if (head_ptr != nullptr)
+
+template <typename ElementType>
+template <typename Iterator>
+void AVLSet<ElementType>::assignSorted(Iterator first, Iterator last, bool verifySorted)
+{
+    // the new nodes come from a pool of their own, so that nothing about
+    // this set changes until they've all been made successfully
+    NodePool<AVLNode> new_nodes;
+    reserve_for_range(new_nodes, first, last, typename std::iterator_traits<Iterator>::iterator_category{});
+
+    // first, make the nodes in ascending order, chaining them together
+    // through their RightNode pointers for the time being
+    AVLNode* chain = nullptr;
+    AVLNode** chain_end = &chain;
+    const AVLNode* previous = nullptr;
+    unsigned int count = 0;
+
+    for (; first != last; ++first)
     {
-        // delete content of original
-        delete_this_foo_entirely_recursively(head_ptr);
+        if (verifySorted && previous != nullptr)
+        {
+            if (*first < previous->value)
+            {
+                throw SetException{"assignSorted() was given elements that aren't in ascending order"};
+            }
+            else if (!(*first > previous->value))
+            {
+                // a repeat
+                continue;
+            }
+        }
+
+        AVLNode* node = new_nodes.make(*first);
+        *chain_end = node;
+        chain_end = &node->RightNode;
+        previous = node;
+        count++;
     }
-    // make head null
-    head_ptr = nullptr;
 
-    //copy
-    copy_this_foo_recursively(s.head_ptr, head_ptr);
+    // then link them into a tree, taking them off the chain in order
+    AVLNode* root = link_this_sorted_chain(chain, count);
 
-    return *this;
+    // our old nodes go away along with new_nodes
+    nodes.swap(new_nodes);
+    head_ptr = root;
+    sz = count;
+    deepest_depth = height_of(root);
 }
 
 
 template <typename ElementType>
-AVLSet<ElementType>& AVLSet<ElementType>::operator=(AVLSet&& s) noexcept
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::link_this_sorted_chain(
+    AVLNode*& chain, unsigned int n) noexcept
 {
-    if (head_ptr != nullptr)
+    // builds a tree out of the first n nodes on the chain, removing them
+    // from it; the middle node becomes the root, so the two subtrees'
+    // sizes (and therefore heights) differ by at most one
+    if (n == 0)
     {
-        // delete content of original
-        delete_this_foo_entirely_recursively(head_ptr);
+        return nullptr;
     }
-    // make head null
-    head_ptr = nullptr;
 
-    // copy dying
-    copy_this_dying_foo_recursively(s.head_ptr, head_ptr);
+    AVLNode* left = link_this_sorted_chain(chain, n / 2);
 
-    return *this;
+    AVLNode* root = chain;
+    chain = chain->RightNode;
+
+    root->LeftNode = left;
+    root->RightNode = link_this_sorted_chain(chain, n - n / 2 - 1);
+    root->ParentNode = nullptr;
+    if (root->LeftNode != nullptr)
+    {
+        root->LeftNode->ParentNode = root;
+    }
+    if (root->RightNode != nullptr)
+    {
+        root->RightNode->ParentNode = root;
+    }
+    update_height_and_count(root);
+    return root;
+}
+
+
+template <typename ElementType>
+template <typename Iterator>
+void AVLSet<ElementType>::reserve_for_range(
+    NodePool<AVLNode>& pool, Iterator first, Iterator last, std::forward_iterator_tag)
+{
+    pool.reserve(static_cast<unsigned int>(std::distance(first, last)));
+}
+
+
+template <typename ElementType>
+template <typename Iterator>
+void AVLSet<ElementType>::reserve_for_range(
+    NodePool<AVLNode>&, Iterator, Iterator, std::input_iterator_tag)
+{
+    // a single-pass range can't be measured without consuming it, so
+    // the pool just grows as usual
 }
 
 
@@ -285,48 +605,210 @@ bool AVLSet<ElementType>::isImplemented() const noexcept
 template <typename ElementType>
 void AVLSet<ElementType>::add(const ElementType& element)
 {
-    AVLNode* traversing_node = head_ptr;
-    AVLNode* traversing_omnidirection = head_ptr;
-    if (traversing_node == nullptr)
+    if (should_balance)
     {
-        // if head is null already, make new node w/ element
-        head_ptr = new AVLNode{element};
-        // increase size
-        sz++;
+        add_and_balance(element);
     }
     else
     {
-        while (traversing_omnidirection != nullptr)
+        add_without_balancing(element);
+    }
+}
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::add_without_balancing(const ElementType& element)
+{
+    // walk down to the null link where the element belongs, counting how
+    // deep it is
+    AVLNode** link = &head_ptr;
+    AVLNode* parent = nullptr;
+    int depth = 0;
+    while (*link != nullptr)
+    {
+        parent = *link;
+        if (element < (*link)->value)
         {
-            if (element < traversing_omnidirection->value)
-            {
-                // if less than, go to left node
-                traversing_node = traversing_omnidirection;
-                traversing_omnidirection = traversing_omnidirection->LeftNode;
-            }
-            else if (element > traversing_omnidirection->value)
-            {
-                // if greater than, go to right node
-                traversing_node = traversing_omnidirection;
-                traversing_omnidirection = traversing_omnidirection->RightNode;
-            }
+            // if less than, go to left node
+            link = &(*link)->LeftNode;
+        }
+        else if (element > (*link)->value)
+        {
+            // if greater than, go to right node
+            link = &(*link)->RightNode;
+        }
+        else
+        {
+            // already there
+            return;
+        }
+        depth++;
+    }
+
+    *link = nodes.make(element, nullptr, nullptr, parent);
+    sz++;
+
+    // every node above the new one has one more node beneath it
+    for (AVLNode* above = parent; above != nullptr; above = above->ParentNode)
+    {
+        above->count++;
+    }
+
+    if (depth > deepest_depth)
+    {
+        deepest_depth = depth;
+    }
+}
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::add_and_balance(const ElementType& element)
+{
+    // remember every link followed on the way down, so the way back up
+    // knows which link to point at whatever a rotation leaves on top,
+    // without recursion
+    AVLNode** path[MAX_BALANCED_DEPTH];
+    unsigned int depth = 0;
+
+    AVLNode** link = &head_ptr;
+    AVLNode* parent = nullptr;
+    while (*link != nullptr)
+    {
+        path[depth++] = link;
+        parent = *link;
+        if (element < (*link)->value)
+        {
+            link = &(*link)->LeftNode;
+        }
+        else if (element > (*link)->value)
+        {
+            link = &(*link)->RightNode;
+        }
+        else
+        {
+            // already there
+            return;
+        }
+    }
+
+    *link = nodes.make(element, nullptr, nullptr, parent);
+    sz++;
+
+    // every node on the path has one more node beneath it (which has to
+    // be done all the way up, even where the heights stop changing)
+    for (unsigned int i = 0; i < depth; ++i)
+    {
+        (*path[i])->count++;
+    }
+
+    // back up toward the root; once a subtree comes out the same height
+    // it was before, nothing above it can have changed
+    while (depth > 0)
+    {
+        AVLNode** parent_link = path[--depth];
+        int old_height = (*parent_link)->height;
+
+        *parent_link = rebalance_this_foo(*parent_link);
+
+        if ((*parent_link)->height == old_height)
+        {
+            break;
         }
-        // new node
-        AVLNode* add_this_foo = new AVLNode{element};
-        if (element < traversing_node->value)
+    }
+}
+
+
+template <typename ElementType>
+int AVLSet<ElementType>::height_of(const AVLNode* node) noexcept
+{
+    return node == nullptr ? -1 : node->height;
+}
+
+
+template <typename ElementType>
+unsigned int AVLSet<ElementType>::count_of(const AVLNode* node) noexcept
+{
+    return node == nullptr ? 0 : node->count;
+}
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::update_height_and_count(AVLNode* node) noexcept
+{
+    int left = height_of(node->LeftNode);
+    int right = height_of(node->RightNode);
+    node->height = (left > right ? left : right) + 1;
+    node->count = count_of(node->LeftNode) + count_of(node->RightNode) + 1;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::rotate_this_foo_left(AVLNode* node) noexcept
+{
+    // the right child moves up to take node's place, node becomes its
+    // left child, and the right child's old left subtree moves over to
+    // become node's right subtree
+    AVLNode* right = node->RightNode;
+    node->RightNode = right->LeftNode;
+    if (node->RightNode != nullptr)
+    {
+        node->RightNode->ParentNode = node;
+    }
+    right->LeftNode = node;
+    right->ParentNode = node->ParentNode;
+    node->ParentNode = right;
+    update_height_and_count(node);
+    update_height_and_count(right);
+    return right;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::rotate_this_foo_right(AVLNode* node) noexcept
+{
+    // the mirror image of rotate_this_foo_left()
+    AVLNode* left = node->LeftNode;
+    node->LeftNode = left->RightNode;
+    if (node->LeftNode != nullptr)
+    {
+        node->LeftNode->ParentNode = node;
+    }
+    left->RightNode = node;
+    left->ParentNode = node->ParentNode;
+    node->ParentNode = left;
+    update_height_and_count(node);
+    update_height_and_count(left);
+    return left;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::rebalance_this_foo(AVLNode* node) noexcept
+{
+    // returns whichever node ends up at the top of this subtree
+    update_height_and_count(node);
+    int balance = height_of(node->LeftNode) - height_of(node->RightNode);
+
+    if (balance > 1)
+    {
+        // LR case becomes an LL case first
+        if (height_of(node->LeftNode->LeftNode) < height_of(node->LeftNode->RightNode))
         {
-            // if less than, make left node the new node
-            traversing_node->LeftNode = add_this_foo;
-            sz++;
+            node->LeftNode = rotate_this_foo_left(node->LeftNode);
         }
-        else if (element > traversing_node->value)
+        return rotate_this_foo_right(node);
+    }
+    else if (balance < -1)
+    {
+        // RL case becomes an RR case first
+        if (height_of(node->RightNode->RightNode) < height_of(node->RightNode->LeftNode))
         {
-            // if greater than, make the right node the new node
-            traversing_node->RightNode = add_this_foo;
-            sz++;
+            node->RightNode = rotate_this_foo_right(node->RightNode);
         }
+        return rotate_this_foo_left(node);
     }
 
+    return node;
 }
 
 
@@ -371,126 +853,898 @@ unsigned int AVLSet<ElementType>::size() const noexcept
     return sz;
 }
 
+
+template <typename ElementType>
+void AVLSet<ElementType>::clear() noexcept
+{
+    nodes.clear();
+    head_ptr = nullptr;
+    sz = 0;
+    deepest_depth = -1;
+}
+
+template <typename ElementType>
+int AVLSet<ElementType>::height() const noexcept
+{
+    // an empty tree has a height of -1 either way
+    return should_balance ? height_of(head_ptr) : deepest_depth;
+}
+
+
+template <typename ElementType>
+unsigned int AVLSet<ElementType>::nodeBlockCount() const noexcept
+{
+    return nodes.blockCount();
+}
+
 template <typename ElementType>
-int AVLSet<ElementType>::find_this_foos_height(AVLNode* node) const
+const typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::leftmost_of_this_foo(const AVLNode* node) noexcept
 {
-    // null works
-    if (node == nullptr)
+    while (node->LeftNode != nullptr)
     {
-        return -1;
+        node = node->LeftNode;
     }
-    // everything else is 1 more than it should be when balanced
-    else
+    return node;
+}
+
+
+template <typename ElementType>
+const typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::rightmost_of_this_foo(const AVLNode* node) noexcept
+{
+    while (node->RightNode != nullptr)
+    {
+        node = node->RightNode;
+    }
+    return node;
+}
+
+
+template <typename ElementType>
+const typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::first_postorder_of_this_foo(
+    const AVLNode* node) noexcept
+{
+    // keep going down, to the left when possible, until there's a leaf
+    for (;;)
     {
-        int leftyLucy = find_this_foos_height(node->LeftNode);
-        int righyThaiTea = find_this_foos_height(node->RightNode);
-        if (leftyLucy > righyThaiTea)
+        if (node->LeftNode != nullptr)
+        {
+            node = node->LeftNode;
+        }
+        else if (node->RightNode != nullptr)
         {
-            
-            return(leftyLucy+1);
+            node = node->RightNode;
         }
         else
         {
-            
-            return (righyThaiTea+1);
+            return node;
         }
     }
 }
 
+
 template <typename ElementType>
-int AVLSet<ElementType>::height() const
+const typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::next_inorder(const AVLNode* node) noexcept
 {
-    // if empty return -1
-    if (head_ptr == nullptr)
+    // the smallest thing in the right subtree, if there is one
+    if (node->RightNode != nullptr)
     {
-        return -1;
+        return leftmost_of_this_foo(node->RightNode);
     }
-    // recursion
-    else
+
+    // otherwise, the first ancestor whose left subtree we're in
+    const AVLNode* parent = node->ParentNode;
+    while (parent != nullptr && node == parent->RightNode)
     {
-        return find_this_foos_height(head_ptr);   
+        node = parent;
+        parent = parent->ParentNode;
     }
-    
+    return parent;
 }
 
+
 template <typename ElementType>
-void AVLSet<ElementType>::recurse_pre(VisitFunction visit, AVLNode* node) const
+const typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::previous_inorder(const AVLNode* node) noexcept
 {
-    // recursion for preorder
-    AVLNode* traversing_node = node;
-    if (traversing_node == nullptr)
+    // the mirror image of next_inorder()
+    if (node->LeftNode != nullptr)
     {
-
-        return;
+        return rightmost_of_this_foo(node->LeftNode);
     }
-    else
+
+    const AVLNode* parent = node->ParentNode;
+    while (parent != nullptr && node == parent->LeftNode)
     {
-        visit(traversing_node->value);
-        recurse_pre(visit, traversing_node->LeftNode);
-        recurse_pre(visit, traversing_node->RightNode);
+        node = parent;
+        parent = parent->ParentNode;
     }
+    return parent;
 }
 
+
 template <typename ElementType>
 void AVLSet<ElementType>::preorder(VisitFunction visit) const
 {
-    // use recursive function for preorder
-    recurse_pre(visit, head_ptr);
-
+    preorder<VisitFunction&>(visit);
 }
 
 
 template <typename ElementType>
-void AVLSet<ElementType>::recurse_in(VisitFunction visit, AVLNode* node) const
+template <typename Visitor>
+void AVLSet<ElementType>::preorder(Visitor visit) const
 {
-    //recursion for inorder
-    AVLNode* traversing_node = node;
-    if (traversing_node == nullptr)
+    const AVLNode* node = head_ptr;
+    while (node != nullptr)
     {
+        visit(node->value);
 
-        return;
-    }
-    else
-    {
-        recurse_in(visit, traversing_node->LeftNode);
-        visit(traversing_node->value);
-        recurse_in(visit, traversing_node->RightNode);
+        if (node->LeftNode != nullptr)
+        {
+            node = node->LeftNode;
+        }
+        else if (node->RightNode != nullptr)
+        {
+            node = node->RightNode;
+        }
+        else
+        {
+            // climb until we come up out of a left subtree whose parent
+            // has a right subtree we haven't been into yet
+            const AVLNode* parent = node->ParentNode;
+            while (parent != nullptr && (node == parent->RightNode || parent->RightNode == nullptr))
+            {
+                node = parent;
+                parent = parent->ParentNode;
+            }
+            node = parent == nullptr ? nullptr : parent->RightNode;
+        }
     }
 }
 
+
 template <typename ElementType>
 void AVLSet<ElementType>::inorder(VisitFunction visit) const
 {
-    //use recursive function for inorder
-    recurse_in(visit, head_ptr);
+    inorder<VisitFunction&>(visit);
 }
 
+
 template <typename ElementType>
-void AVLSet<ElementType>::recurse_post(VisitFunction visit, AVLNode* node) const
+template <typename Visitor>
+void AVLSet<ElementType>::inorder(Visitor visit) const
 {
-    // recursion for postorder
-    AVLNode* traversing_node = node;
-    if (traversing_node == nullptr)
+    if (head_ptr == nullptr)
+    {
+        return;
+    }
+
+    for (const AVLNode* node = leftmost_of_this_foo(head_ptr); node != nullptr; node = next_inorder(node))
     {
+        visit(node->value);
+    }
+}
+
 
+template <typename ElementType>
+void AVLSet<ElementType>::postorder(VisitFunction visit) const
+{
+    postorder<VisitFunction&>(visit);
+}
+
+
+template <typename ElementType>
+template <typename Visitor>
+void AVLSet<ElementType>::postorder(Visitor visit) const
+{
+    if (head_ptr == nullptr)
+    {
         return;
     }
+
+    const AVLNode* node = first_postorder_of_this_foo(head_ptr);
+    while (node != nullptr)
+    {
+        visit(node->value);
+
+        // after a left child comes its sibling's subtree, if it has one;
+        // otherwise (and after a right child), its parent
+        const AVLNode* parent = node->ParentNode;
+        if (parent != nullptr && node == parent->LeftNode && parent->RightNode != nullptr)
+        {
+            node = first_postorder_of_this_foo(parent->RightNode);
+        }
+        else
+        {
+            node = parent;
+        }
+    }
+}
+
+
+template <typename ElementType>
+AVLSet<ElementType>::const_iterator::const_iterator() noexcept
+    : set{nullptr}, node{nullptr}
+{
+}
+
+
+template <typename ElementType>
+AVLSet<ElementType>::const_iterator::const_iterator(const AVLSet* set, const AVLNode* node) noexcept
+    : set{set}, node{node}
+{
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator::reference
+AVLSet<ElementType>::const_iterator::operator*() const noexcept
+{
+    return node->value;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator::pointer
+AVLSet<ElementType>::const_iterator::operator->() const noexcept
+{
+    return &node->value;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator& AVLSet<ElementType>::const_iterator::operator++() noexcept
+{
+    node = next_inorder(node);
+    return *this;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator AVLSet<ElementType>::const_iterator::operator++(int) noexcept
+{
+    const_iterator old = *this;
+    ++*this;
+    return old;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator& AVLSet<ElementType>::const_iterator::operator--() noexcept
+{
+    // backing up from the end lands on the largest element
+    node = node == nullptr ? rightmost_of_this_foo(set->head_ptr) : previous_inorder(node);
+    return *this;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator AVLSet<ElementType>::const_iterator::operator--(int) noexcept
+{
+    const_iterator old = *this;
+    --*this;
+    return old;
+}
+
+
+template <typename ElementType>
+bool AVLSet<ElementType>::const_iterator::operator==(const const_iterator& other) const noexcept
+{
+    return node == other.node;
+}
+
+
+template <typename ElementType>
+bool AVLSet<ElementType>::const_iterator::operator!=(const const_iterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator AVLSet<ElementType>::begin() const noexcept
+{
+    return const_iterator{this, head_ptr == nullptr ? nullptr : leftmost_of_this_foo(head_ptr)};
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator AVLSet<ElementType>::end() const noexcept
+{
+    return const_iterator{this, nullptr};
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator AVLSet<ElementType>::lowerBound(const ElementType& element) const
+{
+    // the last node we went left from is the smallest one seen so far
+    // that isn't less than the element
+    const AVLNode* candidate = nullptr;
+    const AVLNode* node = head_ptr;
+    while (node != nullptr)
+    {
+        if (node->value < element)
+        {
+            node = node->RightNode;
+        }
+        else
+        {
+            candidate = node;
+            node = node->LeftNode;
+        }
+    }
+
+    return const_iterator{this, candidate};
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator AVLSet<ElementType>::upperBound(const ElementType& element) const
+{
+    const AVLNode* candidate = nullptr;
+    const AVLNode* node = head_ptr;
+    while (node != nullptr)
+    {
+        if (node->value > element)
+        {
+            candidate = node;
+            node = node->LeftNode;
+        }
+        else
+        {
+            node = node->RightNode;
+        }
+    }
+
+    return const_iterator{this, candidate};
+}
+
+
+template <typename ElementType>
+unsigned int AVLSet<ElementType>::rank(const ElementType& element) const
+{
+    // every time we go right, the node we left and its left subtree are
+    // all less than the element
+    unsigned int less = 0;
+    const AVLNode* node = head_ptr;
+    while (node != nullptr)
+    {
+        if (node->value < element)
+        {
+            less += count_of(node->LeftNode) + 1;
+            node = node->RightNode;
+        }
+        else
+        {
+            node = node->LeftNode;
+        }
+    }
+
+    return less;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::const_iterator AVLSet<ElementType>::select(unsigned int position) const
+{
+    const AVLNode* node = head_ptr;
+    while (node != nullptr)
+    {
+        unsigned int left = count_of(node->LeftNode);
+        if (position < left)
+        {
+            node = node->LeftNode;
+        }
+        else if (position == left)
+        {
+            break;
+        }
+        else
+        {
+            position -= left + 1;
+            node = node->RightNode;
+        }
+    }
+
+    return const_iterator{this, node};
+}
+
+
+template <typename ElementType>
+template <typename Visitor>
+unsigned int AVLSet<ElementType>::forEachWithPrefix(
+    const ElementType& prefix, Visitor visit, unsigned int limit) const
+{
+    // everything that begins with the prefix sorts at or after it, and
+    // they all come together, so the first element that doesn't begin
+    // with it is where they end
+    unsigned int visited = 0;
+    for (const_iterator i = lowerBound(prefix); i != end() && visited < limit; ++i)
+    {
+        if (i->size() < prefix.size()
+            || !std::equal(prefix.data(), prefix.data() + prefix.size(), i->data()))
+        {
+            break;
+        }
+
+        visit(*i);
+        visited++;
+    }
+
+    return visited;
+}
+
+
+template <typename ElementType>
+constexpr unsigned int AVLSet<ElementType>::PARALLEL_GRAIN;
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::unionWith(const AVLSet& s)
+{
+    check_that_these_are_balanced(s, "unionWith()");
+
+    if (this == &s)
+    {
+        return;
+    }
+
+    // the other set's nodes are copied into a pool of their own and then
+    // moved into ours, so that nothing can fail once the trees are being
+    // taken apart; their nodes take the place of ours wherever an
+    // element is in both
+    AVLSet copy{s};
+    nodes.splice(copy.nodes);
+    take_this_root(union_of(head_ptr, copy.head_ptr, forks_for_this_machine()));
+
+    copy.head_ptr = nullptr;
+    copy.sz = 0;
+
+    compact_this_foo();
+}
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::intersect(const AVLSet& s)
+{
+    check_that_these_are_balanced(s, "intersect()");
+
+    if (this != &s)
+    {
+        take_this_root(intersection_of(head_ptr, s.head_ptr, forks_for_this_machine()));
+        compact_this_foo();
+    }
+}
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::difference(const AVLSet& s)
+{
+    check_that_these_are_balanced(s, "difference()");
+
+    if (this == &s)
+    {
+        clear();
+    }
     else
     {
-        recurse_post(visit, traversing_node->LeftNode);
-        recurse_post(visit, traversing_node->RightNode);
-        visit(traversing_node->value);
+        take_this_root(difference_of(head_ptr, s.head_ptr, forks_for_this_machine()));
+        compact_this_foo();
     }
 }
 
+
 template <typename ElementType>
-void AVLSet<ElementType>::postorder(VisitFunction visit) const
+void AVLSet<ElementType>::join(AVLSet&& s)
 {
-    // use recursive function for postorder
-    recurse_post(visit, head_ptr);
+    check_that_these_are_balanced(s, "join()");
+
+    if (this == &s || s.head_ptr == nullptr)
+    {
+        return;
+    }
+
+    if (head_ptr != nullptr
+        && !(rightmost_of_this_foo(head_ptr)->value < leftmost_of_this_foo(s.head_ptr)->value))
+    {
+        throw SetException{"join() was given a set whose elements aren't all greater"};
+    }
+
+    nodes.splice(s.nodes);
+    take_this_root(join_these_two(head_ptr, s.head_ptr));
+
+    s.head_ptr = nullptr;
+    s.sz = 0;
+    s.deepest_depth = -1;
+}
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::check_that_these_are_balanced(const AVLSet& s, const char* operation) const
+{
+    // the algorithms rely on the heights that balancing keeps up to date,
+    // and on the trees being shallow enough to recurse through
+    if (!should_balance || !s.should_balance)
+    {
+        throw SetException{std::string{operation} + " requires both sets to be balanced"};
+    }
+}
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::take_this_root(AVLNode* root) noexcept
+{
+    head_ptr = root;
+    if (head_ptr != nullptr)
+    {
+        head_ptr->ParentNode = nullptr;
+    }
+
+    sz = static_cast<int>(count_of(head_ptr));
+    deepest_depth = height_of(head_ptr);
+}
+
+
+template <typename ElementType>
+void AVLSet<ElementType>::compact_this_foo() noexcept
+{
+    // the nodes that were dropped are still in the pool, unreachable from
+    // the tree; once there are more of them than there are elements, the
+    // elements are copied into a pool of their own (the copy constructor
+    // allocates one block for all of them) and the old pool goes away
+    // along with the copy.  join() never drops anything, and a pool that
+    // was never more than half garbage joined with another one isn't
+    // either, so it doesn't need to do this.
+    unsigned int live = static_cast<unsigned int>(sz);
+    if (nodes.size() <= 2 * live)
+    {
+        return;
+    }
+
+    if (live == 0)
+    {
+        clear();
+        return;
+    }
+
+    try
+    {
+        AVLSet compacted{*this};
+        swap(compacted);
+    }
+    catch (...)
+    {
+        // the set is still fine, just bigger than it needs to be; the
+        // next call will try again
+    }
+}
+
+
+template <typename ElementType>
+unsigned int AVLSet<ElementType>::forks_for_this_machine() noexcept
+{
+    // each level of forking doubles the number of threads working, so
+    // this many levels gives every core something to do
+    unsigned int cores = std::thread::hardware_concurrency();
+    unsigned int forks = 0;
+    while ((1u << forks) < cores)
+    {
+        forks++;
+    }
+
+    return forks;
+}
+
+
+template <typename ElementType>
+template <typename Left, typename Right>
+void AVLSet<ElementType>::fork_and_join(bool parallel, Left left, Right right)
+{
+    if (parallel)
+    {
+        std::future<void> forked;
+        try
+        {
+            forked = std::async(std::launch::async, left);
+        }
+        catch (const std::system_error&)
+        {
+            // no thread to be had, so it's all done on this one
+            parallel = false;
+        }
+
+        if (parallel)
+        {
+            // if right() throws, the future waits for left() to finish
+            // as it's destroyed
+            right();
+            forked.get();
+            return;
+        }
+    }
+
+    left();
+    right();
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::link_this_foo(
+    AVLNode* left, AVLNode* middle, AVLNode* right) noexcept
+{
+    middle->LeftNode = left;
+    middle->RightNode = right;
+    if (left != nullptr)
+    {
+        left->ParentNode = middle;
+    }
+    if (right != nullptr)
+    {
+        right->ParentNode = middle;
+    }
+
+    update_height_and_count(middle);
+    return middle;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::join_this_foo(
+    AVLNode* left, AVLNode* middle, AVLNode* right) noexcept
+{
+    // builds a balanced tree out of two balanced trees and a node whose
+    // element is between theirs, in time proportional to the difference
+    // in their heights: the shorter tree (with the middle node on top of
+    // it) is hung off the side of the taller one, at the first node down
+    // that's about as tall as it is, and the nodes above it are
+    // rebalanced on the way back up
+    if (height_of(left) > height_of(right) + 1)
+    {
+        return join_this_foo_right(left, middle, right);
+    }
+    else if (height_of(right) > height_of(left) + 1)
+    {
+        return join_this_foo_left(left, middle, right);
+    }
+    else
+    {
+        return link_this_foo(left, middle, right);
+    }
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::join_this_foo_right(
+    AVLNode* left, AVLNode* middle, AVLNode* right) noexcept
+{
+    // left is the taller tree, so we go down its right side
+    AVLNode* child = left->RightNode;
+    AVLNode* joined;
+
+    if (height_of(child) <= height_of(right) + 1)
+    {
+        joined = link_this_foo(child, middle, right);
+        if (height_of(joined) > height_of(left->LeftNode) + 1)
+        {
+            joined = rotate_this_foo_right(joined);
+        }
+    }
+    else
+    {
+        joined = join_this_foo_right(child, middle, right);
+    }
+
+    left->RightNode = joined;
+    joined->ParentNode = left;
+    update_height_and_count(left);
+
+    if (height_of(joined) > height_of(left->LeftNode) + 1)
+    {
+        return rotate_this_foo_left(left);
+    }
+
+    return left;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::join_this_foo_left(
+    AVLNode* left, AVLNode* middle, AVLNode* right) noexcept
+{
+    // the mirror image of join_this_foo_right()
+    AVLNode* child = right->LeftNode;
+    AVLNode* joined;
+
+    if (height_of(child) <= height_of(left) + 1)
+    {
+        joined = link_this_foo(left, middle, child);
+        if (height_of(joined) > height_of(right->RightNode) + 1)
+        {
+            joined = rotate_this_foo_left(joined);
+        }
+    }
+    else
+    {
+        joined = join_this_foo_left(left, middle, child);
+    }
+
+    right->LeftNode = joined;
+    joined->ParentNode = right;
+    update_height_and_count(right);
+
+    if (height_of(joined) > height_of(right->RightNode) + 1)
+    {
+        return rotate_this_foo_right(right);
+    }
+
+    return right;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::join_these_two(
+    AVLNode* left, AVLNode* right) noexcept
+{
+    // with no node to put between them, the largest node in the left
+    // tree is taken out and used as one
+    if (left == nullptr)
+    {
+        return right;
+    }
+
+    AVLNode* last;
+    AVLNode* rest = split_off_the_last(left, last);
+    return join_this_foo(rest, last, right);
 }
 
 
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::split_off_the_last(
+    AVLNode* tree, AVLNode*& last) noexcept
+{
+    if (tree->RightNode == nullptr)
+    {
+        last = tree;
+        return tree->LeftNode;
+    }
+
+    AVLNode* rest = split_off_the_last(tree->RightNode, last);
+    return join_this_foo(tree->LeftNode, tree, rest);
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::split_this_foo(
+    AVLNode* tree, const ElementType& element, AVLNode*& less, AVLNode*& greater)
+{
+    // takes the tree apart into a tree of the elements less than the given
+    // one and a tree of the elements greater than it, by following the
+    // path down to where the element is (or would be) and joining each
+    // node on it with whatever's on the other side of the path; returns
+    // the element's node, if it's there, which ends up in neither tree
+    if (tree == nullptr)
+    {
+        less = nullptr;
+        greater = nullptr;
+        return nullptr;
+    }
+
+    AVLNode* left = tree->LeftNode;
+    AVLNode* right = tree->RightNode;
+    AVLNode* found;
+    AVLNode* between;
+
+    if (element < tree->value)
+    {
+        found = split_this_foo(left, element, less, between);
+        greater = join_this_foo(between, tree, right);
+    }
+    else if (element > tree->value)
+    {
+        found = split_this_foo(right, element, between, greater);
+        less = join_this_foo(left, tree, between);
+    }
+    else
+    {
+        less = left;
+        greater = right;
+        found = tree;
+    }
+
+    return found;
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::union_of(
+    AVLNode* ours, AVLNode* theirs, unsigned int forks)
+{
+    // split our tree around their root, take the union of the two halves
+    // with their two subtrees, and join the results with their root in
+    // between
+    if (ours == nullptr)
+    {
+        return theirs;
+    }
+    else if (theirs == nullptr)
+    {
+        return ours;
+    }
+
+    AVLNode* their_left = theirs->LeftNode;
+    AVLNode* their_right = theirs->RightNode;
+    bool parallel = forks > 0 && count_of(ours) + count_of(theirs) >= PARALLEL_GRAIN;
+    unsigned int forks_below = forks > 0 ? forks - 1 : 0;
+
+    AVLNode* less;
+    AVLNode* greater;
+    split_this_foo(ours, theirs->value, less, greater);
+
+    AVLNode* left;
+    AVLNode* right;
+    fork_and_join(
+        parallel,
+        [&]() { left = union_of(less, their_left, forks_below); },
+        [&]() { right = union_of(greater, their_right, forks_below); });
+
+    return join_this_foo(left, theirs, right);
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::intersection_of(
+    AVLNode* ours, const AVLNode* theirs, unsigned int forks)
+{
+    // their tree is only looked at, never changed, so the nodes that are
+    // kept are always ours
+    if (ours == nullptr || theirs == nullptr)
+    {
+        return nullptr;
+    }
+
+    bool parallel = forks > 0 && count_of(ours) + count_of(theirs) >= PARALLEL_GRAIN;
+    unsigned int forks_below = forks > 0 ? forks - 1 : 0;
+
+    AVLNode* less;
+    AVLNode* greater;
+    AVLNode* found = split_this_foo(ours, theirs->value, less, greater);
+
+    AVLNode* left;
+    AVLNode* right;
+    fork_and_join(
+        parallel,
+        [&]() { left = intersection_of(less, theirs->LeftNode, forks_below); },
+        [&]() { right = intersection_of(greater, theirs->RightNode, forks_below); });
+
+    return found != nullptr ? join_this_foo(left, found, right) : join_these_two(left, right);
+}
+
+
+template <typename ElementType>
+typename AVLSet<ElementType>::AVLNode* AVLSet<ElementType>::difference_of(
+    AVLNode* ours, const AVLNode* theirs, unsigned int forks)
+{
+    if (ours == nullptr || theirs == nullptr)
+    {
+        return ours;
+    }
+
+    bool parallel = forks > 0 && count_of(ours) + count_of(theirs) >= PARALLEL_GRAIN;
+    unsigned int forks_below = forks > 0 ? forks - 1 : 0;
+
+    AVLNode* less;
+    AVLNode* greater;
+    split_this_foo(ours, theirs->value, less, greater);
+
+    AVLNode* left;
+    AVLNode* right;
+    fork_and_join(
+        parallel,
+        [&]() { left = difference_of(less, theirs->LeftNode, forks_below); },
+        [&]() { right = difference_of(greater, theirs->RightNode, forks_below); });
+
+    return join_these_two(left, right);
+}
+
 
 #endif // AVLSET_HPP
 
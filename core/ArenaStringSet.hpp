@@ -0,0 +1,146 @@
+// ArenaStringSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// An ArenaStringSet is a Set of strings that keeps the characters of its
+// strings in a StringArena, while an underlying Set of ArenaStrings (a
+// HashSet, AVLSet, or SkipListSet of ArenaString, say) does the actual
+// organizing.  Each element then costs the underlying set a 16-byte handle
+// instead of a 32-byte std::string (plus, for longer strings, a separately
+// allocated block of characters), and the characters of all of the
+// elements sit packed together in a few large chunks.
+//
+// Since it's a Set<std::string>, an ArenaStringSet can be handed to a
+// WordChecker like any of the others:
+//
+//     ArenaStringSet<HashSet<ArenaString>> words{hashArenaString};
+//     words.add("HELLO");
+//     WordChecker checker{words};
+//
+// Lookups compare the string being looked up directly against the
+// characters in the arena; nothing is copied or allocated to do it.
+
+#ifndef ARENASTRINGSET_HPP
+#define ARENASTRINGSET_HPP
+
+#include <string>
+#include <utility>
+#include "Set.hpp"
+#include "StringArena.hpp"
+
+
+
+template <typename UnderlyingSet>
+class ArenaStringSet : public Set<std::string>
+{
+public:
+    // Initializes an empty ArenaStringSet, passing the given arguments
+    // along to the underlying set's constructor.
+    template <typename... Args>
+    explicit ArenaStringSet(Args&&... args);
+
+    // The underlying set holds handles into the arena, so copying one
+    // without the other isn't meaningful; an ArenaStringSet can be moved,
+    // but not copied.
+    ArenaStringSet(ArenaStringSet&& s) = default;
+    ArenaStringSet(const ArenaStringSet&) = delete;
+    ArenaStringSet& operator=(const ArenaStringSet&) = delete;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds a string to the set, storing its characters in the arena
+    // if it isn't already in the set.
+    virtual void add(const std::string& element) override;
+
+
+    // contains() returns true if the given string is in the set, false
+    // otherwise.
+    virtual bool contains(const std::string& element) const override;
+
+
+    // size() returns the number of strings in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // underlying() returns the underlying set of ArenaStrings, for asking
+    // it the questions that only it can answer.
+    const UnderlyingSet& underlying() const noexcept;
+
+
+    // arena() returns the arena where the characters are stored.
+    const StringArena& arena() const noexcept;
+
+
+private:
+    // declared first, so the arena outlives the set holding handles to it
+    StringArena characters;
+    UnderlyingSet set;
+};
+
+
+
+template <typename UnderlyingSet>
+template <typename... Args>
+ArenaStringSet<UnderlyingSet>::ArenaStringSet(Args&&... args)
+    : set{std::forward<Args>(args)...}
+{
+}
+
+
+template <typename UnderlyingSet>
+bool ArenaStringSet<UnderlyingSet>::isImplemented() const noexcept
+{
+    return set.isImplemented();
+}
+
+
+template <typename UnderlyingSet>
+void ArenaStringSet<UnderlyingSet>::add(const std::string& element)
+{
+    // store first and take it back if it turns out to be a duplicate,
+    // which costs one lookup instead of two
+    ArenaString stored = characters.store(element);
+    unsigned int old_sz = set.size();
+
+    set.add(stored);
+
+    if (set.size() == old_sz)
+    {
+        characters.forgetLast(stored);
+    }
+}
+
+
+template <typename UnderlyingSet>
+bool ArenaStringSet<UnderlyingSet>::contains(const std::string& element) const
+{
+    return set.contains(ArenaString::viewOf(element));
+}
+
+
+template <typename UnderlyingSet>
+unsigned int ArenaStringSet<UnderlyingSet>::size() const noexcept
+{
+    return set.size();
+}
+
+
+template <typename UnderlyingSet>
+const UnderlyingSet& ArenaStringSet<UnderlyingSet>::underlying() const noexcept
+{
+    return set;
+}
+
+
+template <typename UnderlyingSet>
+const StringArena& ArenaStringSet<UnderlyingSet>::arena() const noexcept
+{
+    return characters;
+}
+
+
+
+#endif // ARENASTRINGSET_HPP
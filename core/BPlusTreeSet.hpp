@@ -0,0 +1,889 @@
+// BPlusTreeSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A BPlusTreeSet is an implementation of a Set that is a B+ tree: a
+// balanced search tree whose nodes each hold many elements side by side,
+// rather than one, so that a search touches a handful of nodes instead of
+// the twenty or so an AVL tree of a million elements does, and most of
+// its comparisons are against elements in the same few cache lines.
+//
+// * Every element is stored in a leaf.  A leaf holds up to LEAF_CAPACITY
+//   elements in ascending order, and links to the next leaf, so the
+//   elements can be iterated in order just by walking the leaves.
+// * An inner node holds up to INNER_CAPACITY keys and one more child than
+//   it has keys.  Key i is the smallest element in child i + 1's subtree,
+//   so a search goes to the child whose index is the number of keys not
+//   greater than the element being searched for.
+// * The capacities are chosen so that the part of a node a search scans
+//   is about NODE_BYTES long (four cache lines).
+//
+// For strings, comparing against a key means following a pointer to its
+// characters (at least for longer strings), so inner nodes also keep a
+// "slice" of each key: its first eight characters packed into an unsigned
+// long long, so that comparing slices gives the same answer as comparing
+// the strings whenever the slices differ.  A search through an inner node
+// scans its slices, which sit together in the node, and only looks at a
+// key itself when the key's slice is the same as the element's.
+//
+// New elements are added into a leaf, splitting it in two when it's full
+// and adding a key to its parent (which may split in turn).  When an
+// element goes at the very end of the set, the full node is left full and
+// the new one starts out with just the element, so adding elements in
+// ascending order (as from a sorted word list) leaves every node full
+// except along the right edge of the tree.  assignSorted() builds a tree
+// of that same shape directly, without searching for where each element
+// goes.
+//
+// The nodes come from NodePools, like AVLSet's, and every node holds full
+// arrays of elements, so ElementType must be default-constructible.
+
+#ifndef BPLUSTREESET_HPP
+#define BPLUSTREESET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "NodePool.hpp"
+#include "Set.hpp"
+#include "SetException.hpp"
+
+
+
+namespace impl_
+{
+    // BPlusTreeSet__Slicing<ElementType>::type is std::true_type when
+    // elements of that type have slices, in which case slice() returns one.
+    template <typename ElementType>
+    struct BPlusTreeSet__Slicing
+    {
+        using type = std::false_type;
+    };
+
+
+    template <>
+    struct BPlusTreeSet__Slicing<std::string>
+    {
+        using type = std::true_type;
+
+        // the first eight characters, the first one in the highest byte,
+        // with zeroes after the end of a shorter string; characters are
+        // compared as unsigned chars, the way std::string compares them
+        static unsigned long long slice(const std::string& s) noexcept
+        {
+            unsigned long long slice = 0;
+            std::size_t length = s.size() < 8 ? s.size() : 8;
+
+            for (std::size_t i = 0; i < length; ++i)
+            {
+                slice |= static_cast<unsigned long long>(static_cast<unsigned char>(s[i])) << (56 - 8 * i);
+            }
+
+            return slice;
+        }
+    };
+}
+
+
+
+template <typename ElementType>
+class BPlusTreeSet : public Set<ElementType>
+{
+private:
+    using Slicing = impl_::BPlusTreeSet__Slicing<ElementType>;
+    using HasSlices = typename Slicing::type;
+
+public:
+    // About how many bytes of each node a search scans.
+    static constexpr unsigned int NODE_BYTES = 256;
+
+    // The most elements a leaf holds, and the most keys an inner node
+    // holds.  An inner node whose keys have slices scans those instead of
+    // the keys, so it can hold as many keys as slices fit in NODE_BYTES.
+    static constexpr unsigned int LEAF_CAPACITY =
+        NODE_BYTES / sizeof(ElementType) < 4 ? 4 : NODE_BYTES / sizeof(ElementType);
+
+    static constexpr unsigned int INNER_CAPACITY =
+        HasSlices::value
+            ? NODE_BYTES / sizeof(unsigned long long)
+            : (NODE_BYTES / sizeof(ElementType) < 4 ? 4 : NODE_BYTES / sizeof(ElementType));
+
+public:
+    // Initializes a BPlusTreeSet to be empty.
+    BPlusTreeSet() noexcept;
+
+    // Cleans up the BPlusTreeSet so that it leaks no memory.
+    virtual ~BPlusTreeSet() noexcept;
+
+    // Initializes a new BPlusTreeSet to be a copy of an existing one.
+    // The copy is built the way assignSorted() builds a tree, so its nodes
+    // are full (and it may be shorter than the original).
+    BPlusTreeSet(const BPlusTreeSet& s);
+
+    // Initializes a new BPlusTreeSet whose contents are moved from an
+    // expiring one, in constant time, leaving the expiring one empty.
+    BPlusTreeSet(BPlusTreeSet&& s) noexcept;
+
+    // Assigns an existing BPlusTreeSet into another.  If copying fails
+    // partway through, the set is left unchanged.
+    BPlusTreeSet& operator=(const BPlusTreeSet& s);
+
+    // Assigns an expiring BPlusTreeSet into another, leaving the expiring
+    // one empty.
+    BPlusTreeSet& operator=(BPlusTreeSet&& s) noexcept;
+
+    // swap() exchanges the contents of two BPlusTreeSets in constant time.
+    void swap(BPlusTreeSet& s) noexcept;
+
+
+    // assignSorted() replaces the contents of the set with the elements in
+    // the range [first, last), which must be in ascending order.  The
+    // leaves are filled one after another and the inner nodes above them
+    // built along the way, in O(n) time, with every node full except the
+    // last one on each level.  If verifySorted is true, repeats are
+    // skipped, and an element that's smaller than the one before it causes
+    // a SetException to be thrown, leaving the set unchanged.  If
+    // verifySorted is false, the elements must be strictly ascending.
+    template <typename Iterator>
+    void assignSorted(Iterator first, Iterator last, bool verifySorted = true);
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  It runs in O(log n) time.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  It runs in O(log n) time, visiting one node on
+    // each level of the tree.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // clear() removes every element from the set.
+    void clear() noexcept;
+
+
+    // height() returns the number of levels of nodes in the tree, counting
+    // the leaves (so it's 0 for an empty set and 1 when there's one leaf).
+    unsigned int height() const noexcept;
+
+
+private:
+    struct Leaf;
+
+public:
+    // A const_iterator visits the elements of a BPlusTreeSet in ascending
+    // order, by walking along the leaves.  Adding to the set invalidates
+    // every iterator into it.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ElementType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ElementType*;
+        using reference = const ElementType&;
+
+        const_iterator() noexcept;
+
+        reference operator*() const noexcept;
+        pointer operator->() const noexcept;
+
+        const_iterator& operator++() noexcept;
+        const_iterator operator++(int) noexcept;
+
+        bool operator==(const const_iterator& other) const noexcept;
+        bool operator!=(const const_iterator& other) const noexcept;
+
+    private:
+        friend class BPlusTreeSet;
+        const_iterator(const Leaf* leaf, unsigned int index) noexcept;
+
+        const Leaf* leaf;
+        unsigned int index;
+    };
+
+    using iterator = const_iterator;
+
+
+    // begin() and end() allow a BPlusTreeSet to be iterated (e.g., by a
+    // range-based for loop) in ascending order.
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+
+
+private:
+    struct Inner;
+
+    // which of these a child is depends on how far above the leaves its
+    // parent is: the children of the inner nodes just above the leaves
+    // are leaves, and every other inner node's children are inner nodes
+    union Child
+    {
+        Inner* inner;
+        Leaf* leaf;
+    };
+
+    struct Leaf
+    {
+        unsigned int count;
+        Leaf* next;
+        ElementType elements[LEAF_CAPACITY];
+    };
+
+    struct Inner
+    {
+        unsigned int count;
+        // unused (and only one long) when the keys have no slices
+        unsigned long long slices[HasSlices::value ? INNER_CAPACITY : 1];
+        ElementType keys[INNER_CAPACITY];
+        Child children[INNER_CAPACITY + 1];
+    };
+
+    // every inner node but the root has at least two children, so no tree
+    // of fewer than 2^32 elements is anywhere near this tall
+    static constexpr unsigned int MAX_HEIGHT = 40;
+
+    NodePool<Leaf> leaves;
+    NodePool<Inner> inners;
+    Child root;
+    // the number of levels of inner nodes above the leaves
+    unsigned int inner_levels;
+    Leaf* first_leaf;
+    unsigned int sz;
+
+    void append_this_foo(const ElementType& element, Leaf*& last_leaf, Inner** spine);
+    void add_this_key_to_the_parents(
+        Inner** path, unsigned int* indexes, unsigned int level,
+        ElementType key, Child child, bool rightmost);
+    void grow_a_new_root(ElementType&& key, Child child);
+    static void split_this_foo(
+        Inner* node, unsigned int index, Inner* right, ElementType& key, Child& child, bool rightmost);
+
+    static unsigned int child_index(const Inner* node, const ElementType& element, std::true_type) noexcept;
+    static unsigned int child_index(const Inner* node, const ElementType& element, std::false_type);
+    static void set_key(Inner* node, unsigned int index, ElementType&& key);
+    static void move_key(Inner* from, unsigned int fromIndex, Inner* to, unsigned int toIndex);
+    static void set_slice(Inner* node, unsigned int index, std::true_type) noexcept;
+    static void set_slice(Inner* node, unsigned int index, std::false_type) noexcept;
+};
+
+
+
+template <typename ElementType>
+constexpr unsigned int BPlusTreeSet<ElementType>::NODE_BYTES;
+
+template <typename ElementType>
+constexpr unsigned int BPlusTreeSet<ElementType>::LEAF_CAPACITY;
+
+template <typename ElementType>
+constexpr unsigned int BPlusTreeSet<ElementType>::INNER_CAPACITY;
+
+template <typename ElementType>
+constexpr unsigned int BPlusTreeSet<ElementType>::MAX_HEIGHT;
+
+
+template <typename ElementType>
+BPlusTreeSet<ElementType>::BPlusTreeSet() noexcept
+    : root{nullptr}, inner_levels{0}, first_leaf{nullptr}, sz{0}
+{
+}
+
+
+template <typename ElementType>
+BPlusTreeSet<ElementType>::~BPlusTreeSet() noexcept
+{
+    // the pools free every node
+}
+
+
+template <typename ElementType>
+BPlusTreeSet<ElementType>::BPlusTreeSet(const BPlusTreeSet& s)
+    : BPlusTreeSet{}
+{
+    assignSorted(s.begin(), s.end(), false);
+}
+
+
+template <typename ElementType>
+BPlusTreeSet<ElementType>::BPlusTreeSet(BPlusTreeSet&& s) noexcept
+    : BPlusTreeSet{}
+{
+    swap(s);
+}
+
+
+template <typename ElementType>
+BPlusTreeSet<ElementType>& BPlusTreeSet<ElementType>::operator=(const BPlusTreeSet& s)
+{
+    if (this != &s)
+    {
+        BPlusTreeSet copy{s};
+        swap(copy);
+    }
+
+    return *this;
+}
+
+
+template <typename ElementType>
+BPlusTreeSet<ElementType>& BPlusTreeSet<ElementType>::operator=(BPlusTreeSet&& s) noexcept
+{
+    if (this != &s)
+    {
+        BPlusTreeSet stolen{std::move(s)};
+        swap(stolen);
+    }
+
+    return *this;
+}
+
+
+template <typename ElementType>
+void BPlusTreeSet<ElementType>::swap(BPlusTreeSet& s) noexcept
+{
+    leaves.swap(s.leaves);
+    inners.swap(s.inners);
+    std::swap(root, s.root);
+    std::swap(inner_levels, s.inner_levels);
+    std::swap(first_leaf, s.first_leaf);
+    std::swap(sz, s.sz);
+}
+
+
+template <typename ElementType>
+template <typename Iterator>
+void BPlusTreeSet<ElementType>::assignSorted(Iterator first, Iterator last, bool verifySorted)
+{
+    // the new tree is built off to the side, so that nothing about this
+    // set changes until it's finished
+    BPlusTreeSet fresh;
+
+    // the last node on each level, which is where the next key on that
+    // level goes
+    Inner* spine[MAX_HEIGHT + 1];
+    Leaf* last_leaf = nullptr;
+
+    for (; first != last; ++first)
+    {
+        if (verifySorted && last_leaf != nullptr)
+        {
+            const ElementType& previous = last_leaf->elements[last_leaf->count - 1];
+
+            if (*first < previous)
+            {
+                throw SetException{"assignSorted() was given elements that aren't in ascending order"};
+            }
+            else if (!(*first > previous))
+            {
+                // a repeat
+                continue;
+            }
+        }
+
+        fresh.append_this_foo(*first, last_leaf, spine);
+    }
+
+    swap(fresh);
+}
+
+
+template <typename ElementType>
+void BPlusTreeSet<ElementType>::append_this_foo(const ElementType& element, Leaf*& last_leaf, Inner** spine)
+{
+    if (last_leaf != nullptr && last_leaf->count < LEAF_CAPACITY)
+    {
+        last_leaf->elements[last_leaf->count] = element;
+        last_leaf->count++;
+        sz++;
+        return;
+    }
+
+    Leaf* leaf = leaves.make();
+    leaf->elements[0] = element;
+    leaf->count = 1;
+
+    if (last_leaf == nullptr)
+    {
+        root.leaf = leaf;
+        first_leaf = leaf;
+    }
+    else
+    {
+        last_leaf->next = leaf;
+
+        // the new leaf goes after the last child of the last node on the
+        // level above; if that's full, a new node with only the new child
+        // takes its place, and it goes after the last child on the level
+        // above that, and so on
+        ElementType key{element};
+        Child child;
+        child.leaf = leaf;
+
+        unsigned int level = 1;
+        while (level <= inner_levels && spine[level]->count == INNER_CAPACITY)
+        {
+            Inner* node = inners.make();
+            node->children[0] = child;
+            spine[level] = node;
+            child.inner = node;
+            level++;
+        }
+
+        if (level <= inner_levels)
+        {
+            Inner* node = spine[level];
+            set_key(node, node->count, std::move(key));
+            node->children[node->count + 1] = child;
+            node->count++;
+        }
+        else
+        {
+            grow_a_new_root(std::move(key), child);
+            spine[inner_levels] = root.inner;
+        }
+    }
+
+    last_leaf = leaf;
+    sz++;
+}
+
+
+template <typename ElementType>
+void BPlusTreeSet<ElementType>::grow_a_new_root(ElementType&& key, Child child)
+{
+    Inner* node = inners.make();
+    node->children[0] = root;
+    set_key(node, 0, std::move(key));
+    node->children[1] = child;
+    node->count = 1;
+
+    root.inner = node;
+    inner_levels++;
+}
+
+
+template <typename ElementType>
+bool BPlusTreeSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void BPlusTreeSet<ElementType>::add(const ElementType& element)
+{
+    if (first_leaf == nullptr)
+    {
+        Leaf* leaf = leaves.make();
+        root.leaf = leaf;
+        first_leaf = leaf;
+    }
+
+    // remember the way down, so that splits can be passed back up it
+    Inner* path[MAX_HEIGHT + 1];
+    unsigned int indexes[MAX_HEIGHT + 1];
+    bool rightmost = true;
+
+    Child node = root;
+    for (unsigned int level = inner_levels; level > 0; --level)
+    {
+        unsigned int index = child_index(node.inner, element, HasSlices{});
+        path[level] = node.inner;
+        indexes[level] = index;
+        rightmost = rightmost && index == node.inner->count;
+        node = node.inner->children[index];
+    }
+
+    Leaf* leaf = node.leaf;
+    ElementType* position = std::lower_bound(leaf->elements, leaf->elements + leaf->count, element);
+    if (position != leaf->elements + leaf->count && *position == element)
+    {
+        return;
+    }
+
+    unsigned int index = static_cast<unsigned int>(position - leaf->elements);
+    ElementType value{element};
+
+    if (leaf->count < LEAF_CAPACITY)
+    {
+        std::move_backward(leaf->elements + index, leaf->elements + leaf->count, leaf->elements + leaf->count + 1);
+        leaf->elements[index] = std::move(value);
+        leaf->count++;
+        sz++;
+        return;
+    }
+
+    // the leaf is full, so it's split in two, and so is every full node
+    // above it; all the nodes that takes are made up front, so that
+    // running out of memory can't leave the tree half split
+    unsigned int splits = 0;
+    while (splits < inner_levels && path[splits + 1]->count == INNER_CAPACITY)
+    {
+        splits++;
+    }
+
+    leaves.reserve(1);
+    inners.reserve(splits + 1);
+
+    // the leaf is usually split evenly, but when the new element goes at
+    // the end of the whole set, the full leaf is left as it is
+    Leaf* right = leaves.make();
+    bool appending = rightmost && index == LEAF_CAPACITY;
+    unsigned int keep = appending ? LEAF_CAPACITY : (LEAF_CAPACITY + 1) / 2;
+
+    std::move(leaf->elements + keep, leaf->elements + LEAF_CAPACITY, right->elements);
+    right->count = LEAF_CAPACITY - keep;
+    leaf->count = keep;
+
+    if (index <= keep && keep < LEAF_CAPACITY)
+    {
+        std::move_backward(leaf->elements + index, leaf->elements + leaf->count, leaf->elements + leaf->count + 1);
+        leaf->elements[index] = std::move(value);
+        leaf->count++;
+    }
+    else
+    {
+        index -= keep;
+        std::move_backward(right->elements + index, right->elements + right->count, right->elements + right->count + 1);
+        right->elements[index] = std::move(value);
+        right->count++;
+    }
+
+    right->next = leaf->next;
+    leaf->next = right;
+    sz++;
+
+    Child child;
+    child.leaf = right;
+    add_this_key_to_the_parents(path, indexes, 1, right->elements[0], child, rightmost);
+}
+
+
+template <typename ElementType>
+void BPlusTreeSet<ElementType>::add_this_key_to_the_parents(
+    Inner** path, unsigned int* indexes, unsigned int level,
+    ElementType key, Child child, bool rightmost)
+{
+    // the key and child go just after the child at indexes[level] in the
+    // node at path[level]; if that node is full, it's split, and the key
+    // and child that come out of the split go up a level
+    for (; level <= inner_levels; ++level)
+    {
+        Inner* node = path[level];
+        unsigned int index = indexes[level];
+
+        if (node->count < INNER_CAPACITY)
+        {
+            for (unsigned int i = node->count; i > index; --i)
+            {
+                move_key(node, i - 1, node, i);
+                node->children[i + 1] = node->children[i];
+            }
+
+            set_key(node, index, std::move(key));
+            node->children[index + 1] = child;
+            node->count++;
+            return;
+        }
+
+        Inner* right = inners.make();
+        split_this_foo(node, index, right, key, child, rightmost);
+    }
+
+    grow_a_new_root(std::move(key), child);
+}
+
+
+template <typename ElementType>
+void BPlusTreeSet<ElementType>::split_this_foo(
+    Inner* node, unsigned int index, Inner* right, ElementType& key, Child& child, bool rightmost)
+{
+    // Think of the node's keys with the new key inserted at index, which
+    // is one more than fits, and its children with the new child inserted
+    // at index + 1.  The first middle keys (and the children around them)
+    // stay in this node, the key after them goes up to the parent, and
+    // the rest go into the right node.  When this is the last node on its
+    // level and the new key goes at its end, this node stays full, and the
+    // new key goes up with the right node holding only the new child.
+    const unsigned int total = INNER_CAPACITY + 1;
+    unsigned int middle = rightmost && index == INNER_CAPACITY ? INNER_CAPACITY : total / 2;
+
+    // the right node's keys and children come from positions past the
+    // middle, which (whether they're old ones or the new ones) haven't
+    // been moved yet
+    for (unsigned int i = middle + 1; i < total; ++i)
+    {
+        if (i < index)
+        {
+            move_key(node, i, right, i - middle - 1);
+        }
+        else if (i == index)
+        {
+            set_key(right, i - middle - 1, std::move(key));
+        }
+        else
+        {
+            move_key(node, i - 1, right, i - middle - 1);
+        }
+    }
+
+    for (unsigned int i = middle + 1; i < total + 1; ++i)
+    {
+        if (i <= index)
+        {
+            right->children[i - middle - 1] = node->children[i];
+        }
+        else if (i == index + 1)
+        {
+            right->children[i - middle - 1] = child;
+        }
+        else
+        {
+            right->children[i - middle - 1] = node->children[i - 1];
+        }
+    }
+
+    right->count = total - middle - 1;
+
+    // the key at the middle goes up (if it's the new key, it's already
+    // where it needs to be)
+    ElementType up_key;
+    if (middle < index)
+    {
+        up_key = std::move(node->keys[middle]);
+    }
+    else if (middle > index)
+    {
+        up_key = std::move(node->keys[middle - 1]);
+    }
+    else
+    {
+        up_key = std::move(key);
+    }
+
+    // and if the new key and child belong in this node, make room for them
+    if (index < middle)
+    {
+        for (unsigned int i = middle - 1; i > index; --i)
+        {
+            move_key(node, i - 1, node, i);
+            node->children[i + 1] = node->children[i];
+        }
+
+        set_key(node, index, std::move(key));
+        node->children[index + 1] = child;
+    }
+
+    node->count = middle;
+
+    key = std::move(up_key);
+    child.inner = right;
+}
+
+
+template <typename ElementType>
+bool BPlusTreeSet<ElementType>::contains(const ElementType& element) const
+{
+    if (sz == 0)
+    {
+        return false;
+    }
+
+    Child node = root;
+    for (unsigned int level = inner_levels; level > 0; --level)
+    {
+        node = node.inner->children[child_index(node.inner, element, HasSlices{})];
+    }
+
+    const Leaf* leaf = node.leaf;
+    const ElementType* position = std::lower_bound(leaf->elements, leaf->elements + leaf->count, element);
+    return position != leaf->elements + leaf->count && *position == element;
+}
+
+
+template <typename ElementType>
+unsigned int BPlusTreeSet<ElementType>::child_index(
+    const Inner* node, const ElementType& element, std::true_type) noexcept
+{
+    // the slices are in ascending order, so counting the ones that are
+    // less than the element's slice needs no branches; only the keys
+    // whose slices are the same as the element's need to be looked at
+    unsigned long long slice = Slicing::slice(element);
+
+    unsigned int index = 0;
+    for (unsigned int i = 0; i < node->count; ++i)
+    {
+        index += node->slices[i] < slice;
+    }
+
+    while (index < node->count && node->slices[index] == slice && !(element < node->keys[index]))
+    {
+        index++;
+    }
+
+    return index;
+}
+
+
+template <typename ElementType>
+unsigned int BPlusTreeSet<ElementType>::child_index(
+    const Inner* node, const ElementType& element, std::false_type)
+{
+    return static_cast<unsigned int>(
+        std::upper_bound(node->keys, node->keys + node->count, element) - node->keys);
+}
+
+
+template <typename ElementType>
+void BPlusTreeSet<ElementType>::set_key(Inner* node, unsigned int index, ElementType&& key)
+{
+    node->keys[index] = std::move(key);
+    set_slice(node, index, HasSlices{});
+}
+
+
+template <typename ElementType>
+void BPlusTreeSet<ElementType>::move_key(Inner* from, unsigned int fromIndex, Inner* to, unsigned int toIndex)
+{
+    set_key(to, toIndex, std::move(from->keys[fromIndex]));
+}
+
+
+template <typename ElementType>
+void BPlusTreeSet<ElementType>::set_slice(Inner* node, unsigned int index, std::true_type) noexcept
+{
+    node->slices[index] = Slicing::slice(node->keys[index]);
+}
+
+
+template <typename ElementType>
+void BPlusTreeSet<ElementType>::set_slice(Inner*, unsigned int, std::false_type) noexcept
+{
+    // no slices to keep
+}
+
+
+template <typename ElementType>
+unsigned int BPlusTreeSet<ElementType>::size() const noexcept
+{
+    return sz;
+}
+
+
+template <typename ElementType>
+void BPlusTreeSet<ElementType>::clear() noexcept
+{
+    leaves.clear();
+    inners.clear();
+    root.leaf = nullptr;
+    inner_levels = 0;
+    first_leaf = nullptr;
+    sz = 0;
+}
+
+
+template <typename ElementType>
+unsigned int BPlusTreeSet<ElementType>::height() const noexcept
+{
+    return first_leaf == nullptr ? 0 : inner_levels + 1;
+}
+
+
+template <typename ElementType>
+typename BPlusTreeSet<ElementType>::const_iterator BPlusTreeSet<ElementType>::begin() const noexcept
+{
+    // the only leaf that's ever empty is the root of an empty set
+    return sz == 0 ? end() : const_iterator{first_leaf, 0};
+}
+
+
+template <typename ElementType>
+typename BPlusTreeSet<ElementType>::const_iterator BPlusTreeSet<ElementType>::end() const noexcept
+{
+    return const_iterator{nullptr, 0};
+}
+
+
+template <typename ElementType>
+BPlusTreeSet<ElementType>::const_iterator::const_iterator() noexcept
+    : leaf{nullptr}, index{0}
+{
+}
+
+
+template <typename ElementType>
+BPlusTreeSet<ElementType>::const_iterator::const_iterator(const Leaf* leaf, unsigned int index) noexcept
+    : leaf{leaf}, index{index}
+{
+}
+
+
+template <typename ElementType>
+typename BPlusTreeSet<ElementType>::const_iterator::reference
+BPlusTreeSet<ElementType>::const_iterator::operator*() const noexcept
+{
+    return leaf->elements[index];
+}
+
+
+template <typename ElementType>
+typename BPlusTreeSet<ElementType>::const_iterator::pointer
+BPlusTreeSet<ElementType>::const_iterator::operator->() const noexcept
+{
+    return &leaf->elements[index];
+}
+
+
+template <typename ElementType>
+typename BPlusTreeSet<ElementType>::const_iterator&
+BPlusTreeSet<ElementType>::const_iterator::operator++() noexcept
+{
+    index++;
+    if (index == leaf->count)
+    {
+        leaf = leaf->next;
+        index = 0;
+    }
+
+    return *this;
+}
+
+
+template <typename ElementType>
+typename BPlusTreeSet<ElementType>::const_iterator
+BPlusTreeSet<ElementType>::const_iterator::operator++(int) noexcept
+{
+    const_iterator old{*this};
+    ++*this;
+    return old;
+}
+
+
+template <typename ElementType>
+bool BPlusTreeSet<ElementType>::const_iterator::operator==(const const_iterator& other) const noexcept
+{
+    return leaf == other.leaf && index == other.index;
+}
+
+
+template <typename ElementType>
+bool BPlusTreeSet<ElementType>::const_iterator::operator!=(const const_iterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+
+
+#endif // BPLUSTREESET_HPP
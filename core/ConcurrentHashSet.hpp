@@ -0,0 +1,311 @@
+// ConcurrentHashSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A ConcurrentHashSet is a separately-chained hash table, like HashSet,
+// that can be used by many threads at once: any number of threads can call
+// contains() while others call add(), with no external locking.
+//
+// * contains() never blocks and never retries.  It announces itself in an
+//   EpochDomain, loads the current array, and walks one linked list whose
+//   links are atomic pointers.  Elements are only ever added at the front
+//   of a list, so a reader walks a list that can't change underneath it.
+// * add() locks one of a fixed number of "stripes."  Every index belongs
+//   to exactly one stripe (the capacity is always a multiple of the number
+//   of stripes, so an element's stripe doesn't change when the array is
+//   resized), so adds that land in different stripes proceed in parallel.
+// * Resizing locks every stripe, builds a new array with its own copies
+//   of the nodes, and publishes it with a single atomic store.  Readers
+//   that loaded the old array keep walking it undisturbed; it's deleted
+//   once the EpochDomain says none of them can still be looking at it.
+
+#ifndef CONCURRENTHASHSET_HPP
+#define CONCURRENTHASHSET_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "EpochDomain.hpp"
+#include "Set.hpp"
+
+
+
+template <typename ElementType>
+class ConcurrentHashSet : public Set<ElementType>
+{
+public:
+    // The default capacity of the ConcurrentHashSet before anything has
+    // been added to it.
+    static constexpr unsigned int DEFAULT_CAPACITY = 16;
+
+    // The number of locks that adds are spread across.  The capacity is
+    // always a multiple of this.
+    static constexpr unsigned int STRIPES = 16;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns an unsigned int.  It will be called from
+    // many threads at once, so it mustn't modify any shared state.
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+    // Initializes a ConcurrentHashSet to be empty, so that it will use the
+    // given hash function whenever it needs to hash an element.
+    explicit ConcurrentHashSet(HashFunction hashFunction);
+
+    // Cleans up the ConcurrentHashSet so that it leaks no memory.  No
+    // other thread may be using it at the time.
+    virtual ~ConcurrentHashSet() noexcept;
+
+    // A ConcurrentHashSet is shared by reference among the threads that
+    // use it, so it can't be copied or moved.
+    ConcurrentHashSet(const ConcurrentHashSet& s) = delete;
+    ConcurrentHashSet& operator=(const ConcurrentHashSet& s) = delete;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  It's safe to call from any number
+    // of threads at once, along with contains().  When the ratio of size to
+    // capacity exceeds 0.8, the array is doubled in size.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  It never waits on a lock.  An element whose add()
+    // has returned is always found; one whose add() is still in progress
+    // may or may not be.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // capacity() returns the current size of the array.
+    unsigned int capacity() const noexcept;
+
+
+private:
+    struct Node
+    {
+        ElementType value;
+        std::atomic<Node*> next;
+    };
+
+    struct Table
+    {
+        unsigned int cap;
+        std::atomic<Node*>* buckets;
+    };
+
+    HashFunction hashFunction;
+    std::atomic<Table*> table;
+    std::atomic<unsigned int> sz;
+    std::mutex stripes[STRIPES];
+    mutable EpochDomain epochs;
+
+    static Table* make_table(unsigned int cap);
+    static void delete_table(Table* t) noexcept;
+    void grow(unsigned int seen_cap);
+};
+
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::ConcurrentHashSet(HashFunction hashFunction)
+    : hashFunction{hashFunction}, table{make_table(DEFAULT_CAPACITY)}, sz{0}
+{
+}
+
+
+template <typename ElementType>
+ConcurrentHashSet<ElementType>::~ConcurrentHashSet() noexcept
+{
+    delete_table(table.load());
+}
+
+
+template <typename ElementType>
+typename ConcurrentHashSet<ElementType>::Table* ConcurrentHashSet<ElementType>::make_table(unsigned int cap)
+{
+    std::unique_ptr<std::atomic<Node*>[]> buckets{new std::atomic<Node*>[cap]};
+    for (unsigned int i = 0; i < cap; ++i)
+    {
+        buckets[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    Table* t = new Table{cap, buckets.get()};
+    buckets.release();
+    return t;
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::delete_table(Table* t) noexcept
+{
+    for (unsigned int i = 0; i < t->cap; ++i)
+    {
+        Node* current = t->buckets[i].load(std::memory_order_relaxed);
+        while (current != nullptr)
+        {
+            Node* del = current;
+            current = current->next.load(std::memory_order_relaxed);
+            delete del;
+        }
+    }
+    delete[] t->buckets;
+    delete t;
+}
+
+
+template <typename ElementType>
+bool ConcurrentHashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::add(const ElementType& element)
+{
+    unsigned int hash = hashFunction(element);
+    unsigned int seen_cap;
+
+    {
+        std::lock_guard<std::mutex> lock{stripes[hash % STRIPES]};
+
+        // a resize needs every stripe, so the array can't change while
+        // we're holding this one
+        Table* t = table.load();
+        seen_cap = t->cap;
+        std::atomic<Node*>& head = t->buckets[hash % t->cap];
+
+        // nobody else can add to this list right now, so relaxed loads
+        // are enough to look for the element
+        Node* first = head.load(std::memory_order_relaxed);
+        for (Node* current = first; current != nullptr; current = current->next.load(std::memory_order_relaxed))
+        {
+            if (current->value == element)
+            {
+                return;
+            }
+        }
+
+        // the node is fully built before the release store makes it
+        // visible to readers
+        Node* node = new Node{element, {first}};
+        head.store(node, std::memory_order_release);
+
+        // keep the ratio of size to capacity at or under 0.8
+        unsigned long long new_sz = sz.fetch_add(1, std::memory_order_relaxed) + 1ull;
+        if (new_sz * 5 <= seen_cap * 4ull)
+        {
+            return;
+        }
+    }
+
+    grow(seen_cap);
+}
+
+
+template <typename ElementType>
+void ConcurrentHashSet<ElementType>::grow(unsigned int seen_cap)
+{
+    Table* old_table;
+
+    {
+        // the locks are released in the opposite order they were taken
+        // in, even if building the new array throws
+        std::unique_lock<std::mutex> locks[STRIPES];
+        for (unsigned int i = 0; i < STRIPES; ++i)
+        {
+            locks[i] = std::unique_lock<std::mutex>{stripes[i]};
+        }
+
+        old_table = table.load();
+
+        // someone else may have already resized while we were waiting
+        if (old_table->cap != seen_cap)
+        {
+            old_table = nullptr;
+        }
+        else
+        {
+            // if copying fails partway, the new array (and whatever's been
+            // copied into it) is deleted and the old one stays in place
+            std::unique_ptr<Table, void (*)(Table*)> new_table{make_table(old_table->cap * 2), delete_table};
+
+            // readers may still be walking the old lists, so those nodes
+            // can't be relinked; the new array gets copies instead
+            for (unsigned int i = 0; i < old_table->cap; ++i)
+            {
+                for (Node* current = old_table->buckets[i].load(std::memory_order_relaxed);
+                     current != nullptr;
+                     current = current->next.load(std::memory_order_relaxed))
+                {
+                    std::atomic<Node*>& head = new_table->buckets[hashFunction(current->value) % new_table->cap];
+                    head.store(
+                        new Node{current->value, {head.load(std::memory_order_relaxed)}},
+                        std::memory_order_relaxed);
+                }
+            }
+
+            // publishing the new array also publishes everything in it
+            table.store(new_table.release());
+        }
+    }
+
+    if (old_table != nullptr)
+    {
+        // wait out every reader that might have loaded the old array
+        epochs.synchronize();
+        delete_table(old_table);
+    }
+}
+
+
+template <typename ElementType>
+bool ConcurrentHashSet<ElementType>::contains(const ElementType& element) const
+{
+    unsigned int hash = hashFunction(element);
+
+    EpochDomain::ReadGuard guard{epochs};
+    Table* t = table.load();
+
+    for (Node* current = t->buckets[hash % t->cap].load(std::memory_order_acquire);
+         current != nullptr;
+         current = current->next.load(std::memory_order_acquire))
+    {
+        if (current->value == element)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentHashSet<ElementType>::size() const noexcept
+{
+    return sz.load(std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentHashSet<ElementType>::capacity() const noexcept
+{
+    // a resize may delete the array as soon as it's no longer published,
+    // so it can only be looked at while guarded
+    EpochDomain::ReadGuard guard{epochs};
+    return table.load()->cap;
+}
+
+
+
+#endif // CONCURRENTHASHSET_HPP
@@ -0,0 +1,397 @@
+// ConcurrentSkipListSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A ConcurrentSkipListSet is a skip list, shaped like SkipListSet (each
+// node has a pointer to the next node on its level and one to the node
+// for the same key on the level below), that can be used by many threads
+// at once: any number of threads can call contains() while others call
+// add(), with no external locking.
+//
+// * contains() never blocks and never retries.  It does exactly what
+//   SkipListSet's does, except that the "next" pointers it follows are
+//   atomic.
+// * add() takes no locks (except around a level tester, if one was given;
+//   see below).  It builds a node for level 0 and links it in with a
+//   compare-and-swap on its predecessor's "next" pointer; if another
+//   thread linked something in there first, it moves forward from that
+//   predecessor and tries again.  Once the element is on level 0 -- which
+//   is the moment it's in the set -- the rest of its tower is linked in
+//   the same way, from the bottom up, so that a reader who follows a
+//   "down" pointer always lands on a node that's already linked in.
+// * Elements are never removed, so a node, once linked in, stays linked
+//   in until the set is destroyed, and readers never need to be protected
+//   from a node being deleted underneath them.  The only nodes deleted
+//   before then are ones that lost a race to add the same element, and
+//   those were never visible to anyone else.
+//
+// The -INF on every level is built in advance, one for each level there
+// could ever be, so the skip list grows taller by bumping a counter
+// instead of publishing new nodes.  The +INF is a nullptr "next."
+//
+// The coin flips are made by a SkipListLevelTester, if one is given, which
+// is called with a lock held (since it may keep state of its own).  When
+// none is given, each thread flips its own coins and no lock is needed.
+
+#ifndef CONCURRENTSKIPLISTSET_HPP
+#define CONCURRENTSKIPLISTSET_HPP
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include "Set.hpp"
+#include "SkipListSet.hpp"
+
+
+
+template <typename ElementType>
+class ConcurrentSkipListSet : public Set<ElementType>
+{
+public:
+    // Initializes a ConcurrentSkipListSet to be empty, with or without a
+    // "level tester" object that will decide, whenever a "coin flip" is
+    // needed, whether a key should occupy the next level above.  Without
+    // one, the coin flips are random.
+    ConcurrentSkipListSet();
+    explicit ConcurrentSkipListSet(std::unique_ptr<SkipListLevelTester<ElementType>> levelTester);
+
+    // Cleans up the ConcurrentSkipListSet so that it leaks no memory.  No
+    // other thread may be using it at the time.
+    virtual ~ConcurrentSkipListSet() noexcept;
+
+    // A ConcurrentSkipListSet is shared by reference among the threads
+    // that use it, so it can't be copied or moved.
+    ConcurrentSkipListSet(const ConcurrentSkipListSet& s) = delete;
+    ConcurrentSkipListSet& operator=(const ConcurrentSkipListSet& s) = delete;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  It's safe to call from any number
+    // of threads at once, along with contains().  This function runs in
+    // an expected time of O(log n), plus a step for each add() it races
+    // with in the same neighborhood.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  It never waits on a lock and never starts over.
+    // An element whose add() has returned is always found; one whose
+    // add() is still in progress may or may not be.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // levelCount() returns the number of levels in the skip list.
+    unsigned int levelCount() const noexcept;
+
+
+    // elementsOnLevel() returns the number of elements that are stored
+    // on the given level of the skip list, or 0 if the level doesn't
+    // exist.  While adds are in progress, this may lag behind.
+    unsigned int elementsOnLevel(unsigned int level) const noexcept;
+
+
+    // isElementOnLevel() returns true if the given element is on the
+    // given level, false otherwise.
+    bool isElementOnLevel(const ElementType& element, unsigned int level) const;
+
+
+private:
+    // The -INF heads hold a default-constructed element that's never
+    // looked at, since a search starts at a head and only ever compares
+    // against the nodes after it.
+    struct Node
+    {
+        ElementType value;
+        std::atomic<Node*> next;
+        Node* down;
+    };
+
+    // the cap is 3 * ceil(log2 n), which is never more than this
+    static constexpr unsigned int MAX_LEVELS = 96;
+
+    std::unique_ptr<SkipListLevelTester<ElementType>> levelTester;
+    std::mutex level_tester_mutex;
+    Node heads[MAX_LEVELS];
+    std::atomic<unsigned int> levels;
+    std::atomic<unsigned int> sz;
+    std::atomic<unsigned int> level_sizes[MAX_LEVELS];
+
+    unsigned int flip_the_coins(const ElementType& element);
+    void raise_the_levels_to(unsigned int height) noexcept;
+    bool link_this_foo(Node* before, Node* node);
+};
+
+
+
+template <typename ElementType>
+constexpr unsigned int ConcurrentSkipListSet<ElementType>::MAX_LEVELS;
+
+
+template <typename ElementType>
+ConcurrentSkipListSet<ElementType>::ConcurrentSkipListSet()
+    : ConcurrentSkipListSet{nullptr}
+{
+}
+
+
+template <typename ElementType>
+ConcurrentSkipListSet<ElementType>::ConcurrentSkipListSet(std::unique_ptr<SkipListLevelTester<ElementType>> levelTester)
+    : levelTester{std::move(levelTester)}, heads{}, levels{1}, sz{0}
+{
+    for (unsigned int level = 0; level < MAX_LEVELS; ++level)
+    {
+        heads[level].next.store(nullptr, std::memory_order_relaxed);
+        heads[level].down = level > 0 ? &heads[level - 1] : nullptr;
+        level_sizes[level].store(0, std::memory_order_relaxed);
+    }
+}
+
+
+template <typename ElementType>
+ConcurrentSkipListSet<ElementType>::~ConcurrentSkipListSet() noexcept
+{
+    // every node is on exactly one level
+    for (unsigned int level = 0; level < MAX_LEVELS; ++level)
+    {
+        Node* current = heads[level].next.load(std::memory_order_relaxed);
+        while (current != nullptr)
+        {
+            Node* del = current;
+            current = current->next.load(std::memory_order_relaxed);
+            delete del;
+        }
+    }
+}
+
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void ConcurrentSkipListSet<ElementType>::add(const ElementType& element)
+{
+    // the last node before the element on each level, from the top down;
+    // these are only a place to start, since other threads may link nodes
+    // in after them before this one gets there
+    Node* before[MAX_LEVELS];
+
+    unsigned int top = levels.load(std::memory_order_acquire);
+    Node* node = &heads[top - 1];
+    for (unsigned int level = top; level > 0; --level)
+    {
+        Node* next = node->next.load(std::memory_order_acquire);
+        while (next != nullptr && next->value < element)
+        {
+            node = next;
+            next = node->next.load(std::memory_order_acquire);
+        }
+
+        before[level - 1] = node;
+        node = node->down;
+    }
+
+    Node* found = before[0]->next.load(std::memory_order_acquire);
+    if (found != nullptr && found->value == element)
+    {
+        return;
+    }
+
+    unsigned int height = flip_the_coins(element);
+    for (unsigned int level = top; level < height; ++level)
+    {
+        before[level] = &heads[level];
+    }
+
+    // level 0 decides whether this add happens at all; the node isn't
+    // visible to anyone until it's linked in, so if another thread got
+    // the same element in first, it can simply be deleted
+    Node* below = new Node{element, {nullptr}, nullptr};
+    if (!link_this_foo(before[0], below))
+    {
+        delete below;
+        return;
+    }
+
+    sz.fetch_add(1, std::memory_order_relaxed);
+    level_sizes[0].fetch_add(1, std::memory_order_relaxed);
+    raise_the_levels_to(height);
+
+    // if allocating fails partway, what's been linked in so far is a
+    // shorter tower
+    for (unsigned int level = 1; level < height; ++level)
+    {
+        Node* tower = new Node{element, {nullptr}, below};
+        link_this_foo(before[level], tower);
+        level_sizes[level].fetch_add(1, std::memory_order_relaxed);
+        below = tower;
+    }
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentSkipListSet<ElementType>::flip_the_coins(const ElementType& element)
+{
+    unsigned int cap = impl_::SkipListSet__levelCap(sz.load(std::memory_order_relaxed) + 1);
+    unsigned int height = 1;
+
+    if (levelTester != nullptr)
+    {
+        std::lock_guard<std::mutex> lock{level_tester_mutex};
+
+        while (height < cap && levelTester->shouldOccupyNextLevel(element))
+        {
+            height++;
+        }
+    }
+    else
+    {
+        static thread_local std::default_random_engine engine{std::random_device{}()};
+        std::bernoulli_distribution distribution{0.5};
+
+        while (height < cap && distribution(engine))
+        {
+            height++;
+        }
+    }
+
+    return height;
+}
+
+
+template <typename ElementType>
+void ConcurrentSkipListSet<ElementType>::raise_the_levels_to(unsigned int height) noexcept
+{
+    // the heads are all linked together already, so all it takes for
+    // searches to start higher is for them to see a higher count; a
+    // search that starts above the tallest tower just drops through the
+    // empty levels
+    unsigned int current = levels.load(std::memory_order_relaxed);
+    while (current < height
+        && !levels.compare_exchange_weak(current, height, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::link_this_foo(Node* before, Node* node)
+{
+    // nothing is ever unlinked, so "before" is always still in the list
+    // and always still before the node's place in it; when the
+    // compare-and-swap fails, something new has been linked in after it,
+    // so we walk forward from there and try again
+    while (true)
+    {
+        Node* next = before->next.load(std::memory_order_acquire);
+        while (next != nullptr && next->value < node->value)
+        {
+            before = next;
+            next = before->next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr && next->value == node->value)
+        {
+            return false;
+        }
+
+        // the node is fully built before the release makes it visible
+        node->next.store(next, std::memory_order_relaxed);
+        if (before->next.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+}
+
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::contains(const ElementType& element) const
+{
+    // go right as far as possible without passing the element, then down,
+    // until there's no further down to go
+    const Node* node = &heads[levels.load(std::memory_order_acquire) - 1];
+    while (true)
+    {
+        const Node* next = node->next.load(std::memory_order_acquire);
+        while (next != nullptr && next->value < element)
+        {
+            node = next;
+            next = node->next.load(std::memory_order_acquire);
+        }
+
+        if (node->down == nullptr)
+        {
+            return next != nullptr && next->value == element;
+        }
+
+        node = node->down;
+    }
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentSkipListSet<ElementType>::size() const noexcept
+{
+    return sz.load(std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentSkipListSet<ElementType>::levelCount() const noexcept
+{
+    return levels.load(std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+unsigned int ConcurrentSkipListSet<ElementType>::elementsOnLevel(unsigned int level) const noexcept
+{
+    return level < levelCount() ? level_sizes[level].load(std::memory_order_relaxed) : 0;
+}
+
+
+template <typename ElementType>
+bool ConcurrentSkipListSet<ElementType>::isElementOnLevel(const ElementType& element, unsigned int level) const
+{
+    unsigned int top = levels.load(std::memory_order_acquire);
+    if (level >= top)
+    {
+        return false;
+    }
+
+    // search as contains() does, but stop on the given level
+    const Node* node = &heads[top - 1];
+    for (unsigned int current = top - 1; ; --current)
+    {
+        const Node* next = node->next.load(std::memory_order_acquire);
+        while (next != nullptr && next->value < element)
+        {
+            node = next;
+            next = node->next.load(std::memory_order_acquire);
+        }
+
+        if (current == level)
+        {
+            return next != nullptr && next->value == element;
+        }
+
+        node = node->down;
+    }
+}
+
+
+
+#endif // CONCURRENTSKIPLISTSET_HPP
@@ -0,0 +1,67 @@
+// EpochDomain.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include "EpochDomain.hpp"
+#include <functional>
+#include <thread>
+
+
+namespace
+{
+    // Which of the counters the calling thread uses.  Two threads sharing
+    // a slot is fine (the counter just goes higher); it only costs some
+    // contention.
+    unsigned int slotForThisThread(unsigned int slots)
+    {
+        static thread_local unsigned int slot =
+            static_cast<unsigned int>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        return slot % slots;
+    }
+}
+
+
+EpochDomain::ReadGuard::ReadGuard(const EpochDomain& domain) noexcept
+{
+    unsigned long e = domain.epoch.load();
+    counter = &domain.counters[e & 1][slotForThisThread(SLOTS)].active;
+
+    // sequentially consistent, so that anything the reader loads after
+    // this is ordered after the increment (synchronize() relies on it)
+    counter->fetch_add(1);
+}
+
+
+EpochDomain::ReadGuard::~ReadGuard() noexcept
+{
+    counter->fetch_sub(1, std::memory_order_release);
+}
+
+
+EpochDomain::EpochDomain() noexcept
+    : epoch{0}
+{
+}
+
+
+void EpochDomain::synchronize()
+{
+    std::lock_guard<std::mutex> lock{synchronizeMutex};
+
+    for (int phase = 0; phase < 2; ++phase)
+    {
+        // flip the epoch so new readers land on the other side, then wait
+        // for the side they used to land on to empty out
+        unsigned long old_parity = epoch.fetch_add(1) & 1;
+
+        for (unsigned int slot = 0; slot < SLOTS; ++slot)
+        {
+            while (counters[old_parity][slot].active.load() != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
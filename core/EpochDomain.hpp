@@ -0,0 +1,75 @@
+// EpochDomain.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// An EpochDomain lets readers run without taking any locks while a
+// writer waits until it's safe to free memory those readers might still
+// be looking at.  Readers bracket each read with a ReadGuard, which costs
+// one atomic increment and one atomic decrement.  A writer that has
+// unpublished something (say, swapped out an old array for a new one)
+// calls synchronize(), which returns only once every ReadGuard that
+// existed at the time of the call has been destroyed; after that, nobody
+// can be holding a pointer to the unpublished memory, so it can be
+// deleted.
+//
+// Readers announce themselves in one of two "epochs" (even and odd),
+// spread over several counters so that readers on different threads
+// aren't all fighting over the same cache line.  synchronize() flips the
+// epoch, so new readers go to the other side, then waits for the old side
+// to drain, and does this twice so that both sides have been drained.
+
+#ifndef EPOCHDOMAIN_HPP
+#define EPOCHDOMAIN_HPP
+
+#include <atomic>
+#include <mutex>
+
+
+
+class EpochDomain
+{
+public:
+    // A ReadGuard marks the span of time during which a reader may be
+    // holding pointers into shared memory.  It can't be copied or moved.
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(const EpochDomain& domain) noexcept;
+        ~ReadGuard() noexcept;
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        std::atomic<long>* counter;
+    };
+
+public:
+    EpochDomain() noexcept;
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    // synchronize() waits until every ReadGuard that was alive when it
+    // was called has been destroyed.  ReadGuards created after it starts
+    // don't hold it up.
+    void synchronize();
+
+private:
+    static constexpr unsigned int SLOTS = 16;
+
+    // each counter sits in its own cache line
+    struct alignas(64) Counter
+    {
+        std::atomic<long> active{0};
+    };
+
+    mutable Counter counters[2][SLOTS];
+    std::atomic<unsigned long> epoch;
+    std::mutex synchronizeMutex;
+};
+
+
+
+#endif // EPOCHDOMAIN_HPP
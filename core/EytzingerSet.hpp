@@ -0,0 +1,382 @@
+// EytzingerSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// An EytzingerSet is a read-only Set, built once from elements in sorted
+// order (such as an AVLSet's), that's meant for a dictionary that's
+// loaded once and then only searched.
+//
+// The elements are stored in a single array in "Eytzinger" order: the
+// order a breadth-first traversal of a perfectly balanced binary search
+// tree would visit them.  The root is at index 1, and the children of the
+// element at index k are at indexes 2k and 2k + 1, so the tree needs no
+// pointers at all, and a search is a loop that doubles k and adds one
+// when the element being searched for is greater:
+//
+//     k = 2 * k + (elements[k] < element);
+//
+// There's no branch on the outcome of the comparison for the processor to
+// mispredict, and since the next few levels beneath k sit next to each
+// other in the array (the 2^d descendants d levels down from k start at
+// index k * 2^d), they can be prefetched a few levels before the search
+// gets to them.  Once k runs off the bottom of the tree, the search
+// backs up to the last place it went left, which is the smallest element
+// not less than the one being searched for.  (For strings, comparing two
+// elements still has branches of its own, but the search around it
+// doesn't add any.)
+//
+// The array is aligned to the size of a cache line, so that where
+// elements fit evenly into a cache line, the descendants a search
+// prefetches share as few cache lines as possible.
+
+#ifndef EYTZINGERSET_HPP
+#define EYTZINGERSET_HPP
+
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include "AVLSet.hpp"
+#include "Set.hpp"
+#include "SetException.hpp"
+
+
+
+template <typename ElementType>
+class EytzingerSet : public Set<ElementType>
+{
+public:
+    // Builds an EytzingerSet containing the elements in the range
+    // [first, last), which must be in ascending order (with repeats
+    // allowed, and ignored).  The range is read twice, once to count and
+    // check the elements and once to store them, so it must be a forward
+    // range.  Throws a SetException if the elements aren't in order.
+    template <typename Iterator>
+    EytzingerSet(Iterator first, Iterator last);
+
+    // Builds an EytzingerSet containing the same elements as the given
+    // AVLSet.
+    explicit EytzingerSet(const AVLSet<ElementType>& s);
+
+    // Cleans up the EytzingerSet so that it leaks no memory.
+    virtual ~EytzingerSet() noexcept;
+
+    // An EytzingerSet can be moved, but not copied.
+    EytzingerSet(EytzingerSet&& s) noexcept;
+    EytzingerSet(const EytzingerSet&) = delete;
+    EytzingerSet& operator=(const EytzingerSet&) = delete;
+    EytzingerSet& operator=(EytzingerSet&&) = delete;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() always throws a SetException, since an EytzingerSet can't be
+    // changed once it's built.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is in the set, false
+    // otherwise.  It runs in O(log n) time, comparing against one element
+    // on each level of the tree and then checking for equality once.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // memoryBytes() returns the number of bytes allocated for the array
+    // (not counting anything the elements allocate themselves).
+    unsigned long long memoryBytes() const noexcept;
+
+
+private:
+    static constexpr unsigned int CACHE_LINE = 64;
+
+    // how many elements fit into a cache line (rounded down to a power
+    // of two), but at least 4, so that the prefetches stay at least two
+    // levels ahead of the search
+    static constexpr unsigned int fitting_in_a_line(unsigned int n) noexcept
+    {
+        return n * 2 * sizeof(ElementType) <= CACHE_LINE ? fitting_in_a_line(n * 2) : n;
+    }
+
+    static constexpr unsigned int PREFETCH_STRIDE =
+        fitting_in_a_line(1) < 4 ? 4 : fitting_in_a_line(1);
+
+    // elements[0] is unused, so that the root can be at index 1
+    char* storage;
+    ElementType* elements;
+    unsigned int sz;
+
+    template <typename Iterator>
+    void build(Iterator first, Iterator last);
+    void allocate_this_foo(unsigned int n);
+    void destroy_this_foo(unsigned int constructed) noexcept;
+};
+
+
+
+namespace impl_
+{
+    inline void EytzingerSet__prefetch(const void* address)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#endif
+    }
+
+
+    // the number of 1 bits at the bottom of k
+    inline unsigned int EytzingerSet__trailingOnes(unsigned int k)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return ~k == 0 ? 32 : static_cast<unsigned int>(__builtin_ctz(~k));
+#else
+        unsigned int ones = 0;
+        while ((k & 1) != 0)
+        {
+            k >>= 1;
+            ones++;
+        }
+        return ones;
+#endif
+    }
+}
+
+
+template <typename ElementType>
+constexpr unsigned int EytzingerSet<ElementType>::CACHE_LINE;
+
+template <typename ElementType>
+constexpr unsigned int EytzingerSet<ElementType>::PREFETCH_STRIDE;
+
+
+template <typename ElementType>
+template <typename Iterator>
+EytzingerSet<ElementType>::EytzingerSet(Iterator first, Iterator last)
+    : storage{nullptr}, elements{nullptr}, sz{0}
+{
+    build(first, last);
+}
+
+
+template <typename ElementType>
+EytzingerSet<ElementType>::EytzingerSet(const AVLSet<ElementType>& s)
+    : storage{nullptr}, elements{nullptr}, sz{0}
+{
+    build(s.begin(), s.end());
+}
+
+
+template <typename ElementType>
+EytzingerSet<ElementType>::~EytzingerSet() noexcept
+{
+    destroy_this_foo(sz + 1);
+}
+
+
+template <typename ElementType>
+EytzingerSet<ElementType>::EytzingerSet(EytzingerSet&& s) noexcept
+    : storage{s.storage}, elements{s.elements}, sz{s.sz}
+{
+    // the expiring set is left empty, with no array (which contains()
+    // never looks at when the size is 0)
+    s.storage = nullptr;
+    s.elements = nullptr;
+    s.sz = 0;
+}
+
+
+template <typename ElementType>
+template <typename Iterator>
+void EytzingerSet<ElementType>::build(Iterator first, Iterator last)
+{
+    static_assert(
+        std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>::value,
+        "an EytzingerSet must be built from a forward range");
+
+    // first pass: count the distinct elements, checking the order
+    unsigned long long n = 0;
+    Iterator previous = last;
+    for (Iterator i = first; i != last; ++i)
+    {
+        if (previous != last)
+        {
+            if (*i < *previous)
+            {
+                throw SetException{"an EytzingerSet must be built from elements in ascending order"};
+            }
+            else if (!(*i > *previous))
+            {
+                continue;
+            }
+        }
+
+        previous = i;
+        n++;
+    }
+
+    // 2k + 1 has to fit in an unsigned int, with a 0 bit to spare at the
+    // top, for every index k
+    if (n >= 0x40000000ull)
+    {
+        throw SetException{"too many elements for an EytzingerSet"};
+    }
+
+    allocate_this_foo(static_cast<unsigned int>(n));
+
+    // second pass: an inorder walk of the implicit tree visits the indexes
+    // in the order their elements appear in the range
+    unsigned int k = n == 0 ? 0 : 1;
+    while (k != 0 && 2 * k <= n)
+    {
+        k *= 2;
+    }
+
+    // if copying an element fails, the constructor won't finish, so the
+    // destructor won't clean up the array; it has to be done here
+    try
+    {
+        previous = last;
+        for (Iterator i = first; i != last; ++i)
+        {
+            if (previous != last && !(*i > *previous))
+            {
+                continue;
+            }
+            previous = i;
+
+            elements[k] = *i;
+
+            if (2 * k + 1 <= n)
+            {
+                // on to the leftmost index in the right subtree
+                k = 2 * k + 1;
+                while (2 * k <= n)
+                {
+                    k *= 2;
+                }
+            }
+            else
+            {
+                // back up past every right child to the first ancestor whose
+                // left subtree this was
+                k >>= impl_::EytzingerSet__trailingOnes(k) + 1;
+            }
+        }
+    }
+    catch (...)
+    {
+        destroy_this_foo(static_cast<unsigned int>(n) + 1);
+        throw;
+    }
+
+    sz = static_cast<unsigned int>(n);
+}
+
+
+template <typename ElementType>
+void EytzingerSet<ElementType>::allocate_this_foo(unsigned int n)
+{
+    // one extra cache line, so the array can start on a boundary
+    storage = new char[(n + 1ull) * sizeof(ElementType) + CACHE_LINE];
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(storage);
+    std::uintptr_t aligned = (address + CACHE_LINE - 1) & ~static_cast<std::uintptr_t>(CACHE_LINE - 1);
+    elements = reinterpret_cast<ElementType*>(aligned);
+
+    // every element is default-constructed first, so that the array can
+    // always be cleaned up in index order, and then assigned its value
+    unsigned int constructed = 0;
+    try
+    {
+        for (; constructed <= n; ++constructed)
+        {
+            new (&elements[constructed]) ElementType{};
+        }
+    }
+    catch (...)
+    {
+        destroy_this_foo(constructed);
+        throw;
+    }
+}
+
+
+template <typename ElementType>
+void EytzingerSet<ElementType>::destroy_this_foo(unsigned int constructed) noexcept
+{
+    if (storage == nullptr)
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < constructed; ++i)
+    {
+        elements[i].~ElementType();
+    }
+
+    delete[] storage;
+    storage = nullptr;
+    elements = nullptr;
+}
+
+
+template <typename ElementType>
+bool EytzingerSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void EytzingerSet<ElementType>::add(const ElementType&)
+{
+    throw SetException{"cannot add to an EytzingerSet, which is read-only"};
+}
+
+
+template <typename ElementType>
+bool EytzingerSet<ElementType>::contains(const ElementType& element) const
+{
+    unsigned int k = 1;
+    while (k <= sz)
+    {
+        // the first and last of k's descendants a few levels down, which
+        // are where this search will be shortly; prefetching never faults,
+        // even past the end of the array
+        const char* descendants = reinterpret_cast<const char*>(elements)
+            + static_cast<std::uintptr_t>(k) * PREFETCH_STRIDE * sizeof(ElementType);
+        impl_::EytzingerSet__prefetch(descendants);
+        impl_::EytzingerSet__prefetch(descendants + (PREFETCH_STRIDE - 1) * sizeof(ElementType));
+
+        k = 2 * k + (elements[k] < element);
+    }
+
+    // the 1 bits at the bottom of k are the times the search went right
+    // after it last went left; undoing them, and that last left, leaves
+    // the smallest element not less than this one (or 0 if there isn't one)
+    k >>= impl_::EytzingerSet__trailingOnes(k) + 1;
+
+    return k != 0 && elements[k] == element;
+}
+
+
+template <typename ElementType>
+unsigned int EytzingerSet<ElementType>::size() const noexcept
+{
+    return sz;
+}
+
+
+template <typename ElementType>
+unsigned long long EytzingerSet<ElementType>::memoryBytes() const noexcept
+{
+    return storage == nullptr ? 0 : (sz + 1ull) * sizeof(ElementType) + CACHE_LINE;
+}
+
+
+
+#endif // EYTZINGERSET_HPP
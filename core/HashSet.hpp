@@ -14,6 +14,11 @@
 // elements as there are array cells), the HashSet should be resized so
 // that it is twice as large as it was before.
 //
+// Elements can also be removed.  Optionally (see setShrinkOnLowLoad()),
+// once the proportion falls below 0.2, the HashSet is resized to half as
+// large.  The gap between the two thresholds means that a set whose size
+// hovers around either one doesn't resize back and forth.
+//
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::set, std::map, or std::vector) to store the information
 // in your data structure.  Instead, you'll need to use a dynamically-
@@ -23,12 +28,53 @@
 #ifndef HASHSET_HPP
 #define HASHSET_HPP
 
+#include <atomic>
 #include <functional>
+#include <iterator>
 #include <utility>
 #include <memory>
 #include <iostream>
+#include <exception>
+#include <new>
+#include <thread>
 #include <typeinfo>
 #include "Set.hpp"
+#include "SetException.hpp"
+
+
+
+// A HashSetStats is a snapshot of how well a HashSet's elements are spread
+// across its array, along with running totals of how much work its lookups
+// have done.  Chain lengths count the nodes in one index's linked list.
+struct HashSetStats
+{
+    // chainLengthHistogram[i] is the number of indexes whose chain has
+    // exactly i nodes, except that the last entry counts every chain that
+    // long or longer
+    static constexpr unsigned int HISTOGRAM_SIZE = 8;
+
+    unsigned int capacity;
+    unsigned int size;
+    unsigned int occupiedIndexes;
+    unsigned int longestChain;
+    unsigned int chainLengthHistogram[HISTOGRAM_SIZE];
+    unsigned int resizeCount;
+    unsigned long long lookups;
+    unsigned long long probes;
+
+    // the ratio of size to capacity
+    double loadFactor() const noexcept;
+
+    // the average length of the chains that aren't empty
+    double meanChainLength() const noexcept;
+
+    // the average number of nodes each lookup compared against
+    double probesPerLookup() const noexcept;
+};
+
+
+// Writes a HashSetStats in a human-readable form, across several lines.
+std::ostream& operator<<(std::ostream& out, const HashSetStats& stats);
 
 
 
@@ -49,6 +95,14 @@ public:
     // hash function whenever it needs to hash an element.
     explicit HashSet(HashFunction hashFunction);
 
+    // Initializes a HashSet containing the elements in the range
+    // [first, last), using the given hash function.  When the range can
+    // be measured up front (i.e., it's a forward range), the array is
+    // sized once so that no resizing happens while the elements are
+    // being added.
+    template <typename Iterator>
+    HashSet(Iterator first, Iterator last, HashFunction hashFunction);
+
     // Cleans up the HashSet so that it leaks no memory.
     virtual ~HashSet() noexcept;
 
@@ -56,15 +110,27 @@ public:
     HashSet(const HashSet& s);
 
     // Initializes a new HashSet whose contents are moved from an
-    // expiring one.
+    // expiring one.  The array, its nodes, and the hash function are taken
+    // over as-is, so this runs in constant time and allocates nothing.
+    // The expiring HashSet is left empty and without a hash function; it
+    // can be destroyed, assigned a new value, swapped, or searched (it
+    // contains nothing), but add() and reserve() throw a SetException
+    // until it's been given a hash function again by one of those.
     HashSet(HashSet&& s) noexcept;
 
-    // Assigns an existing HashSet into another.
+    // Assigns an existing HashSet into another.  If copying fails partway
+    // through (e.g., because memory runs out), the set is left unchanged.
     HashSet& operator=(const HashSet& s);
 
-    // Assigns an expiring HashSet into another.
+    // Assigns an expiring HashSet into another, in constant time (plus
+    // the time it takes to destroy what was there before), leaving the
+    // expiring one as the move constructor does.
     HashSet& operator=(HashSet&& s) noexcept;
 
+    // swap() exchanges the contents (and hash functions) of two HashSets
+    // in constant time, without allocating anything.
+    void swap(HashSet& s) noexcept;
+
 
     // isImplemented() should be modified to return true if you've
     // decided to implement a HashSet, false otherwise.
@@ -87,10 +153,58 @@ public:
     virtual bool contains(const ElementType& element) const override;
 
 
+    // containsMany() looks up the n elements in the given array, storing
+    // whether elements[i] is in the set into results[i].  The answers are
+    // the same as calling contains() on each element, but the elements are
+    // hashed in groups and the memory each lookup is going to touch is
+    // prefetched before any of the lists are walked, so the cache misses
+    // of independent lookups overlap instead of happening one at a time.
+    void containsMany(const ElementType* elements, unsigned int n, bool* results) const;
+
+
+    // remove() removes an element from the set, returning true if it was
+    // there and false otherwise.  The element's node is unlinked and kept
+    // for the next add() to reuse, so removing and adding words doesn't
+    // allocate.  If shrinking on low load is turned on and the ratio of
+    // size to capacity falls below 0.2, the array is halved (but never
+    // made smaller than DEFAULT_CAPACITY).  This function runs in constant
+    // time, except when it shrinks the array.
+    bool remove(const ElementType& element);
+
+
+    // setShrinkOnLowLoad() turns on or off remove()'s halving of the array
+    // when the ratio of size to capacity falls below 0.2.  It's off by
+    // default, and turning it on has no effect until the next remove().
+    void setShrinkOnLowLoad(bool shrink) noexcept;
+
+
+    // shrinkToFit() gives back the memory held for removed elements and
+    // resizes the array to the smallest capacity that keeps the ratio of
+    // size to capacity at or under 0.8 (but no smaller than
+    // DEFAULT_CAPACITY).  It runs in linear time with respect to the
+    // capacity.
+    void shrinkToFit();
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const noexcept override;
 
 
+    // reserve() resizes the array, if necessary, so that at least n
+    // elements can be stored without add() having to resize it again.
+    // It never makes the array smaller.  Existing nodes are relinked into
+    // the new array rather than copied, so this runs in linear time with
+    // respect to the number of elements already in the set.
+    void reserve(unsigned int n);
+
+
+    // stats() returns a snapshot of how the elements are distributed and
+    // how much work lookups have done so far.  It runs in linear time with
+    // respect to the capacity.  Keeping the lookup totals up to date costs
+    // contains() two additions, so they're always on.
+    HashSetStats stats() const;
+
+
     // elementsAtIndex() returns the number of elements that hashed to a
     // particular index in the array.  If the index is out of the boundaries
     // of the array, this function returns 0.
@@ -105,20 +219,108 @@ public:
     // Hashing and assigning index to place nodes into table
 
 private:
-    HashFunction hashFunction;
     struct LinkedListNode
     {
     	ElementType value;
     	LinkedListNode* next = nullptr;
     };
-    // LinkedListNode** array_of_LL;
+
+public:
+    // A const_iterator visits every element of a HashSet exactly once,
+    // walking the array from index 0 up and each index's linked list from
+    // its head, so it reads memory in the order it's laid out.  It
+    // allocates nothing.  Adding to the set (or otherwise changing it)
+    // invalidates every iterator into it.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ElementType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ElementType*;
+        using reference = const ElementType&;
+
+        const_iterator() noexcept;
+
+        reference operator*() const noexcept;
+        pointer operator->() const noexcept;
+
+        const_iterator& operator++() noexcept;
+        const_iterator operator++(int) noexcept;
+
+        bool operator==(const const_iterator& other) const noexcept;
+        bool operator!=(const const_iterator& other) const noexcept;
+
+    private:
+        friend class HashSet;
+        const_iterator(LinkedListNode* const* cells, unsigned int index, unsigned int end_index) noexcept;
+
+        // moves forward to the head of the next non-empty list, if any
+        void skip_empty_indexes() noexcept;
+
+        LinkedListNode* const* cells;
+        unsigned int index;
+        unsigned int end_index;
+        LinkedListNode* node;
+    };
+
+    using iterator = const_iterator;
+
+
+    // begin() and end() allow a HashSet to be iterated (e.g., by a
+    // range-based for loop).  Elements are visited in no particular order.
+    const_iterator begin() const noexcept;
+    const_iterator end() const noexcept;
+
+
+    // parallelForEach() calls f(element, worker) once for every element
+    // in the set, splitting the array into one contiguous range of indexes
+    // per worker and walking the ranges on separate threads (the calling
+    // thread being one of them).  worker is a number in [0, workers), the
+    // same for every element in one range, so f can collect results into
+    // per-worker storage without any locking; otherwise, f must be safe to
+    // call from several threads at once.  When workers is 0, one worker
+    // per hardware thread is used.  If any call to f throws, the first
+    // exception is rethrown here after every thread has finished.  The set
+    // mustn't be changed while this is running.
+    template <typename Function>
+    void parallelForEach(Function f, unsigned int workers = 0) const;
+
+private:
+    HashFunction hashFunction;
+    // each cell of the array is the head of its linked list (nullptr
+    // when nothing has hashed to that index)
     LinkedListNode** array_of_LL;
     void delete_this_foos_linked_list();
+    void delete_the_spare_nodes() noexcept;
+    void check_for_a_hash_function(const char* operation) const;
+    void copy_this_foos_linked_list(const HashSet& s);
+    void rehash_this_foo(unsigned int new_cap);
     unsigned int cap;
     unsigned int current_sz;
-    unsigned int sz_for_load_factor;
+    // number of indexes whose linked list is non-empty
+    unsigned int occupied_indexes;
+    unsigned int resize_count;
+    // what every lookup costs, for stats(); a lookup that compares
+    // against three nodes is three probes.  These are updated by const
+    // lookups, which may be running in many threads at once, so they're
+    // atomic (with relaxed increments, since nothing else depends on them)
+    mutable std::atomic<unsigned long long> lookup_count;
+    mutable std::atomic<unsigned long long> probe_count;
+    // nodes unlinked by remove(), linked through their next pointers,
+    // waiting for add() to reuse them
+    LinkedListNode* spare_nodes;
+    bool shrinks_on_low_load;
     void shove_it(const ElementType& element);
-    bool* array_of_added_to_index;
+    LinkedListNode* grab_a_node(const ElementType& element);
+
+    template <typename Function>
+    void visit_these_indexes(Function& f, unsigned int worker, unsigned int first, unsigned int last) const;
+
+    template <typename Iterator>
+    void reserve_for_range(Iterator first, Iterator last, std::forward_iterator_tag);
+    template <typename Iterator>
+    void reserve_for_range(Iterator first, Iterator last, std::input_iterator_tag);
 };
 
 
@@ -130,379 +332,833 @@ namespace impl_
     {
         return 0;
     }
+
+
+    // Hints to the processor that the memory at the given address is
+    // about to be read.  It's only a hint, so it compiles away entirely
+    // where the compiler has no way to express it.
+    inline void HashSet__prefetch(const void* address)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#endif
+    }
+}
+
+
+inline double HashSetStats::loadFactor() const noexcept
+{
+    return capacity == 0 ? 0.0 : static_cast<double>(size) / capacity;
+}
+
+
+inline double HashSetStats::meanChainLength() const noexcept
+{
+    return occupiedIndexes == 0 ? 0.0 : static_cast<double>(size) / occupiedIndexes;
+}
+
+
+inline double HashSetStats::probesPerLookup() const noexcept
+{
+    return lookups == 0 ? 0.0 : static_cast<double>(probes) / lookups;
+}
+
+
+inline std::ostream& operator<<(std::ostream& out, const HashSetStats& stats)
+{
+    out << "size " << stats.size << ", capacity " << stats.capacity
+        << ", load factor " << stats.loadFactor() << "\n"
+        << "occupied indexes " << stats.occupiedIndexes
+        << ", longest chain " << stats.longestChain
+        << ", mean chain " << stats.meanChainLength() << "\n"
+        << "chain lengths:";
+
+    for (unsigned int i = 0; i < HashSetStats::HISTOGRAM_SIZE; ++i)
+    {
+        out << " " << i << (i + 1 == HashSetStats::HISTOGRAM_SIZE ? "+" : "")
+            << ":" << stats.chainLengthHistogram[i];
+    }
+
+    return out << "\n"
+        << "resizes " << stats.resizeCount
+        << ", lookups " << stats.lookups
+        << ", probes per lookup " << stats.probesPerLookup() << "\n";
 }
 
 
+template <typename ElementType>
+constexpr unsigned int HashSet<ElementType>::DEFAULT_CAPACITY;
+
+
 template <typename ElementType>
 HashSet<ElementType>::HashSet(HashFunction hashFunction)
-    : hashFunction{hashFunction}, array_of_LL{new LinkedListNode*[DEFAULT_CAPACITY]},
-    cap{DEFAULT_CAPACITY}, current_sz{0}, sz_for_load_factor{0}, array_of_added_to_index{new bool[DEFAULT_CAPACITY]} // initializes the hash function
+    : hashFunction{hashFunction}, array_of_LL{new LinkedListNode*[DEFAULT_CAPACITY]()},
+    cap{DEFAULT_CAPACITY}, current_sz{0}, occupied_indexes{0}, resize_count{0},
+    lookup_count{0}, probe_count{0},
+    spare_nodes{nullptr}, shrinks_on_low_load{false} // initializes the hash function
+{
+    // every linked list starts out empty (the array is value-initialized
+    // to nullptr above)
+}
+
+
+template <typename ElementType>
+template <typename Iterator>
+HashSet<ElementType>::HashSet(Iterator first, Iterator last, HashFunction hashFunction)
+    : HashSet{hashFunction}
 {
-    // std::cout << "in constructor" << std::endl;
-    for (int i = 0; i < cap; ++i)
+    // size the array once up front when we can tell how many elements
+    // are coming, so that the adds below never resize
+    reserve_for_range(first, last, typename std::iterator_traits<Iterator>::iterator_category{});
+
+    for (; first != last; ++first)
     {
-        // initializing new nodes for each index
-        array_of_LL[i] = new LinkedListNode{};
-        // initializing false for bool table
-        array_of_added_to_index[i] = false;
+        add(*first);
     }
+}
+
 
+template <typename ElementType>
+template <typename Iterator>
+void HashSet<ElementType>::reserve_for_range(Iterator first, Iterator last, std::forward_iterator_tag)
+{
+    reserve(static_cast<unsigned int>(std::distance(first, last)));
 }
 
+
+template <typename ElementType>
+template <typename Iterator>
+void HashSet<ElementType>::reserve_for_range(Iterator, Iterator, std::input_iterator_tag)
+{
+    // a single-pass range can't be measured without consuming it, so
+    // the array just grows as usual
+}
+
+
 template <typename ElementType>
 void HashSet<ElementType>::delete_this_foos_linked_list()
 {
-    // std::cout << "in constructor" << std::endl;
-    for (int i = 0; i < cap; ++i)
+    for (unsigned int i = 0; i < cap; ++i)
     {
         // iterating through linked lists for every index in table
         LinkedListNode* current = array_of_LL[i];
-        // std::cout << current->value << std::endl;
-        if (current->next == nullptr)
+        while (current != nullptr)
         {
-            delete current;
+            LinkedListNode* del = current;
+            current = current->next;
+            delete del;
         }
-        else
+    }
+    // delete array of linked lists
+    delete[] array_of_LL;
+    delete_the_spare_nodes();
+}
+
+
+template <typename ElementType>
+void HashSet<ElementType>::delete_the_spare_nodes() noexcept
+{
+    while (spare_nodes != nullptr)
+    {
+        LinkedListNode* del = spare_nodes;
+        spare_nodes = spare_nodes->next;
+        delete del;
+    }
+}
+
+
+template <typename ElementType>
+void HashSet<ElementType>::copy_this_foos_linked_list(const HashSet& s)
+{
+    // new array sized like the original, with every list empty
+    array_of_LL = new LinkedListNode*[s.cap]();
+    cap = s.cap;
+    current_sz = s.current_sz;
+    occupied_indexes = s.occupied_indexes;
+    resize_count = s.resize_count;
+    lookup_count.store(s.lookup_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    probe_count.store(s.probe_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    // spare nodes aren't part of the contents, so the copy starts with none
+    spare_nodes = nullptr;
+    shrinks_on_low_load = s.shrinks_on_low_load;
+
+    try
+    {
+        for (unsigned int i = 0; i < cap; ++i)
         {
-            while (current != nullptr)
+            // copy each list in order, always appending at the tail
+            LinkedListNode** tail = &array_of_LL[i];
+            for (LinkedListNode* current = s.array_of_LL[i]; current != nullptr; current = current->next)
             {
-
-                LinkedListNode* del = current;
-                current = current->next;
-                delete del;
+                *tail = new LinkedListNode{current->value, nullptr};
+                tail = &(*tail)->next;
             }
         }
     }
-    // delete array of bool
-    delete[] array_of_added_to_index;
-    // delete array of linked lists
-    delete[] array_of_LL;
+    catch (...)
+    {
+        // every list copied so far ends in a nullptr, so whatever's been
+        // built can be torn down the usual way
+        delete_this_foos_linked_list();
+        throw;
+    }
 }
 
+
 template <typename ElementType>
 HashSet<ElementType>::~HashSet() noexcept
 {
     // destructor
-    // std::cout << "in deconstructor" << std::endl;
     delete_this_foos_linked_list();
 }
 
 
 template <typename ElementType>
 HashSet<ElementType>::HashSet(const HashSet& s)
-    : hashFunction{impl_::HashSet__undefinedHashFunction<ElementType>},
-    array_of_LL{new LinkedListNode*[s.cap]}, cap{s.cap}, current_sz{s.current_sz}, sz_for_load_factor{s.sz_for_load_factor},
-    array_of_added_to_index{new bool[s.cap]}
+    : hashFunction{s.hashFunction}
+{
+    copy_this_foos_linked_list(s);
+}
+
+
+template <typename ElementType>
+HashSet<ElementType>::HashSet(HashSet&& s) noexcept
+    : hashFunction{std::move(s.hashFunction)}, array_of_LL{s.array_of_LL}, cap{s.cap},
+    current_sz{s.current_sz}, occupied_indexes{s.occupied_indexes}, resize_count{s.resize_count},
+    lookup_count{s.lookup_count.load(std::memory_order_relaxed)},
+    probe_count{s.probe_count.load(std::memory_order_relaxed)}, spare_nodes{s.spare_nodes},
+    shrinks_on_low_load{s.shrinks_on_low_load}
 {
-    // ^^ initializing new
-    // std::cout << "in copy" << std::endl;
-    for (int i = 0; i < cap; ++i)
+    // the expiring set is left with no array at all (a capacity of 0),
+    // which the lookups know how to deal with, and no hash function,
+    // which add() and reserve() check for; moving a std::function leaves
+    // it unspecified, so it's emptied explicitly
+    s.hashFunction = nullptr;
+    s.array_of_LL = nullptr;
+    s.spare_nodes = nullptr;
+    s.cap = 0;
+    s.current_sz = 0;
+    s.occupied_indexes = 0;
+}
+
+
+template <typename ElementType>
+HashSet<ElementType>& HashSet<ElementType>::operator=(const HashSet& s)
+{
+    if (this != &s)
     {
-        // setting everything to default
-        array_of_LL[i] = new LinkedListNode{s.array_of_LL[i]->value};
-        array_of_LL[i]->next = nullptr;
-        array_of_added_to_index[i] = false;
+        // make the copy first and then trade with it, so that if copying
+        // fails, this set is left as it was; our old contents are
+        // destroyed along with the copy
+        HashSet copy{s};
+        swap(copy);
     }
-    for (int i = 0; i < cap; ++i)
+    return *this;
+}
+
+
+template <typename ElementType>
+HashSet<ElementType>& HashSet<ElementType>::operator=(HashSet&& s) noexcept
+{
+    if (this != &s)
     {
-        // iterating
-        LinkedListNode* current = s.array_of_LL[i]->next;
-        LinkedListNode* this_node = array_of_LL[i]->next;
+        // steal the expiring set's contents into a temporary, then trade
+        // with it; our old contents are destroyed along with it
+        HashSet stolen{std::move(s)};
+        swap(stolen);
+    }
+    return *this;
+}
 
-        while (current != nullptr)
+
+template <typename ElementType>
+void HashSet<ElementType>::swap(HashSet& s) noexcept
+{
+    std::swap(hashFunction, s.hashFunction);
+    std::swap(array_of_LL, s.array_of_LL);
+    std::swap(cap, s.cap);
+    std::swap(current_sz, s.current_sz);
+    std::swap(occupied_indexes, s.occupied_indexes);
+    std::swap(resize_count, s.resize_count);
+    lookup_count.store(
+        s.lookup_count.exchange(lookup_count.load(std::memory_order_relaxed), std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    probe_count.store(
+        s.probe_count.exchange(probe_count.load(std::memory_order_relaxed), std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    std::swap(spare_nodes, s.spare_nodes);
+    std::swap(shrinks_on_low_load, s.shrinks_on_low_load);
+}
+
+
+template <typename ElementType>
+bool HashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void HashSet<ElementType>::shove_it(const ElementType& element)
+{
+    // hash the element to look for particular index
+    unsigned int index = hashFunction(element) % cap;
+
+    // walk to the end of that index's linked list, bailing out if the
+    // element turns out to be there already
+    LinkedListNode** link = &array_of_LL[index];
+    while (*link != nullptr)
+    {
+        if ((*link)->value == element)
         {
-            this_node = new LinkedListNode{current->value, nullptr};
-            array_of_added_to_index[i] = true;
-            current = current->next;
-            this_node = this_node->next;
-        }   
+            return;
+        }
+        link = &(*link)->next;
+    }
+
+    // only increment load factor if new index
+    if (array_of_LL[index] == nullptr)
+    {
+        occupied_indexes++;
     }
+
+    *link = grab_a_node(element);
+    current_sz++;
 }
 
 
 template <typename ElementType>
-HashSet<ElementType>::HashSet(HashSet&& s) noexcept
-    : hashFunction{impl_::HashSet__undefinedHashFunction<ElementType>},
-    array_of_LL{new LinkedListNode*[s.cap]}, cap{s.cap}, current_sz{s.current_sz}, sz_for_load_factor{s.sz_for_load_factor},
-    array_of_added_to_index{new bool[s.cap]}
+typename HashSet<ElementType>::LinkedListNode* HashSet<ElementType>::grab_a_node(const ElementType& element)
 {
-    // ^^ initializing new
-    // std::cout << "in copy dying" << std::endl;
-    for (int i = 0; i < cap; ++i)
+    if (spare_nodes == nullptr)
     {
-        // setting everything to default
-        array_of_LL[i] = new LinkedListNode{std::move(s.array_of_LL[i]->value)};
-        array_of_LL[i]->next = nullptr;
-        array_of_added_to_index[i] = false;
+        return new LinkedListNode{element, nullptr};
     }
-    for (int i = 0; i < cap; ++i)
-    {
-        // iterating
-        LinkedListNode* current = s.array_of_LL[i]->next;
-        LinkedListNode* this_node = array_of_LL[i]->next;
 
+    // reuse a removed node; assigning over its old value lets an element
+    // like a std::string reuse its old buffer, too
+    LinkedListNode* node = spare_nodes;
+    node->value = element;
+    spare_nodes = node->next;
+    node->next = nullptr;
+    return node;
+}
+
+
+template <typename ElementType>
+void HashSet<ElementType>::rehash_this_foo(unsigned int new_cap)
+{
+    // Making a new hash table, every list empty
+    LinkedListNode** new_hash_table = new LinkedListNode*[new_cap]();
+    unsigned int new_occupied_indexes = 0;
+
+    // move the existing nodes over by relinking them; nothing is
+    // allocated or copied besides the array itself
+    for (unsigned int i = 0; i < cap; ++i)
+    {
+        LinkedListNode* current = array_of_LL[i];
         while (current != nullptr)
         {
-            this_node = new LinkedListNode{std::move(current->value), nullptr};
-            array_of_added_to_index[i] = true;
-            current = current->next;
-            this_node = this_node->next;
+            LinkedListNode* next = current->next;
+            unsigned int index = hashFunction(current->value) % new_cap;
+
+            if (new_hash_table[index] == nullptr)
+            {
+                new_occupied_indexes++;
+            }
+
+            current->next = new_hash_table[index];
+            new_hash_table[index] = current;
+            current = next;
         }
     }
+
+    // Destruct the old array (but not the nodes, which now live in
+    // the new one)
+    delete[] array_of_LL;
+    array_of_LL = new_hash_table;
+    cap = new_cap;
+    occupied_indexes = new_occupied_indexes;
+    resize_count++;
 }
 
 
 template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(const HashSet& s)
+void HashSet<ElementType>::check_for_a_hash_function(const char* operation) const
 {
-    // std::cout << "in assignment" << std::endl;
-    // if right value is not the same reference to current hash's reference
-    // copy over right's value into this value
-    if (this != &s)
+    // only a HashSet that's been moved from can be without one
+    if (!hashFunction)
     {
-        // delete content first
-        delete_this_foos_linked_list();
+        throw SetException{std::string{operation} + " was called on a HashSet that was moved from"};
+    }
+}
 
-        // copying over values
-        hashFunction = s.hashFunction;
-        cap = s.cap;
-        current_sz = s.current_sz;
 
-        // array is new because it was deleted first thing
-        array_of_LL = new LinkedListNode*[cap];
-        array_of_added_to_index = new bool[cap];
-        for (int i = 0; i < cap; ++i)
-        {
-            // initializing
-            array_of_LL[i] = new LinkedListNode{s.array_of_LL[i]->value};
-            array_of_LL[i]->next = nullptr;
-            array_of_added_to_index[i] = false;
-        }
-        for (int i = 0; i < cap; ++i)
-        {
-            // iterating
-            LinkedListNode* current = s.array_of_LL[i]->next;
-            LinkedListNode* this_node = array_of_LL[i]->next;
+template <typename ElementType>
+void HashSet<ElementType>::add(const ElementType& element)
+{
+    check_for_a_hash_function("add()");
 
-            while (current != nullptr)
-            {
-                this_node = new LinkedListNode{current->value, nullptr};
-                array_of_added_to_index[i] = true;
-                current = current->next;
-                this_node = this_node->next;
-            }   
-        }
+    // a HashSet that was moved from has no array until it's needed again
+    if (cap == 0)
+    {
+        rehash_this_foo(DEFAULT_CAPACITY);
+    }
+
+    shove_it(element);
+
+    // once the ratio of size to capacity exceeds 0.8 (compared in whole
+    // numbers, as size * 5 > capacity * 4), DOUBLES THE CAPACITY
+    if (static_cast<unsigned long long>(current_sz) * 5 > static_cast<unsigned long long>(cap) * 4)
+    {
+        rehash_this_foo(cap * 2);
     }
-    return *this;
-    
 }
 
 
 template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(HashSet&& s) noexcept
+bool HashSet<ElementType>::remove(const ElementType& element)
 {
-    // std::cout << "in dying assignment" << std::endl;
-    if (this != &s)
+    if (cap == 0)
     {
-        // delete content first
-        delete_this_foos_linked_list();
+        return false;
+    }
 
-        // copying over values
-        hashFunction = std::move(s.hashFunction);
-        cap = std::move(s.cap);
-        current_sz = std::move(s.current_sz);
+    unsigned int index = hashFunction(element) % cap;
 
-        // array is new because it was deleted first thing
-        array_of_LL = new LinkedListNode*[cap];
-        array_of_added_to_index = new bool[cap];
-        for (int i = 0; i < cap; ++i)
-        {
-            // initializing
-            array_of_LL[i] = new LinkedListNode{std::move(s.array_of_LL[i]->value)};
-            array_of_LL[i]->next = nullptr;
-            array_of_added_to_index[i] = false;
-        }
-        for (int i = 0; i < cap; ++i)
-        {
-            // iterating
-            LinkedListNode* current = s.array_of_LL[i]->next;
-            LinkedListNode* this_node = array_of_LL[i]->next;
+    // find the link that points to the element's node
+    LinkedListNode** link = &array_of_LL[index];
+    while (*link != nullptr && !((*link)->value == element))
+    {
+        link = &(*link)->next;
+    }
 
-            while (current != nullptr)
-            {
-                this_node = new LinkedListNode{std::move(current->value), nullptr};
-                array_of_added_to_index[i] = true;
-                current = current->next;
-                this_node = this_node->next;
-            }
-        }
+    if (*link == nullptr)
+    {
+        return false;
     }
-    return *this;
+
+    // unlink it, and keep it for the next add() to reuse
+    LinkedListNode* removed = *link;
+    *link = removed->next;
+    removed->next = spare_nodes;
+    spare_nodes = removed;
+
+    current_sz--;
+    if (array_of_LL[index] == nullptr)
+    {
+        occupied_indexes--;
+    }
+
+    // once the ratio of size to capacity falls below 0.2 (compared in
+    // whole numbers, as size * 5 < capacity), HALVES THE CAPACITY; the
+    // spare nodes go, too, since they're for a set this size no longer
+    if (shrinks_on_low_load && cap > DEFAULT_CAPACITY
+        && static_cast<unsigned long long>(current_sz) * 5 < cap)
+    {
+        delete_the_spare_nodes();
+        rehash_this_foo(cap / 2 > DEFAULT_CAPACITY ? cap / 2 : DEFAULT_CAPACITY);
+    }
+
+    return true;
 }
 
 
 template <typename ElementType>
-bool HashSet<ElementType>::isImplemented() const noexcept
+void HashSet<ElementType>::setShrinkOnLowLoad(bool shrink) noexcept
 {
-    // std::cout << "in isImplemented" << std::endl;
-    return true;
+    shrinks_on_low_load = shrink;
 }
 
+
 template <typename ElementType>
-void HashSet<ElementType>::shove_it(const ElementType& element)
+void HashSet<ElementType>::shrinkToFit()
 {
-    // std::cout << "in shove_it" << std::endl;
+    delete_the_spare_nodes();
 
-    // hash the element to look for particular index
-    int index = static_cast<int>(hashFunction(element)%cap);
-    // std::cout << "cap " << cap << "index " << index << "lf sz " << sz_for_load_factor << "current sz " << current_sz << std::endl;
-    
-    // Assign an indexed node to look into
-    LinkedListNode* look_in_this_indexed_table = array_of_LL[index];
-    if (array_of_added_to_index[index] == false)
-    {
-        // if the bool is false, make new node with element
-        look_in_this_indexed_table->value = element;
-        // set bool to true
-        array_of_added_to_index[index] = true;
-
-        // increment sizes // only increment load factor if new index
-        current_sz++;
-        sz_for_load_factor++;
-    }
-    else 
-    { 
-        // if the element isn't contained
-        if (contains(element) == false)
-        {
-            // if the next poitner isn't null
-            if (look_in_this_indexed_table->next == nullptr)
-            {
-                // make it a new node
-                look_in_this_indexed_table->next = new LinkedListNode{element, nullptr};
-            }
-            else
-            {
-                // iterate over to find next null
-                while (look_in_this_indexed_table->next != nullptr)
-                {
-                    look_in_this_indexed_table = look_in_this_indexed_table->next;
-                }
-                look_in_this_indexed_table->next = new LinkedListNode{element, nullptr};
+    // the same capacity that reserve() would choose for this many elements
+    unsigned int needed_cap = current_sz + (current_sz + 3) / 4;
+    if (needed_cap < DEFAULT_CAPACITY)
+    {
+        needed_cap = DEFAULT_CAPACITY;
+    }
 
-            }
-            // set bool to true
-            array_of_added_to_index[index] = true;
-            //increment
-            current_sz++;
-        }
+    if (needed_cap < cap)
+    {
+        rehash_this_foo(needed_cap);
+    }
+}
+
+
+template <typename ElementType>
+void HashSet<ElementType>::reserve(unsigned int n)
+{
+    check_for_a_hash_function("reserve()");
+
+    // smallest capacity that keeps n elements at or under a load
+    // factor of 0.8 (i.e., n / cap <= 4 / 5)
+    unsigned int needed_cap = n + (n + 3) / 4;
+
+    if (needed_cap > cap)
+    {
+        rehash_this_foo(needed_cap);
+    }
+}
 
+
+template <typename ElementType>
+bool HashSet<ElementType>::contains(const ElementType& element) const
+{
+    if (cap == 0)
+    {
+        return false;
     }
 
+    // index
+    unsigned int hashed_index = hashFunction(element) % cap;
+    // specifically look in hashed index
+    LinkedListNode* indexed_table = array_of_LL[hashed_index];
+    // iterate to find true, counting the probes locally so that the
+    // shared counters are touched only once per lookup
+    unsigned long long probes = 0;
+    bool found = false;
+    while (indexed_table != nullptr)
+    {
+        probes++;
+        if (indexed_table->value == element)
+        {
+            found = true;
+            break;
+        }
+        indexed_table = indexed_table->next;
+    }
+
+    lookup_count.fetch_add(1, std::memory_order_relaxed);
+    probe_count.fetch_add(probes, std::memory_order_relaxed);
+    return found;
 }
 
 
 template <typename ElementType>
-void HashSet<ElementType>::add(const ElementType& element)
+void HashSet<ElementType>::containsMany(const ElementType* elements, unsigned int n, bool* results) const
 {
-    if ((sz_for_load_factor / cap) >= 0.8)
-    {
-        // old capacity
-        unsigned int old_cap = cap;
-        // new capacity
-        cap = old_cap*2; // DOUBLES THE CAPACITY
-        // new pointer to hash table
-        LinkedListNode** current_hash_table = array_of_LL; // old hash table // delete this
-        bool* current_added_table = array_of_added_to_index; // old bool table // delete this too
-        // Making a new hash table
-        array_of_LL = new LinkedListNode*[cap];
-        // reset sz to 0
-        current_sz = 0;
-        sz_for_load_factor = 0;
-        // Making new bool table
-        array_of_added_to_index = new bool[cap];
-        for (int x = 0; x < cap; ++x)
+    // how many lookups are in flight at once; enough to cover memory
+    // latency without the index array spilling out of registers/L1
+    constexpr unsigned int group_sz = 16;
+    unsigned int indexes[group_sz];
+
+    if (cap == 0)
+    {
+        for (unsigned int i = 0; i < n; ++i)
         {
-            // making all index a new node
-            array_of_LL[x] = new LinkedListNode{};
-            array_of_LL[x]->next = nullptr;
-            array_of_added_to_index[x] = false;
+            results[i] = false;
         }
-        // shoving the old elements into new table
-        for (int i = 0; i < old_cap; ++i)
+        return;
+    }
+
+    for (unsigned int start = 0; start < n; start += group_sz)
+    {
+        unsigned int count = n - start < group_sz ? n - start : group_sz;
+
+        // hash every element in the group and prefetch its array cell
+        for (unsigned int i = 0; i < count; ++i)
         {
-            LinkedListNode* indexed_old = current_hash_table[i];
-            if (current_added_table[i] == true)
-            {
-                while (indexed_old->next != nullptr)
-                {
-                    shove_it(indexed_old->value);
-                    indexed_old = indexed_old->next;
-                }
-            }
+            indexes[i] = hashFunction(elements[start + i]) % cap;
+            impl_::HashSet__prefetch(&array_of_LL[indexes[i]]);
         }
 
-        // shoving the new element in
-        shove_it(element);
-        // Destruct the old
-        for (int i = 0; i < old_cap; ++i)
+        // by now the cells have (mostly) arrived, so prefetch the first
+        // node of each list
+        for (unsigned int i = 0; i < count; ++i)
         {
-            LinkedListNode* current = current_hash_table[i];
-            if (current_added_table[i] == false)
+            LinkedListNode* head = array_of_LL[indexes[i]];
+            if (head != nullptr)
             {
-                delete current;
+                impl_::HashSet__prefetch(head);
             }
-            else
+        }
+
+        // walk the lists, which should mostly hit in cache
+        unsigned long long probes = 0;
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            const ElementType& element = elements[start + i];
+            bool found = false;
+            for (LinkedListNode* current = array_of_LL[indexes[i]]; current != nullptr; current = current->next)
             {
-                while (current->next != nullptr)
+                probes++;
+                if (current->value == element)
                 {
-
-                    LinkedListNode* del = current;
-                    current = current->next;
-                    delete del;
+                    found = true;
+                    break;
                 }
             }
+            results[start + i] = found;
         }
-        delete[] current_added_table;
-        delete[] current_hash_table;
-            
+        probe_count.fetch_add(probes, std::memory_order_relaxed);
     }
-    // regular shove it
-    else
+
+    lookup_count.fetch_add(n, std::memory_order_relaxed);
+}
+
+
+template <typename ElementType>
+unsigned int HashSet<ElementType>::size() const noexcept
+{
+    // return sz counter
+    return current_sz;
+}
+
+
+template <typename ElementType>
+HashSetStats HashSet<ElementType>::stats() const
+{
+    HashSetStats stats{};
+    stats.capacity = cap;
+    stats.size = current_sz;
+    stats.occupiedIndexes = occupied_indexes;
+    stats.resizeCount = resize_count;
+    stats.lookups = lookup_count.load(std::memory_order_relaxed);
+    stats.probes = probe_count.load(std::memory_order_relaxed);
+
+    for (unsigned int i = 0; i < cap; ++i)
     {
-        shove_it(element);
+        unsigned int length = 0;
+        for (LinkedListNode* current = array_of_LL[i]; current != nullptr; current = current->next)
+        {
+            length++;
+        }
+
+        if (length > stats.longestChain)
+        {
+            stats.longestChain = length;
+        }
+
+        if (length < HashSetStats::HISTOGRAM_SIZE)
+        {
+            stats.chainLengthHistogram[length]++;
+        }
+        else
+        {
+            stats.chainLengthHistogram[HashSetStats::HISTOGRAM_SIZE - 1]++;
+        }
     }
+
+    return stats;
 }
 
 
 template <typename ElementType>
-bool HashSet<ElementType>::contains(const ElementType& element) const
+HashSet<ElementType>::const_iterator::const_iterator() noexcept
+    : cells{nullptr}, index{0}, end_index{0}, node{nullptr}
 {
-    // index
-    int hashed_index = static_cast<int>(hashFunction(element)%cap);
-    // specifically look in hashed index
-    LinkedListNode* indexed_table = array_of_LL[hashed_index];
-    LinkedListNode* next;
-    // iterate to find true
-    while (indexed_table != nullptr)
+}
+
+
+template <typename ElementType>
+HashSet<ElementType>::const_iterator::const_iterator(
+    LinkedListNode* const* cells, unsigned int index, unsigned int end_index) noexcept
+    : cells{cells}, index{index}, end_index{end_index}, node{nullptr}
+{
+    skip_empty_indexes();
+}
+
+
+template <typename ElementType>
+void HashSet<ElementType>::const_iterator::skip_empty_indexes() noexcept
+{
+    while (index < end_index && cells[index] == nullptr)
     {
-        if (indexed_table->value == element)
+        ++index;
+    }
+
+    node = index < end_index ? cells[index] : nullptr;
+}
+
+
+template <typename ElementType>
+typename HashSet<ElementType>::const_iterator::reference
+HashSet<ElementType>::const_iterator::operator*() const noexcept
+{
+    return node->value;
+}
+
+
+template <typename ElementType>
+typename HashSet<ElementType>::const_iterator::pointer
+HashSet<ElementType>::const_iterator::operator->() const noexcept
+{
+    return &node->value;
+}
+
+
+template <typename ElementType>
+typename HashSet<ElementType>::const_iterator& HashSet<ElementType>::const_iterator::operator++() noexcept
+{
+    node = node->next;
+
+    // off the end of this list, so on to the next one
+    if (node == nullptr)
+    {
+        ++index;
+        skip_empty_indexes();
+    }
+
+    return *this;
+}
+
+
+template <typename ElementType>
+typename HashSet<ElementType>::const_iterator HashSet<ElementType>::const_iterator::operator++(int) noexcept
+{
+    const_iterator old = *this;
+    ++*this;
+    return old;
+}
+
+
+template <typename ElementType>
+bool HashSet<ElementType>::const_iterator::operator==(const const_iterator& other) const noexcept
+{
+    // every end iterator has a null node, wherever it came from
+    return node == other.node;
+}
+
+
+template <typename ElementType>
+bool HashSet<ElementType>::const_iterator::operator!=(const const_iterator& other) const noexcept
+{
+    return !(*this == other);
+}
+
+
+template <typename ElementType>
+typename HashSet<ElementType>::const_iterator HashSet<ElementType>::begin() const noexcept
+{
+    return const_iterator{array_of_LL, 0, cap};
+}
+
+
+template <typename ElementType>
+typename HashSet<ElementType>::const_iterator HashSet<ElementType>::end() const noexcept
+{
+    return const_iterator{};
+}
+
+
+template <typename ElementType>
+template <typename Function>
+void HashSet<ElementType>::visit_these_indexes(
+    Function& f, unsigned int worker, unsigned int first, unsigned int last) const
+{
+    for (unsigned int i = first; i < last; ++i)
+    {
+        for (LinkedListNode* current = array_of_LL[i]; current != nullptr; current = current->next)
         {
-            return true;
+            f(static_cast<const ElementType&>(current->value), worker);
         }
-        next = indexed_table->next;
-        indexed_table = next;
-        
     }
-    return false;
 }
 
 
 template <typename ElementType>
-unsigned int HashSet<ElementType>::size() const noexcept
+template <typename Function>
+void HashSet<ElementType>::parallelForEach(Function f, unsigned int workers) const
 {
-    // return sz counter
-    return current_sz;
+    if (workers == 0)
+    {
+        workers = std::thread::hardware_concurrency();
+    }
+
+    // more workers than indexes would leave some with nothing to do
+    if (workers > cap)
+    {
+        workers = cap;
+    }
+
+    if (workers <= 1)
+    {
+        visit_these_indexes(f, 0, 0, cap);
+        return;
+    }
+
+    // worker w gets indexes [w * cap / workers, (w + 1) * cap / workers)
+    auto first_index = [this, workers](unsigned int w)
+    {
+        return static_cast<unsigned int>(static_cast<unsigned long long>(w) * cap / workers);
+    };
+
+    std::unique_ptr<std::thread[]> threads;
+    std::unique_ptr<std::exception_ptr[]> failures;
+    try
+    {
+        threads.reset(new std::thread[workers - 1]);
+        failures.reset(new std::exception_ptr[workers]);
+    }
+    catch (const std::bad_alloc&)
+    {
+        // no threads have been started yet, so the calling thread can
+        // just walk the whole array itself, as one worker
+        visit_these_indexes(f, 0, 0, cap);
+        return;
+    }
+
+    // the calling thread walks worker 0's range itself, along with any
+    // range whose thread couldn't be started, for whatever reason; either
+    // way, every thread that was started is joined below
+    unsigned int started = 1;
+    try
+    {
+        for (; started < workers; ++started)
+        {
+            unsigned int w = started;
+            threads[w - 1] = std::thread{
+                [this, &f, &failures, w, first_index]()
+                {
+                    try
+                    {
+                        visit_these_indexes(f, w, first_index(w), first_index(w + 1));
+                    }
+                    catch (...)
+                    {
+                        failures[w] = std::current_exception();
+                    }
+                }};
+        }
+    }
+    catch (...)
+    {
+    }
+
+    for (unsigned int w = 0; w < workers; ++w)
+    {
+        if (w != 0 && w < started)
+        {
+            continue;
+        }
+
+        try
+        {
+            visit_these_indexes(f, w, first_index(w), first_index(w + 1));
+        }
+        catch (...)
+        {
+            failures[w] = std::current_exception();
+        }
+    }
+
+    for (unsigned int w = 1; w < started; ++w)
+    {
+        threads[w - 1].join();
+    }
+
+    for (unsigned int w = 0; w < workers; ++w)
+    {
+        if (failures[w])
+        {
+            std::rethrow_exception(failures[w]);
+        }
+    }
 }
 
 
@@ -510,38 +1166,28 @@ template <typename ElementType>
 unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
 {
     // returns 0 if index is out of range
-    if (index > cap)
+    if (index >= cap)
     {
         return 0;
     }
-    // starts counter
-    else
+
+    unsigned int counter = 0;
+    for (LinkedListNode* current = array_of_LL[index]; current != nullptr; current = current->next)
     {
-        int counter = 0;
-        LinkedListNode* indexed_table = array_of_LL[index];
-        LinkedListNode* next;
-        while (indexed_table->next != nullptr)
-        {
-            // std::cout << indexed_table->value << std::endl;
-            counter++;
-            next = indexed_table->next;
-            indexed_table = next;
-        }
-        // assurance for correct number
-        if (array_of_added_to_index[index] == true)
-        {
-            counter++;
-        }
-        return counter;
+        counter++;
     }
-    return 0;
-    
+    return counter;
 }
 
 
 template <typename ElementType>
 bool HashSet<ElementType>::isElementAtIndex(const ElementType& element, unsigned int index) const
 {
+    if (index >= cap)
+    {
+        return false;
+    }
+
     // iterate to find node at index
     LinkedListNode* indexed_table = array_of_LL[index];
     while (indexed_table != nullptr)
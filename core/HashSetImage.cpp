@@ -0,0 +1,401 @@
+// HashSetImage.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include "HashSetImage.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace
+{
+    const char MAGIC[8] = {'W', 'C', 'H', 'S', 'I', 'M', 'G', '\0'};
+    constexpr unsigned int BYTE_ORDER_CHECK = 0x01020304;
+
+
+    struct ImageHeader
+    {
+        char magic[8];
+        unsigned int version;
+        unsigned int byteOrder;
+        unsigned int bucketCount;
+        unsigned int elementCount;
+        unsigned long long hashFingerprint;
+        unsigned long long stringBytes;
+        unsigned long long payloadBytes;
+        unsigned long long payloadChecksum;
+        unsigned long long headerChecksum;
+    };
+
+    static_assert(sizeof(ImageHeader) == 64, "the image header must be exactly 64 bytes");
+
+
+    // the strings whose hashes make up a hash function's fingerprint
+    const char* const FINGERPRINT_PROBES[] = {
+        "", "A", "THE", "WORDCHECKER", "SET THE CONTROLS FOR THE HEART OF THE SUN"
+    };
+
+
+    unsigned long long fnv1a(const void* data, std::size_t length)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        unsigned long long hash = 14695981039346656037ull;
+
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+
+    unsigned long long headerChecksum(const ImageHeader& header)
+    {
+        return fnv1a(&header, offsetof(ImageHeader, headerChecksum));
+    }
+
+
+    // the counts are 32 bits, so only stringBytes can make this wrap
+    // around; it's checked against the file's size before this is called
+    unsigned long long payloadBytesFor(
+        unsigned long long bucketCount, unsigned long long elementCount,
+        unsigned long long stringBytes)
+    {
+        return (bucketCount + 1) * 4 + elementCount * 8 + stringBytes;
+    }
+
+
+    // checks that the bucket boundaries start at 0, never decrease, and
+    // end at the element count, so that no bucket's entries run outside
+    // the array of entries; this is cheap enough (one pass over the
+    // boundaries) to do even when the checksum isn't being verified
+    bool bucketsAreConsistent(const unsigned int* bucketStart, const ImageHeader& header)
+    {
+        if (bucketStart[0] != 0 || bucketStart[header.bucketCount] != header.elementCount)
+        {
+            return false;
+        }
+
+        for (unsigned int b = 0; b < header.bucketCount; ++b)
+        {
+            if (bucketStart[b] > bucketStart[b + 1])
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    // writes all of the given bytes to the file, returning false if any
+    // of them can't be written
+    bool writeAll(int fd, const char* data, std::size_t length)
+    {
+        while (length > 0)
+        {
+            ssize_t written = ::write(fd, data, length);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            else if (written <= 0)
+            {
+                return false;
+            }
+
+            data += written;
+            length -= static_cast<std::size_t>(written);
+        }
+
+        return true;
+    }
+}
+
+
+unsigned long long HashSetImage::fingerprint(const HashFunction& hashFunction)
+{
+    unsigned long long result = 0;
+    for (const char* probe : FINGERPRINT_PROBES)
+    {
+        result = result * 1000003 ^ hashFunction(probe);
+    }
+    return result;
+}
+
+
+void HashSetImage::writeWords(
+    const std::string& path, const std::vector<std::string>& words,
+    const HashFunction& hashFunction)
+{
+    std::vector<std::string> unique = words;
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+    unsigned long long elementCount = unique.size();
+
+    // the same load factor (at most 0.8) that HashSet keeps
+    unsigned long long bucketCount = elementCount + (elementCount + 3) / 4;
+    if (bucketCount == 0)
+    {
+        bucketCount = 1;
+    }
+
+    unsigned long long stringBytes = 0;
+    for (const std::string& word : unique)
+    {
+        stringBytes += word.size();
+    }
+
+    if (elementCount > 0xffffffffull / 2 || stringBytes > 0xffffffffull)
+    {
+        throw SetException{"too many words to fit in an image"};
+    }
+
+    // counting sort of the words by bucket: count each bucket's words,
+    // turn the counts into starting positions, then place the words
+    std::vector<unsigned int> bucketOf(elementCount);
+    std::vector<unsigned int> bucketStart(bucketCount + 1, 0);
+    for (unsigned long long i = 0; i < elementCount; ++i)
+    {
+        bucketOf[i] = static_cast<unsigned int>(hashFunction(unique[i]) % bucketCount);
+        bucketStart[bucketOf[i] + 1]++;
+    }
+    for (unsigned long long b = 0; b < bucketCount; ++b)
+    {
+        bucketStart[b + 1] += bucketStart[b];
+    }
+
+    std::vector<unsigned int> order(elementCount);
+    std::vector<unsigned int> next(bucketStart.begin(), bucketStart.end() - 1);
+    for (unsigned long long i = 0; i < elementCount; ++i)
+    {
+        order[next[bucketOf[i]]++] = static_cast<unsigned int>(i);
+    }
+
+    // lay out the payload, with each bucket's strings next to each other
+    std::vector<char> payload(payloadBytesFor(bucketCount, elementCount, stringBytes));
+    char* entryArea = payload.data() + (bucketCount + 1) * 4;
+    char* stringArea = entryArea + elementCount * 8;
+
+    std::memcpy(payload.data(), bucketStart.data(), (bucketCount + 1) * 4);
+
+    unsigned int offset = 0;
+    for (unsigned long long i = 0; i < elementCount; ++i)
+    {
+        const std::string& word = unique[order[i]];
+        Entry entry{offset, static_cast<unsigned int>(word.size())};
+
+        std::memcpy(entryArea + i * 8, &entry, sizeof(Entry));
+        std::memcpy(stringArea + offset, word.data(), word.size());
+        offset += entry.length;
+    }
+
+    ImageHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_CHECK;
+    header.bucketCount = static_cast<unsigned int>(bucketCount);
+    header.elementCount = static_cast<unsigned int>(elementCount);
+    header.hashFingerprint = fingerprint(hashFunction);
+    header.stringBytes = stringBytes;
+    header.payloadBytes = payload.size();
+    header.payloadChecksum = fnv1a(payload.data(), payload.size());
+    header.headerChecksum = headerChecksum(header);
+
+    // the temporary file gets a unique name in the same directory (so
+    // that renaming it is atomic), so that two processes writing the same
+    // image at once can't write into each other's temporary file
+    std::string temporaryName = path + ".XXXXXX";
+    std::vector<char> temporaryPath(temporaryName.begin(), temporaryName.end());
+    temporaryPath.push_back('\0');
+
+    int fd = ::mkstemp(temporaryPath.data());
+    if (fd < 0)
+    {
+        throw SetException{"could not create a temporary file for " + path};
+    }
+
+    // mkstemp() makes the file readable only by its owner, but an image
+    // is meant to be shared
+    bool written = ::fchmod(fd, 0644) == 0
+        && writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header))
+        && writeAll(fd, payload.data(), payload.size());
+
+    if (::close(fd) != 0 || !written)
+    {
+        std::remove(temporaryPath.data());
+        throw SetException{"could not write image to " + std::string{temporaryPath.data()}};
+    }
+
+    if (std::rename(temporaryPath.data(), path.c_str()) != 0)
+    {
+        std::remove(temporaryPath.data());
+        throw SetException{"could not move image into place at " + path};
+    }
+}
+
+
+HashSetImage::HashSetImage(const std::string& path, HashFunction hashFunction, bool verifyChecksum)
+    : hashFunction{hashFunction}, mapping{nullptr}, mappingSize{0}
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw SetException{"could not open image " + path};
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<unsigned long long>(info.st_size) < sizeof(ImageHeader))
+    {
+        ::close(fd);
+        throw SetException{path + " is too small to be an image"};
+    }
+
+    mappingSize = static_cast<std::size_t>(info.st_size);
+    mapping = ::mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // the mapping stays valid after the file is closed
+    ::close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        throw SetException{"could not map image " + path};
+    }
+
+    const char* base = static_cast<const char*>(mapping);
+    ImageHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    const char* problem = nullptr;
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        problem = " is not an image";
+    }
+    else if (header.byteOrder != BYTE_ORDER_CHECK)
+    {
+        problem = " was written on a machine with a different byte order";
+    }
+    else if (header.version != VERSION)
+    {
+        problem = " has an unsupported format version";
+    }
+    else if (header.headerChecksum != headerChecksum(header))
+    {
+        problem = " has a corrupted header";
+    }
+    else if (header.bucketCount == 0
+        || header.payloadBytes != mappingSize - sizeof(ImageHeader)
+        || header.stringBytes > header.payloadBytes
+        || header.payloadBytes != payloadBytesFor(header.bucketCount, header.elementCount, header.stringBytes))
+    {
+        problem = " has the wrong size";
+    }
+    else if (!bucketsAreConsistent(reinterpret_cast<const unsigned int*>(base + sizeof(header)), header))
+    {
+        problem = " has inconsistent bucket boundaries";
+    }
+    else if (header.hashFingerprint != fingerprint(hashFunction))
+    {
+        problem = " was written with a different hash function";
+    }
+    else if (verifyChecksum && header.payloadChecksum != fnv1a(base + sizeof(header), header.payloadBytes))
+    {
+        problem = " fails its checksum";
+    }
+
+    if (problem != nullptr)
+    {
+        ::munmap(mapping, mappingSize);
+        throw SetException{path + problem};
+    }
+
+    buckets = header.bucketCount;
+    elements = header.elementCount;
+    bucketStart = reinterpret_cast<const unsigned int*>(base + sizeof(header));
+    entries = reinterpret_cast<const Entry*>(base + sizeof(header) + (buckets + 1ull) * 4);
+    strings = base + sizeof(header) + (buckets + 1ull) * 4 + elements * 8ull;
+    stringBytes = static_cast<std::size_t>(header.stringBytes);
+}
+
+
+HashSetImage::~HashSetImage() noexcept
+{
+    if (mapping != nullptr)
+    {
+        ::munmap(mapping, mappingSize);
+    }
+}
+
+
+HashSetImage::HashSetImage(HashSetImage&& image) noexcept
+    : hashFunction{std::move(image.hashFunction)}, mapping{image.mapping},
+    mappingSize{image.mappingSize}, buckets{image.buckets}, elements{image.elements},
+    bucketStart{image.bucketStart}, entries{image.entries}, strings{image.strings},
+    stringBytes{image.stringBytes}
+{
+    image.mapping = nullptr;
+    image.mappingSize = 0;
+    image.buckets = 0;
+    image.elements = 0;
+}
+
+
+bool HashSetImage::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void HashSetImage::add(const std::string&)
+{
+    throw SetException{"cannot add to a HashSetImage, which is read-only"};
+}
+
+
+bool HashSetImage::contains(const std::string& element) const
+{
+    if (buckets == 0)
+    {
+        return false;
+    }
+
+    unsigned int bucket = hashFunction(element) % buckets;
+
+    for (unsigned int i = bucketStart[bucket]; i < bucketStart[bucket + 1]; ++i)
+    {
+        // an entry that points outside the string data (which only a
+        // damaged file would have) is never read, and so never matches
+        const Entry& entry = entries[i];
+        if (entry.length == element.size()
+            && entry.offset <= stringBytes && entry.length <= stringBytes - entry.offset
+            && std::memcmp(strings + entry.offset, element.data(), element.size()) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+unsigned int HashSetImage::size() const noexcept
+{
+    return elements;
+}
+
+
+unsigned int HashSetImage::bucketCount() const noexcept
+{
+    return buckets;
+}
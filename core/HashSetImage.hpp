@@ -0,0 +1,156 @@
+// HashSetImage.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A HashSetImage is a read-only Set of strings that lives in a file.  The
+// file is laid out like a hash table that's already been built: an array
+// of bucket boundaries, an array of (offset, length) entries, and all of
+// the strings packed together, grouped by bucket.  Nothing in it is a
+// pointer, so the file is simply mapped into memory (with mmap()) and
+// searched where it lies; opening one costs a few page faults rather than
+// an add() per word, and several processes mapping the same file share
+// the same physical memory.
+//
+// The file begins with a fixed-size header:
+//
+//     offset  size  field
+//          0     8  magic: "WCHSIMG" followed by a zero byte
+//          8     4  format version (HashSetImage::VERSION)
+//         12     4  0x01020304, to detect a byte order mismatch
+//         16     4  bucket count (b)
+//         20     4  element count (n)
+//         24     8  fingerprint of the hash function that was used
+//         32     8  total bytes of string data (s)
+//         40     8  total bytes of everything after the header
+//         48     8  FNV-1a checksum of everything after the header
+//         56     8  FNV-1a checksum of the 56 bytes before this one
+//
+// followed by:
+//
+//     (b + 1) 4-byte integers: bucket i's entries are [start[i], start[i + 1])
+//     n 8-byte entries: 4-byte offset into the string data, 4-byte length
+//     s bytes of string data
+//
+// All integers are in the byte order of the machine that wrote the file.
+//
+// Since a hash function can't be stored in a file, the same one has to be
+// given when the image is opened as when it was written.  The header keeps
+// a fingerprint (the hashes of a handful of fixed strings) so that opening
+// an image with a different hash function fails instead of silently
+// giving wrong answers.
+
+#ifndef HASHSETIMAGE_HPP
+#define HASHSETIMAGE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Set.hpp"
+#include "SetException.hpp"
+
+
+
+class HashSetImage : public Set<std::string>
+{
+public:
+    // The version of the file format that this class writes and reads.
+    static constexpr unsigned int VERSION = 1;
+
+    using HashFunction = std::function<unsigned int(const std::string&)>;
+
+public:
+    // write() builds an image containing the strings in the range
+    // [first, last) (ignoring duplicates), placing them into buckets with
+    // the given hash function, and writes it to the file at the given
+    // path.  The file is written under a unique temporary name and then
+    // renamed into place, so a process opening the path never sees a
+    // half-written image, and two processes writing the same path at once
+    // leave one complete image or the other.  Throws a SetException if the
+    // file can't be written.
+    template <typename Iterator>
+    static void write(
+        const std::string& path, Iterator first, Iterator last,
+        HashFunction hashFunction);
+
+    // Opens the image stored in the file at the given path, which must
+    // have been written with the same hash function.  When verifyChecksum
+    // is true, every byte of the file is read to check it against its
+    // checksum; when false, only the header and the bucket boundaries are
+    // checked, which is what makes opening the image nearly free.  (Even
+    // then, a damaged file can make lookups give wrong answers, but it
+    // can't make them read outside the file.)  Throws a SetException if the
+    // file can't be opened, isn't an image, has the wrong version, or
+    // fails its checks.
+    HashSetImage(const std::string& path, HashFunction hashFunction, bool verifyChecksum = true);
+
+    // Unmaps the file.
+    virtual ~HashSetImage() noexcept;
+
+    // A HashSetImage can be moved (the mapping moves with it), but not
+    // copied.
+    HashSetImage(HashSetImage&& image) noexcept;
+    HashSetImage(const HashSetImage&) = delete;
+    HashSetImage& operator=(const HashSetImage&) = delete;
+    HashSetImage& operator=(HashSetImage&&) = delete;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() always throws a SetException, since an image is read-only.
+    virtual void add(const std::string& element) override;
+
+
+    // contains() returns true if the given string is in the image, false
+    // otherwise.  It hashes the string once and compares it only against
+    // the strings in its bucket.
+    virtual bool contains(const std::string& element) const override;
+
+
+    // size() returns the number of strings in the image.
+    virtual unsigned int size() const noexcept override;
+
+
+    // bucketCount() returns the number of buckets in the image.
+    unsigned int bucketCount() const noexcept;
+
+
+private:
+    struct Entry
+    {
+        unsigned int offset;
+        unsigned int length;
+    };
+
+    static void writeWords(
+        const std::string& path, const std::vector<std::string>& words,
+        const HashFunction& hashFunction);
+
+    static unsigned long long fingerprint(const HashFunction& hashFunction);
+
+    HashFunction hashFunction;
+    void* mapping;
+    std::size_t mappingSize;
+    unsigned int buckets;
+    unsigned int elements;
+    const unsigned int* bucketStart;
+    const Entry* entries;
+    const char* strings;
+    std::size_t stringBytes;
+};
+
+
+
+template <typename Iterator>
+void HashSetImage::write(
+    const std::string& path, Iterator first, Iterator last,
+    HashFunction hashFunction)
+{
+    writeWords(path, std::vector<std::string>(first, last), hashFunction);
+}
+
+
+
+#endif // HASHSETIMAGE_HPP
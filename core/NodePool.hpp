@@ -0,0 +1,324 @@
+// NodePool.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A NodePool is where a linked data structure gets its nodes from, instead
+// of calling new once per node.  Nodes are constructed in blocks that each
+// hold many of them side by side, so building a structure of n nodes takes
+// a few dozen allocations rather than n, and nodes created one after
+// another sit next to each other in memory.  The blocks grow in size as
+// the pool does (up to a limit), and reserve() can be used to get one
+// block big enough for a known number of nodes.
+//
+// Individual nodes are never given back; everything is destroyed at once
+// when the pool is cleared or destroyed.  When the nodes don't need their
+// destructors run (e.g., nodes holding ints), that takes time proportional
+// only to the number of blocks.
+
+#ifndef NODEPOOL_HPP
+#define NODEPOOL_HPP
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+
+template <typename NodeType>
+class NodePool
+{
+public:
+    // The number of nodes in the first block, and the most that any block
+    // holds unless reserve() asks for more.
+    static constexpr unsigned int FIRST_BLOCK_CAPACITY = 32;
+    static constexpr unsigned int MAX_BLOCK_CAPACITY = 65536;
+
+public:
+    // Initializes an empty pool.  Nothing is allocated until the first
+    // node is made.
+    NodePool() noexcept;
+
+    // Destroys every node and frees every block.
+    ~NodePool() noexcept;
+
+    // A pool can be moved (pointers to its nodes stay valid, and now
+    // belong to the pool moved into) but not copied.
+    NodePool(NodePool&& pool) noexcept;
+    NodePool& operator=(NodePool&& pool) noexcept;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    void swap(NodePool& pool) noexcept;
+
+
+    // make() constructs a node from the given arguments (with braces, so
+    // that aggregates can be built member by member) and returns a pointer
+    // to it.
+    template <typename... Args>
+    NodeType* make(Args&&... args);
+
+
+    // reserve() makes sure that the next n calls to make() are satisfied
+    // from the same block, one after another in memory.
+    void reserve(unsigned int n);
+
+
+    // splice() moves every node (and block) from the given pool into
+    // this one, without moving or copying the nodes themselves, leaving
+    // the given pool empty.  It takes time proportional to the number of
+    // blocks in the given pool.
+    void splice(NodePool& pool) noexcept;
+
+
+    // clear() destroys every node and frees every block, leaving the pool
+    // as it was when it was constructed.
+    void clear() noexcept;
+
+
+    // size() returns the number of nodes that have been made.
+    unsigned int size() const noexcept;
+
+
+    // bytesAllocated() returns the total size of the blocks.
+    unsigned long long bytesAllocated() const noexcept;
+
+
+    // blockCount() returns the number of blocks, in time proportional to
+    // it.
+    unsigned int blockCount() const noexcept;
+
+
+private:
+    using Slot = typename std::aligned_storage<sizeof(NodeType), alignof(NodeType)>::type;
+
+    struct Block
+    {
+        Block* next;
+        unsigned int capacity;
+        unsigned int used;
+        Slot* slots;
+    };
+
+    // the block nodes are currently being made in, which links to the
+    // ones that filled up before it
+    Block* newest_block;
+    unsigned int next_block_capacity;
+    unsigned int node_count;
+    unsigned long long block_bytes;
+
+    void start_a_new_block(unsigned int capacity);
+    static void destroy_the_nodes(Block* block, std::true_type) noexcept;
+    static void destroy_the_nodes(Block* block, std::false_type) noexcept;
+};
+
+
+
+template <typename NodeType>
+constexpr unsigned int NodePool<NodeType>::FIRST_BLOCK_CAPACITY;
+
+template <typename NodeType>
+constexpr unsigned int NodePool<NodeType>::MAX_BLOCK_CAPACITY;
+
+
+template <typename NodeType>
+NodePool<NodeType>::NodePool() noexcept
+    : newest_block{nullptr}, next_block_capacity{FIRST_BLOCK_CAPACITY}, node_count{0}, block_bytes{0}
+{
+}
+
+
+template <typename NodeType>
+NodePool<NodeType>::~NodePool() noexcept
+{
+    clear();
+}
+
+
+template <typename NodeType>
+NodePool<NodeType>::NodePool(NodePool&& pool) noexcept
+    : newest_block{pool.newest_block}, next_block_capacity{pool.next_block_capacity},
+    node_count{pool.node_count}, block_bytes{pool.block_bytes}
+{
+    pool.newest_block = nullptr;
+    pool.next_block_capacity = FIRST_BLOCK_CAPACITY;
+    pool.node_count = 0;
+    pool.block_bytes = 0;
+}
+
+
+template <typename NodeType>
+NodePool<NodeType>& NodePool<NodeType>::operator=(NodePool&& pool) noexcept
+{
+    if (this != &pool)
+    {
+        NodePool stolen{std::move(pool)};
+        swap(stolen);
+    }
+
+    return *this;
+}
+
+
+template <typename NodeType>
+void NodePool<NodeType>::swap(NodePool& pool) noexcept
+{
+    std::swap(newest_block, pool.newest_block);
+    std::swap(next_block_capacity, pool.next_block_capacity);
+    std::swap(node_count, pool.node_count);
+    std::swap(block_bytes, pool.block_bytes);
+}
+
+
+template <typename NodeType>
+template <typename... Args>
+NodeType* NodePool<NodeType>::make(Args&&... args)
+{
+    if (newest_block == nullptr || newest_block->used == newest_block->capacity)
+    {
+        start_a_new_block(next_block_capacity);
+    }
+
+    // only count the slot as used once the node is successfully built
+    Slot* slot = &newest_block->slots[newest_block->used];
+    NodeType* node = new (slot) NodeType{std::forward<Args>(args)...};
+    newest_block->used++;
+    node_count++;
+    return node;
+}
+
+
+template <typename NodeType>
+void NodePool<NodeType>::reserve(unsigned int n)
+{
+    if (newest_block != nullptr && newest_block->capacity - newest_block->used >= n)
+    {
+        return;
+    }
+
+    // whatever's left of the current block goes unused
+    start_a_new_block(n > next_block_capacity ? n : next_block_capacity);
+}
+
+
+template <typename NodeType>
+void NodePool<NodeType>::start_a_new_block(unsigned int capacity)
+{
+    Slot* slots = new Slot[capacity];
+
+    try
+    {
+        newest_block = new Block{newest_block, capacity, 0, slots};
+    }
+    catch (...)
+    {
+        delete[] slots;
+        throw;
+    }
+
+    block_bytes += sizeof(Block) + static_cast<unsigned long long>(capacity) * sizeof(Slot);
+
+    // each block is twice as big as the last, up to a point
+    if (next_block_capacity < MAX_BLOCK_CAPACITY)
+    {
+        next_block_capacity *= 2;
+    }
+}
+
+
+template <typename NodeType>
+void NodePool<NodeType>::splice(NodePool& pool) noexcept
+{
+    if (this == &pool || pool.newest_block == nullptr)
+    {
+        return;
+    }
+
+    // the other pool's blocks go in front of ours, so its newest block
+    // (which may still have room) is where the next node will be made
+    Block* oldest = pool.newest_block;
+    while (oldest->next != nullptr)
+    {
+        oldest = oldest->next;
+    }
+
+    oldest->next = newest_block;
+    newest_block = pool.newest_block;
+    node_count += pool.node_count;
+    block_bytes += pool.block_bytes;
+    if (pool.next_block_capacity > next_block_capacity)
+    {
+        next_block_capacity = pool.next_block_capacity;
+    }
+
+    pool.newest_block = nullptr;
+    pool.next_block_capacity = FIRST_BLOCK_CAPACITY;
+    pool.node_count = 0;
+    pool.block_bytes = 0;
+}
+
+
+template <typename NodeType>
+void NodePool<NodeType>::destroy_the_nodes(Block*, std::true_type) noexcept
+{
+    // nothing to do; the memory can just be freed
+}
+
+
+template <typename NodeType>
+void NodePool<NodeType>::destroy_the_nodes(Block* block, std::false_type) noexcept
+{
+    for (unsigned int i = 0; i < block->used; ++i)
+    {
+        reinterpret_cast<NodeType*>(&block->slots[i])->~NodeType();
+    }
+}
+
+
+template <typename NodeType>
+void NodePool<NodeType>::clear() noexcept
+{
+    while (newest_block != nullptr)
+    {
+        Block* del = newest_block;
+        newest_block = newest_block->next;
+        destroy_the_nodes(del, typename std::is_trivially_destructible<NodeType>::type{});
+        delete[] del->slots;
+        delete del;
+    }
+
+    next_block_capacity = FIRST_BLOCK_CAPACITY;
+    node_count = 0;
+    block_bytes = 0;
+}
+
+
+template <typename NodeType>
+unsigned int NodePool<NodeType>::size() const noexcept
+{
+    return node_count;
+}
+
+
+template <typename NodeType>
+unsigned long long NodePool<NodeType>::bytesAllocated() const noexcept
+{
+    return block_bytes;
+}
+
+
+template <typename NodeType>
+unsigned int NodePool<NodeType>::blockCount() const noexcept
+{
+    unsigned int count = 0;
+    for (const Block* block = newest_block; block != nullptr; block = block->next)
+    {
+        count++;
+    }
+
+    return count;
+}
+
+
+
+#endif // NODEPOOL_HPP
@@ -0,0 +1,517 @@
+// PackedSkipListSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A PackedSkipListSet is a skip list, like SkipListSet, but laid out the
+// other way that skip lists are commonly built.  Rather than a separate
+// node for every level of an element's "tower" (each with a pointer to the
+// next node on its level and one to the node below it), each element has
+// a single tower: the element itself, followed immediately by an array of
+// "next" pointers, one for each level the element is on.  The pointer for
+// level i leads to the next tower that reaches level i.
+//
+// That costs one pointer per level instead of two, plus one copy of the
+// element instead of one per level, and a search that drops down a level
+// stays in the same tower -- usually in the same cache line -- instead of
+// following a "down" pointer to somewhere else in memory.  The price is
+// that towers are different sizes, so they can't come from a NodePool;
+// instead, they're carved one after another out of large blocks that the
+// set allocates itself, which amounts to the same thing.
+//
+// The -INF is a tower of its own that's tall enough for every level there
+// could ever be, and the +INF is a nullptr "next."  The coin flips, and
+// the cap on the number of levels, are the same as SkipListSet's.
+
+#ifndef PACKEDSKIPLISTSET_HPP
+#define PACKEDSKIPLISTSET_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Set.hpp"
+#include "SkipListSet.hpp"
+
+
+
+template <typename ElementType>
+class PackedSkipListSet : public Set<ElementType>
+{
+public:
+    // Initializes a PackedSkipListSet to be empty, with or without a
+    // "level tester" object that will decide, whenever a "coin flip"
+    // is needed, whether a key should occupy the next level above.
+    PackedSkipListSet();
+    explicit PackedSkipListSet(std::unique_ptr<SkipListLevelTester<ElementType>> levelTester);
+
+    // Cleans up the PackedSkipListSet so that it leaks no memory.
+    virtual ~PackedSkipListSet() noexcept;
+
+    // Initializes a new PackedSkipListSet to be a copy of an existing
+    // one, with every element on the same levels.
+    PackedSkipListSet(const PackedSkipListSet& s);
+
+    // Initializes a new PackedSkipListSet whose contents are moved from an
+    // expiring one.
+    PackedSkipListSet(PackedSkipListSet&& s) noexcept;
+
+    // Assigns an existing PackedSkipListSet into another.
+    PackedSkipListSet& operator=(const PackedSkipListSet& s);
+
+    // Assigns an expiring PackedSkipListSet into another.
+    PackedSkipListSet& operator=(PackedSkipListSet&& s) noexcept;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in an expected
+    // time of O(log n).
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in an expected time of
+    // O(log n).
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // levelCount() returns the number of levels in the skip list.
+    unsigned int levelCount() const noexcept;
+
+
+    // elementsOnLevel() returns the number of elements that are stored
+    // on the given level of the skip list, or 0 if the level doesn't
+    // exist.
+    unsigned int elementsOnLevel(unsigned int level) const noexcept;
+
+
+    // isElementOnLevel() returns true if the given element is on the
+    // given level, false otherwise.
+    bool isElementOnLevel(const ElementType& element, unsigned int level) const;
+
+
+    // swap() exchanges the contents (and level testers) of two
+    // PackedSkipListSets in constant time.
+    void swap(PackedSkipListSet& s) noexcept;
+
+
+private:
+    // A Tower is followed in memory by its "next" pointers, height of
+    // them; see next_pointers_of().
+    struct Tower
+    {
+        ElementType value;
+        unsigned int height;
+    };
+
+    // the blocks that towers are carved out of, each of which links to
+    // the one that filled up before it; the towers start right after
+    // the Block, at BLOCK_HEADER bytes in
+    struct Block
+    {
+        Block* previous;
+    };
+
+    // the cap is 3 * ceil(log2 n), which is never more than this
+    static constexpr unsigned int MAX_LEVELS = 96;
+
+    // every tower starts on a multiple of this, so that both the Tower
+    // and the pointers after it are aligned
+    static constexpr std::size_t TOWER_ALIGNMENT =
+        alignof(Tower) > alignof(Tower*) ? alignof(Tower) : alignof(Tower*);
+
+    static constexpr std::size_t POINTERS_OFFSET =
+        (sizeof(Tower) + alignof(Tower*) - 1) / alignof(Tower*) * alignof(Tower*);
+
+    static constexpr std::size_t BLOCK_HEADER =
+        (sizeof(Block) + TOWER_ALIGNMENT - 1) / TOWER_ALIGNMENT * TOWER_ALIGNMENT;
+
+    static constexpr std::size_t FIRST_BLOCK_BYTES = 4096;
+    static constexpr std::size_t MAX_BLOCK_BYTES = 1 << 20;
+
+    std::unique_ptr<SkipListLevelTester<ElementType>> levelTester;
+    // the -INF's "next" pointers
+    Tower* heads[MAX_LEVELS];
+    unsigned int levels;
+    unsigned int sz;
+    unsigned int level_sizes[MAX_LEVELS];
+
+    Block* newest_block;
+    char* free_space;
+    std::size_t free_bytes;
+    std::size_t next_block_bytes;
+
+    static Tower** next_pointers_of(Tower* tower) noexcept;
+    static Tower* const* next_pointers_of(const Tower* tower) noexcept;
+    Tower* make_a_tower(const ElementType& element, unsigned int height);
+    void copy_this_foo(const PackedSkipListSet& s);
+    void destroy_this_foo() noexcept;
+    void destroy_the_elements(std::true_type) noexcept;
+    void destroy_the_elements(std::false_type) noexcept;
+};
+
+
+
+template <typename ElementType>
+constexpr unsigned int PackedSkipListSet<ElementType>::MAX_LEVELS;
+
+template <typename ElementType>
+constexpr std::size_t PackedSkipListSet<ElementType>::TOWER_ALIGNMENT;
+
+template <typename ElementType>
+constexpr std::size_t PackedSkipListSet<ElementType>::POINTERS_OFFSET;
+
+template <typename ElementType>
+constexpr std::size_t PackedSkipListSet<ElementType>::BLOCK_HEADER;
+
+template <typename ElementType>
+constexpr std::size_t PackedSkipListSet<ElementType>::FIRST_BLOCK_BYTES;
+
+template <typename ElementType>
+constexpr std::size_t PackedSkipListSet<ElementType>::MAX_BLOCK_BYTES;
+
+
+template <typename ElementType>
+PackedSkipListSet<ElementType>::PackedSkipListSet()
+    : PackedSkipListSet{std::make_unique<RandomSkipListLevelTester<ElementType>>()}
+{
+}
+
+
+template <typename ElementType>
+PackedSkipListSet<ElementType>::PackedSkipListSet(std::unique_ptr<SkipListLevelTester<ElementType>> levelTester)
+    : levelTester{std::move(levelTester)}, heads{}, levels{1}, sz{0}, level_sizes{},
+    newest_block{nullptr}, free_space{nullptr}, free_bytes{0}, next_block_bytes{FIRST_BLOCK_BYTES}
+{
+}
+
+
+template <typename ElementType>
+PackedSkipListSet<ElementType>::~PackedSkipListSet() noexcept
+{
+    destroy_this_foo();
+}
+
+
+template <typename ElementType>
+PackedSkipListSet<ElementType>::PackedSkipListSet(const PackedSkipListSet& s)
+    : PackedSkipListSet{s.levelTester != nullptr ? s.levelTester->clone() : nullptr}
+{
+    // if copying an element fails, the destructor cleans up the towers
+    // copied so far, since they're all linked in on level 0
+    copy_this_foo(s);
+}
+
+
+template <typename ElementType>
+PackedSkipListSet<ElementType>::PackedSkipListSet(PackedSkipListSet&& s) noexcept
+    : PackedSkipListSet{nullptr}
+{
+    // the expiring set is left empty, and with no level tester; if it's
+    // ever added to, it gets a random one then
+    swap(s);
+}
+
+
+template <typename ElementType>
+PackedSkipListSet<ElementType>& PackedSkipListSet<ElementType>::operator=(const PackedSkipListSet& s)
+{
+    if (this != &s)
+    {
+        PackedSkipListSet copy{s};
+        swap(copy);
+    }
+
+    return *this;
+}
+
+
+template <typename ElementType>
+PackedSkipListSet<ElementType>& PackedSkipListSet<ElementType>::operator=(PackedSkipListSet&& s) noexcept
+{
+    if (this != &s)
+    {
+        PackedSkipListSet stolen{std::move(s)};
+        swap(stolen);
+    }
+
+    return *this;
+}
+
+
+template <typename ElementType>
+void PackedSkipListSet<ElementType>::swap(PackedSkipListSet& s) noexcept
+{
+    std::swap(levelTester, s.levelTester);
+    std::swap(heads, s.heads);
+    std::swap(levels, s.levels);
+    std::swap(sz, s.sz);
+    std::swap(level_sizes, s.level_sizes);
+    std::swap(newest_block, s.newest_block);
+    std::swap(free_space, s.free_space);
+    std::swap(free_bytes, s.free_bytes);
+    std::swap(next_block_bytes, s.next_block_bytes);
+}
+
+
+template <typename ElementType>
+typename PackedSkipListSet<ElementType>::Tower** PackedSkipListSet<ElementType>::next_pointers_of(Tower* tower) noexcept
+{
+    return reinterpret_cast<Tower**>(reinterpret_cast<char*>(tower) + POINTERS_OFFSET);
+}
+
+
+template <typename ElementType>
+typename PackedSkipListSet<ElementType>::Tower* const* PackedSkipListSet<ElementType>::next_pointers_of(const Tower* tower) noexcept
+{
+    return reinterpret_cast<Tower* const*>(reinterpret_cast<const char*>(tower) + POINTERS_OFFSET);
+}
+
+
+template <typename ElementType>
+typename PackedSkipListSet<ElementType>::Tower* PackedSkipListSet<ElementType>::make_a_tower(
+    const ElementType& element, unsigned int height)
+{
+    std::size_t bytes = POINTERS_OFFSET + height * sizeof(Tower*);
+    bytes = (bytes + TOWER_ALIGNMENT - 1) / TOWER_ALIGNMENT * TOWER_ALIGNMENT;
+
+    if (bytes > free_bytes)
+    {
+        std::size_t block_bytes = BLOCK_HEADER + (bytes > next_block_bytes ? bytes : next_block_bytes);
+        Block* block = static_cast<Block*>(::operator new(block_bytes));
+        block->previous = newest_block;
+
+        newest_block = block;
+        free_space = reinterpret_cast<char*>(block) + BLOCK_HEADER;
+        free_bytes = block_bytes - BLOCK_HEADER;
+
+        if (next_block_bytes < MAX_BLOCK_BYTES)
+        {
+            next_block_bytes *= 2;
+        }
+    }
+
+    // if copying the element fails, its space is simply never used
+    Tower* tower = new (free_space) Tower{element, height};
+    free_space += bytes;
+    free_bytes -= bytes;
+
+    return tower;
+}
+
+
+template <typename ElementType>
+void PackedSkipListSet<ElementType>::copy_this_foo(const PackedSkipListSet& s)
+{
+    // expects this set to be empty.  The towers are copied in order, each
+    // with the same height, so the last tower copied that reaches a level
+    // is the one whose pointer on that level the next one goes into.
+    Tower** last[MAX_LEVELS];
+    for (unsigned int level = 0; level < s.levels; ++level)
+    {
+        last[level] = &heads[level];
+    }
+
+    for (const Tower* original = s.heads[0]; original != nullptr; original = next_pointers_of(original)[0])
+    {
+        Tower* tower = make_a_tower(original->value, original->height);
+        Tower** next = next_pointers_of(tower);
+
+        for (unsigned int level = 0; level < tower->height; ++level)
+        {
+            next[level] = nullptr;
+            *last[level] = tower;
+            last[level] = &next[level];
+        }
+
+        sz++;
+    }
+
+    levels = s.levels;
+    for (unsigned int level = 0; level < s.levels; ++level)
+    {
+        level_sizes[level] = s.level_sizes[level];
+    }
+}
+
+
+template <typename ElementType>
+void PackedSkipListSet<ElementType>::destroy_this_foo() noexcept
+{
+    destroy_the_elements(typename std::is_trivially_destructible<ElementType>::type{});
+
+    while (newest_block != nullptr)
+    {
+        Block* del = newest_block;
+        newest_block = newest_block->previous;
+        ::operator delete(del);
+    }
+}
+
+
+template <typename ElementType>
+void PackedSkipListSet<ElementType>::destroy_the_elements(std::true_type) noexcept
+{
+    // nothing to do; the memory can just be freed
+}
+
+
+template <typename ElementType>
+void PackedSkipListSet<ElementType>::destroy_the_elements(std::false_type) noexcept
+{
+    // every tower is on level 0
+    Tower* tower = heads[0];
+    while (tower != nullptr)
+    {
+        Tower* del = tower;
+        tower = next_pointers_of(tower)[0];
+        del->~Tower();
+    }
+}
+
+
+template <typename ElementType>
+bool PackedSkipListSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void PackedSkipListSet<ElementType>::add(const ElementType& element)
+{
+    // the "next" pointer on each level that the new tower goes after,
+    // which is either the -INF's or that of the last tower before the
+    // element on that level
+    Tower** before[MAX_LEVELS];
+
+    Tower** next = heads;
+    for (unsigned int level = levels; level > 0; --level)
+    {
+        while (next[level - 1] != nullptr && next[level - 1]->value < element)
+        {
+            next = next_pointers_of(next[level - 1]);
+        }
+
+        before[level - 1] = &next[level - 1];
+    }
+
+    if (*before[0] != nullptr && (*before[0])->value == element)
+    {
+        return;
+    }
+
+    if (levelTester == nullptr)
+    {
+        levelTester = std::make_unique<RandomSkipListLevelTester<ElementType>>();
+    }
+
+    unsigned int cap = impl_::SkipListSet__levelCap(sz + 1);
+    unsigned int height = 1;
+    while (height < cap && levelTester->shouldOccupyNextLevel(element))
+    {
+        height++;
+    }
+
+    // the new levels, if any, only become part of the skip list once the
+    // tower is built, so that if building it fails, nothing has changed
+    for (unsigned int level = levels; level < height; ++level)
+    {
+        before[level] = &heads[level];
+    }
+
+    Tower* tower = make_a_tower(element, height);
+
+    for (; levels < height; ++levels)
+    {
+        level_sizes[levels] = 0;
+    }
+
+    Tower** tower_next = next_pointers_of(tower);
+    for (unsigned int level = 0; level < height; ++level)
+    {
+        tower_next[level] = *before[level];
+        *before[level] = tower;
+        level_sizes[level]++;
+    }
+
+    sz++;
+}
+
+
+template <typename ElementType>
+bool PackedSkipListSet<ElementType>::contains(const ElementType& element) const
+{
+    // go right as far as possible without passing the element, then down
+    // within the same tower, until there's no further down to go
+    Tower* const* next = heads;
+    for (unsigned int level = levels; level > 0; --level)
+    {
+        while (next[level - 1] != nullptr && next[level - 1]->value < element)
+        {
+            next = next_pointers_of(next[level - 1]);
+        }
+    }
+
+    return next[0] != nullptr && next[0]->value == element;
+}
+
+
+template <typename ElementType>
+unsigned int PackedSkipListSet<ElementType>::size() const noexcept
+{
+    return sz;
+}
+
+
+template <typename ElementType>
+unsigned int PackedSkipListSet<ElementType>::levelCount() const noexcept
+{
+    return levels;
+}
+
+
+template <typename ElementType>
+unsigned int PackedSkipListSet<ElementType>::elementsOnLevel(unsigned int level) const noexcept
+{
+    return level < levels ? level_sizes[level] : 0;
+}
+
+
+template <typename ElementType>
+bool PackedSkipListSet<ElementType>::isElementOnLevel(const ElementType& element, unsigned int level) const
+{
+    if (level >= levels)
+    {
+        return false;
+    }
+
+    // search as contains() does, but stop on the given level
+    Tower* const* next = heads;
+    for (unsigned int current = levels - 1; current > level; --current)
+    {
+        while (next[current] != nullptr && next[current]->value < element)
+        {
+            next = next_pointers_of(next[current]);
+        }
+    }
+
+    while (next[level] != nullptr && next[level]->value < element)
+    {
+        next = next_pointers_of(next[level]);
+    }
+
+    return next[level] != nullptr && next[level]->value == element;
+}
+
+
+
+#endif // PACKEDSKIPLISTSET_HPP
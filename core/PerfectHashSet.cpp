@@ -0,0 +1,330 @@
+// PerfectHashSet.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include "PerfectHashSet.hpp"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+
+namespace
+{
+    // average number of words per bucket; more words per bucket means
+    // fewer pilots to store, but a longer search for each one
+    constexpr unsigned int WORDS_PER_BUCKET = 5;
+
+    // the ratio of words to positions while searching for pilots
+    constexpr double TABLE_LOAD = 0.98;
+
+    // pilots are stored in 16 bits
+    constexpr unsigned int MAX_PILOT = 65535;
+
+    // how many seeds to try before giving up
+    constexpr unsigned int MAX_ATTEMPTS = 16;
+
+
+    // a 64-bit finalizer (from SplitMix64) that spreads every input bit
+    // across every output bit
+    unsigned long long mix(unsigned long long x) noexcept
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ull;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebull;
+        x ^= x >> 31;
+        return x;
+    }
+
+
+    unsigned long long hashWithSeed(const char* data, std::size_t length, unsigned long long seed) noexcept
+    {
+        unsigned long long hash = 14695981039346656037ull ^ mix(seed);
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return mix(hash);
+    }
+
+
+    // maps a hash onto [0, n) using its upper 32 bits, without dividing
+    unsigned int bucketFor(unsigned long long hash, unsigned int n) noexcept
+    {
+        return static_cast<unsigned int>(((hash >> 32) * n) >> 32);
+    }
+
+
+    unsigned int positionFor(unsigned long long hash, unsigned int pilot, unsigned int n) noexcept
+    {
+        return static_cast<unsigned int>((hash ^ mix(pilot)) % n);
+    }
+}
+
+
+PerfectHashSet::~PerfectHashSet() noexcept
+{
+    delete[] pilots;
+    delete[] moved_positions;
+    delete[] offsets;
+    delete[] arena;
+}
+
+
+PerfectHashSet::PerfectHashSet(PerfectHashSet&& s) noexcept
+    : seed{s.seed}, sz{s.sz}, table_sz{s.table_sz}, bucket_count{s.bucket_count},
+    pilots{s.pilots}, moved_positions{s.moved_positions}, offsets{s.offsets}, arena{s.arena}
+{
+    s.sz = 0;
+    s.table_sz = 0;
+    s.bucket_count = 0;
+    s.pilots = nullptr;
+    s.moved_positions = nullptr;
+    s.offsets = nullptr;
+    s.arena = nullptr;
+}
+
+
+void PerfectHashSet::build(std::vector<std::string> words)
+{
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    if (words.size() > 0x7fffffffu)
+    {
+        throw SetException{"too many words for a PerfectHashSet"};
+    }
+
+    if (words.empty())
+    {
+        return;
+    }
+
+    for (unsigned int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt)
+    {
+        if (tryToBuild(words, mix(attempt + 1)))
+        {
+            return;
+        }
+    }
+
+    throw SetException{"could not find a perfect hash function for these words"};
+}
+
+
+bool PerfectHashSet::tryToBuild(const std::vector<std::string>& words, unsigned long long seed)
+{
+    unsigned int n = static_cast<unsigned int>(words.size());
+    unsigned int m = static_cast<unsigned int>(n / TABLE_LOAD) + 1;
+    unsigned int buckets = (n + WORDS_PER_BUCKET - 1) / WORDS_PER_BUCKET;
+
+    // hash every word and group the words by bucket (a counting sort)
+    std::vector<unsigned long long> hashes(n);
+    std::vector<unsigned int> bucketStart(buckets + 1, 0);
+    for (unsigned int i = 0; i < n; ++i)
+    {
+        hashes[i] = hashWithSeed(words[i].data(), words[i].size(), seed);
+        bucketStart[bucketFor(hashes[i], buckets) + 1]++;
+    }
+    for (unsigned int b = 0; b < buckets; ++b)
+    {
+        bucketStart[b + 1] += bucketStart[b];
+    }
+
+    std::vector<unsigned int> wordsByBucket(n);
+    {
+        std::vector<unsigned int> next(bucketStart.begin(), bucketStart.end() - 1);
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            wordsByBucket[next[bucketFor(hashes[i], buckets)]++] = i;
+        }
+    }
+
+    // largest buckets first, while there's the most room for them
+    std::vector<unsigned int> bucketOrder(buckets);
+    for (unsigned int b = 0; b < buckets; ++b)
+    {
+        bucketOrder[b] = b;
+    }
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(),
+        [&](unsigned int a, unsigned int b) {
+            return bucketStart[a + 1] - bucketStart[a] > bucketStart[b + 1] - bucketStart[b];
+        });
+
+    std::vector<unsigned short> newPilots(buckets, 0);
+    std::vector<unsigned int> wordAt(m, n);
+    std::vector<unsigned int> positions;
+
+    for (unsigned int b : bucketOrder)
+    {
+        unsigned int first = bucketStart[b];
+        unsigned int last = bucketStart[b + 1];
+        if (first == last)
+        {
+            continue;
+        }
+
+        bool placed = false;
+        for (unsigned int pilot = 0; pilot <= MAX_PILOT && !placed; ++pilot)
+        {
+            positions.clear();
+            placed = true;
+
+            for (unsigned int i = first; i < last && placed; ++i)
+            {
+                unsigned int position = positionFor(hashes[wordsByBucket[i]], pilot, m);
+                if (wordAt[position] != n
+                    || std::find(positions.begin(), positions.end(), position) != positions.end())
+                {
+                    placed = false;
+                }
+                positions.push_back(position);
+            }
+
+            if (placed)
+            {
+                newPilots[b] = static_cast<unsigned short>(pilot);
+                for (unsigned int i = first; i < last; ++i)
+                {
+                    wordAt[positions[i - first]] = wordsByBucket[i];
+                }
+            }
+        }
+
+        if (!placed)
+        {
+            // most likely two words whose 64-bit hashes are identical;
+            // a different seed will separate them
+            return false;
+        }
+    }
+
+    // move the words that landed at n or above into the holes below n
+    std::vector<unsigned int> newMovedPositions(m - n);
+    unsigned int hole = 0;
+    for (unsigned int position = n; position < m; ++position)
+    {
+        if (wordAt[position] != n)
+        {
+            while (wordAt[hole] != n)
+            {
+                hole++;
+            }
+            wordAt[hole] = wordAt[position];
+            newMovedPositions[position - n] = hole;
+            hole++;
+        }
+    }
+
+    // pack the words end-to-end in position order
+    unsigned long long arenaBytes = 0;
+    for (const std::string& word : words)
+    {
+        arenaBytes += word.size();
+    }
+    if (arenaBytes > 0xffffffffull)
+    {
+        throw SetException{"too much text for a PerfectHashSet"};
+    }
+
+    // nothing is stored into the set until every array has been
+    // allocated and filled, so if an allocation throws, the ones before
+    // it are freed and the set is left as it was
+    std::unique_ptr<unsigned short[]> builtPilots{new unsigned short[buckets]};
+    std::copy(newPilots.begin(), newPilots.end(), builtPilots.get());
+
+    std::unique_ptr<unsigned int[]> builtMovedPositions{new unsigned int[m - n]};
+    std::copy(newMovedPositions.begin(), newMovedPositions.end(), builtMovedPositions.get());
+
+    std::unique_ptr<unsigned int[]> builtOffsets{new unsigned int[n + 1]};
+    std::unique_ptr<char[]> builtArena{new char[arenaBytes]};
+    unsigned int offset = 0;
+    for (unsigned int position = 0; position < n; ++position)
+    {
+        const std::string& word = words[wordAt[position]];
+        builtOffsets[position] = offset;
+        std::memcpy(builtArena.get() + offset, word.data(), word.size());
+        offset += static_cast<unsigned int>(word.size());
+    }
+    builtOffsets[n] = offset;
+
+    this->seed = seed;
+    sz = n;
+    table_sz = m;
+    bucket_count = buckets;
+    pilots = builtPilots.release();
+    moved_positions = builtMovedPositions.release();
+    offsets = builtOffsets.release();
+    arena = builtArena.release();
+
+    return true;
+}
+
+
+unsigned int PerfectHashSet::positionOf(const std::string& element) const noexcept
+{
+    unsigned long long hash = hashWithSeed(element.data(), element.size(), seed);
+    unsigned int position = positionFor(hash, pilots[bucketFor(hash, bucket_count)], table_sz);
+
+    return position < sz ? position : moved_positions[position - sz];
+}
+
+
+bool PerfectHashSet::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void PerfectHashSet::add(const std::string&)
+{
+    throw SetException{"cannot add to a PerfectHashSet, which is read-only"};
+}
+
+
+bool PerfectHashSet::contains(const std::string& element) const
+{
+    if (sz == 0)
+    {
+        return false;
+    }
+
+    unsigned int position = positionOf(element);
+    unsigned int length = offsets[position + 1] - offsets[position];
+
+    return length == element.size()
+        && std::memcmp(arena + offsets[position], element.data(), length) == 0;
+}
+
+
+unsigned int PerfectHashSet::size() const noexcept
+{
+    return sz;
+}
+
+
+double PerfectHashSet::hashBitsPerElement() const noexcept
+{
+    if (sz == 0)
+    {
+        return 0.0;
+    }
+
+    return (bucket_count * 16.0 + (table_sz - sz) * 32.0) / sz;
+}
+
+
+unsigned long long PerfectHashSet::memoryBytes() const noexcept
+{
+    unsigned long long bytes = sizeof(*this);
+    if (sz > 0)
+    {
+        bytes += bucket_count * sizeof(unsigned short)
+            + (table_sz - sz) * sizeof(unsigned int)
+            + (sz + 1ull) * sizeof(unsigned int)
+            + offsets[sz];
+    }
+    return bytes;
+}
@@ -0,0 +1,117 @@
+// PerfectHashSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A PerfectHashSet is a read-only Set of strings, built once from a fixed
+// list of words, that answers every lookup by looking at exactly one
+// stored string.  It's meant for a dictionary that only changes when it's
+// rebuilt.
+//
+// It's built around a minimal perfect hash function: one that maps each of
+// the n words to a different position in [0, n), with no empty positions
+// and no collisions.  The construction follows PTHash:
+//
+// * Every word is hashed (to 64 bits) and placed into one of about n / 5
+//   buckets according to its hash.
+// * Going through the buckets from largest to smallest, each is given a
+//   "pilot": the first small number p for which every word x in the bucket
+//   lands on a position, (hash(x) XOR mix(p)) mod m, that no other word
+//   has taken yet.  m is a little more than n, which keeps the search for
+//   pilots short even for the last few buckets.
+// * The few words that land on positions n and above are moved down into
+//   the positions below n that were left empty, with a small table saying
+//   where each one went.
+//
+// What's stored, then, is one 16-bit pilot per bucket plus the small
+// table, which comes to about 4 bits per word, and the words themselves,
+// packed end-to-end in one array in the order of their positions.  A
+// lookup hashes the word, finds its bucket's pilot, computes its position,
+// and compares against the one word stored there.
+
+#ifndef PERFECTHASHSET_HPP
+#define PERFECTHASHSET_HPP
+
+#include <string>
+#include <vector>
+#include "Set.hpp"
+#include "SetException.hpp"
+
+
+
+class PerfectHashSet : public Set<std::string>
+{
+public:
+    // Builds a PerfectHashSet containing the strings in the range
+    // [first, last), ignoring duplicates.  Throws a SetException if no
+    // perfect hash function can be found (which, for distinct words, is
+    // vanishingly unlikely).
+    template <typename Iterator>
+    PerfectHashSet(Iterator first, Iterator last);
+
+    // Cleans up the PerfectHashSet so that it leaks no memory.
+    virtual ~PerfectHashSet() noexcept;
+
+    // A PerfectHashSet can be moved, but not copied.
+    PerfectHashSet(PerfectHashSet&& s) noexcept;
+    PerfectHashSet(const PerfectHashSet&) = delete;
+    PerfectHashSet& operator=(const PerfectHashSet&) = delete;
+    PerfectHashSet& operator=(PerfectHashSet&&) = delete;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() always throws a SetException, since a PerfectHashSet can't be
+    // changed once it's built.
+    virtual void add(const std::string& element) override;
+
+
+    // contains() returns true if the given string is in the set, false
+    // otherwise.  It compares against exactly one stored string.
+    virtual bool contains(const std::string& element) const override;
+
+
+    // size() returns the number of strings in the set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // hashBitsPerElement() returns how many bits of memory the perfect
+    // hash function itself uses per element (the pilots and the table of
+    // moved positions, but not the stored strings).
+    double hashBitsPerElement() const noexcept;
+
+
+    // memoryBytes() returns the total number of bytes allocated by the
+    // set, including the stored strings.
+    unsigned long long memoryBytes() const noexcept;
+
+
+private:
+    void build(std::vector<std::string> words);
+    bool tryToBuild(const std::vector<std::string>& words, unsigned long long seed);
+    unsigned int positionOf(const std::string& element) const noexcept;
+
+    unsigned long long seed;
+    unsigned int sz;
+    unsigned int table_sz;
+    unsigned int bucket_count;
+    unsigned short* pilots;
+    unsigned int* moved_positions;
+    unsigned int* offsets;
+    char* arena;
+};
+
+
+
+template <typename Iterator>
+PerfectHashSet::PerfectHashSet(Iterator first, Iterator last)
+    : seed{0}, sz{0}, table_sz{0}, bucket_count{0},
+    pilots{nullptr}, moved_positions{nullptr}, offsets{nullptr}, arena{nullptr}
+{
+    build(std::vector<std::string>(first, last));
+}
+
+
+
+#endif // PERFECTHASHSET_HPP
@@ -0,0 +1,579 @@
+// PersistentAVLSet.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A PersistentAVLSet is an AVL tree whose nodes are never changed once
+// they're part of the tree, so that any number of threads can search it,
+// or hold onto a Snapshot of it, while another thread adds to it, with
+// none of the readers ever taking a lock.
+//
+// * add() copies the nodes on the path from the root down to where the
+//   new element goes (O(log n) of them), balancing the copies as it goes,
+//   and shares every other node with the tree as it was.  The new root is
+//   published with a single atomic store.  Adds are serialized by a mutex,
+//   which readers never touch.
+// * Each node counts how many references there are to it (from parent
+//   nodes, the current root, and Snapshots), and is deleted when the last
+//   of them goes away.
+// * contains() and size() announce themselves in an EpochDomain and load
+//   the root once, so each sees one version of the tree from start to
+//   finish.  A replaced root isn't let go until the EpochDomain says that
+//   no reader can still be looking at it; they're let go in batches, so
+//   that add() doesn't have to wait for readers every time.
+// * snapshot() loads the root the same way and adds a reference to it,
+//   returning a Snapshot: a read-only Set that stays the same no matter
+//   what's added afterward (and even outlives the PersistentAVLSet).  A
+//   WordChecker built around a Snapshot checks every word, and generates
+//   every suggestion, against one consistent version of the dictionary.
+//
+// Unlike AVLSet, the nodes aren't allocated from a NodePool, since they
+// come and go one at a time as versions of the tree are let go.
+
+#ifndef PERSISTENTAVLSET_HPP
+#define PERSISTENTAVLSET_HPP
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+#include "EpochDomain.hpp"
+#include "Set.hpp"
+#include "SetException.hpp"
+
+
+
+template <typename ElementType>
+class PersistentAVLSet : public Set<ElementType>
+{
+private:
+    struct Node;
+
+public:
+    // A Snapshot is one version of a PersistentAVLSet, which can be
+    // searched (from any number of threads) but not added to.  Copying a
+    // Snapshot is cheap, since the copy shares the same nodes.
+    class Snapshot : public Set<ElementType>
+    {
+    public:
+        // An empty Snapshot.
+        Snapshot() noexcept;
+
+        virtual ~Snapshot() noexcept;
+
+        Snapshot(const Snapshot& s) noexcept;
+        Snapshot(Snapshot&& s) noexcept;
+        Snapshot& operator=(const Snapshot& s) noexcept;
+        Snapshot& operator=(Snapshot&& s) noexcept;
+
+        void swap(Snapshot& s) noexcept;
+
+
+        virtual bool isImplemented() const noexcept override;
+
+        // add() always throws a SetException, since a Snapshot can't be
+        // changed.
+        virtual void add(const ElementType& element) override;
+
+        virtual bool contains(const ElementType& element) const override;
+
+        virtual unsigned int size() const noexcept override;
+
+        // height() returns the height of the tree (-1 when it's empty).
+        int height() const noexcept;
+
+    private:
+        friend class PersistentAVLSet;
+
+        // takes over a reference to the given root
+        explicit Snapshot(Node* root) noexcept;
+
+        Node* root;
+    };
+
+public:
+    // Initializes a PersistentAVLSet to be empty.
+    PersistentAVLSet() noexcept;
+
+    // Cleans up the PersistentAVLSet so that it leaks no memory, except for
+    // the nodes still shared with Snapshots, which are deleted along with
+    // the last Snapshot that shares them.  No other thread may be using the
+    // set at the time.
+    virtual ~PersistentAVLSet() noexcept;
+
+    // A PersistentAVLSet is shared by reference among the threads that
+    // use it, so it can't be copied or moved (but Snapshots of it can).
+    PersistentAVLSet(const PersistentAVLSet&) = delete;
+    PersistentAVLSet& operator=(const PersistentAVLSet&) = delete;
+
+
+    virtual bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  It runs in O(log n) time and
+    // makes O(log n) new nodes.  It's safe to call from any number of
+    // threads at once (though only one at a time gets to add), along with
+    // any of the other member functions.
+    virtual void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is in the current
+    // version of the set, false otherwise.  It never waits on a lock.
+    virtual bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the current version of the
+    // set.
+    virtual unsigned int size() const noexcept override;
+
+
+    // snapshot() returns the current version of the set, which will stay
+    // as it is no matter what's added to the set later.  It never waits
+    // on a lock.
+    Snapshot snapshot() const;
+
+
+private:
+    // Once a node is in a published tree, it's never changed again, so
+    // readers can walk it without any synchronization beyond the atomic
+    // load of the root.  The only nodes ever changed are the ones add()
+    // has just made and not yet published.
+    struct Node
+    {
+        ElementType value;
+        Node* left;
+        Node* right;
+        int height;
+        // number of nodes in the subtree rooted here, including this one
+        unsigned int count;
+        std::atomic<unsigned int> references;
+    };
+
+    // no AVL tree with fewer than 2^32 nodes is taller than 45
+    static constexpr unsigned int MAX_DEPTH = 64;
+
+    // how many replaced roots are held onto before waiting for the readers
+    // that might still be looking at them
+    static constexpr unsigned int RETIRED_BATCH = 64;
+
+    std::atomic<Node*> root;
+    std::mutex writer;
+    Node* retired[RETIRED_BATCH];
+    unsigned int retired_count;
+    mutable EpochDomain epochs;
+
+    void retire_this_foo(Node* old_root);
+    void let_go_of_the_retired() noexcept;
+
+    static Node* share(Node* node) noexcept;
+    static void release(Node* node) noexcept;
+    static bool search(const Node* node, const ElementType& element);
+    static int height_of(const Node* node) noexcept;
+    static unsigned int count_of(const Node* node) noexcept;
+    static void update_height_and_count(Node* node) noexcept;
+    static Node* rotate_this_foo_left(Node* node) noexcept;
+    static Node* rotate_this_foo_right(Node* node) noexcept;
+    static Node* rebalance_this_foo(Node* node) noexcept;
+};
+
+
+
+template <typename ElementType>
+constexpr unsigned int PersistentAVLSet<ElementType>::MAX_DEPTH;
+
+template <typename ElementType>
+constexpr unsigned int PersistentAVLSet<ElementType>::RETIRED_BATCH;
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::PersistentAVLSet() noexcept
+    : root{nullptr}, retired_count{0}
+{
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::~PersistentAVLSet() noexcept
+{
+    let_go_of_the_retired();
+    release(root.load());
+}
+
+
+template <typename ElementType>
+bool PersistentAVLSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::add(const ElementType& element)
+{
+    std::lock_guard<std::mutex> lock{writer};
+
+    // only adds change the root, and we're the only add, so nothing more
+    // than a relaxed load is needed here
+    Node* old_root = root.load(std::memory_order_relaxed);
+
+    Node* path[MAX_DEPTH];
+    bool went_left[MAX_DEPTH];
+    unsigned int depth = 0;
+
+    for (Node* current = old_root; current != nullptr; depth++)
+    {
+        path[depth] = current;
+
+        if (element < current->value)
+        {
+            went_left[depth] = true;
+            current = current->left;
+        }
+        else if (current->value < element)
+        {
+            went_left[depth] = false;
+            current = current->right;
+        }
+        else
+        {
+            return;
+        }
+    }
+
+    // build the new path from the bottom up; "fresh" is the new version of
+    // the subtree below the node being copied, and is the only reference
+    // to the new nodes, so letting go of it cleans them all up if copying
+    // an element fails partway
+    Node* fresh = new Node{element, nullptr, nullptr, 0, 1, {1}};
+
+    while (depth > 0)
+    {
+        depth--;
+        Node* original = path[depth];
+
+        Node* copy;
+        try
+        {
+            copy = new Node{original->value, nullptr, nullptr, 0, 1, {1}};
+        }
+        catch (...)
+        {
+            release(fresh);
+            throw;
+        }
+
+        if (went_left[depth])
+        {
+            copy->left = fresh;
+            copy->right = share(original->right);
+        }
+        else
+        {
+            copy->left = share(original->left);
+            copy->right = fresh;
+        }
+
+        fresh = rebalance_this_foo(copy);
+    }
+
+    // the new nodes are all built before the release store makes them
+    // visible to readers
+    root.store(fresh, std::memory_order_release);
+
+    if (old_root != nullptr)
+    {
+        retire_this_foo(old_root);
+    }
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::retire_this_foo(Node* old_root)
+{
+    retired[retired_count] = old_root;
+    retired_count++;
+
+    if (retired_count == RETIRED_BATCH)
+    {
+        // wait out every reader that might have loaded one of these roots
+        // (or anything below them) before letting go of them
+        epochs.synchronize();
+        let_go_of_the_retired();
+    }
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::let_go_of_the_retired() noexcept
+{
+    for (unsigned int i = 0; i < retired_count; ++i)
+    {
+        release(retired[i]);
+    }
+
+    retired_count = 0;
+}
+
+
+template <typename ElementType>
+bool PersistentAVLSet<ElementType>::contains(const ElementType& element) const
+{
+    EpochDomain::ReadGuard guard{epochs};
+    return search(root.load(std::memory_order_acquire), element);
+}
+
+
+template <typename ElementType>
+unsigned int PersistentAVLSet<ElementType>::size() const noexcept
+{
+    EpochDomain::ReadGuard guard{epochs};
+    return count_of(root.load(std::memory_order_acquire));
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Snapshot PersistentAVLSet<ElementType>::snapshot() const
+{
+    // the root can't be let go of while we're in the guard, so it's safe
+    // to add a reference to it, which keeps it around after we leave
+    EpochDomain::ReadGuard guard{epochs};
+    return Snapshot{share(root.load(std::memory_order_acquire))};
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::share(Node* node) noexcept
+{
+    if (node != nullptr)
+    {
+        node->references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return node;
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::release(Node* node) noexcept
+{
+    // when the last reference to a node goes away, so do its references
+    // to its children; this recurses to the left and loops to the right,
+    // so it goes no deeper than the height of the tree
+    while (node != nullptr && node->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        release(node->left);
+        Node* right = node->right;
+        delete node;
+        node = right;
+    }
+}
+
+
+template <typename ElementType>
+bool PersistentAVLSet<ElementType>::search(const Node* node, const ElementType& element)
+{
+    while (node != nullptr)
+    {
+        if (element < node->value)
+        {
+            node = node->left;
+        }
+        else if (node->value < element)
+        {
+            node = node->right;
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+template <typename ElementType>
+int PersistentAVLSet<ElementType>::height_of(const Node* node) noexcept
+{
+    return node == nullptr ? -1 : node->height;
+}
+
+
+template <typename ElementType>
+unsigned int PersistentAVLSet<ElementType>::count_of(const Node* node) noexcept
+{
+    return node == nullptr ? 0 : node->count;
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::update_height_and_count(Node* node) noexcept
+{
+    int left_height = height_of(node->left);
+    int right_height = height_of(node->right);
+    node->height = (left_height > right_height ? left_height : right_height) + 1;
+    node->count = count_of(node->left) + count_of(node->right) + 1;
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::rotate_this_foo_left(Node* node) noexcept
+{
+    Node* right = node->right;
+    node->right = right->left;
+    right->left = node;
+    update_height_and_count(node);
+    update_height_and_count(right);
+    return right;
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::rotate_this_foo_right(Node* node) noexcept
+{
+    Node* left = node->left;
+    node->left = left->right;
+    left->right = node;
+    update_height_and_count(node);
+    update_height_and_count(left);
+    return left;
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Node* PersistentAVLSet<ElementType>::rebalance_this_foo(Node* node) noexcept
+{
+    // Rotations change the nodes they move, which is only allowed for
+    // nodes that add() has just made.  After an add, every node that a
+    // rotation moves is on the path down to the new element (a subtree is
+    // only too tall on the side the element went into), so they're all new
+    // copies; the subtrees hanging off of them are only relinked, never
+    // changed, so they can still be shared.
+    update_height_and_count(node);
+    int balance = height_of(node->left) - height_of(node->right);
+
+    if (balance > 1)
+    {
+        if (height_of(node->left->left) < height_of(node->left->right))
+        {
+            node->left = rotate_this_foo_left(node->left);
+        }
+
+        return rotate_this_foo_right(node);
+    }
+    else if (balance < -1)
+    {
+        if (height_of(node->right->right) < height_of(node->right->left))
+        {
+            node->right = rotate_this_foo_right(node->right);
+        }
+
+        return rotate_this_foo_left(node);
+    }
+
+    return node;
+}
+
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::Snapshot::Snapshot() noexcept
+    : root{nullptr}
+{
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::Snapshot::Snapshot(Node* root) noexcept
+    : root{root}
+{
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::Snapshot::~Snapshot() noexcept
+{
+    release(root);
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::Snapshot::Snapshot(const Snapshot& s) noexcept
+    : root{share(s.root)}
+{
+}
+
+
+template <typename ElementType>
+PersistentAVLSet<ElementType>::Snapshot::Snapshot(Snapshot&& s) noexcept
+    : root{s.root}
+{
+    s.root = nullptr;
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Snapshot&
+PersistentAVLSet<ElementType>::Snapshot::operator=(const Snapshot& s) noexcept
+{
+    Snapshot copy{s};
+    swap(copy);
+    return *this;
+}
+
+
+template <typename ElementType>
+typename PersistentAVLSet<ElementType>::Snapshot&
+PersistentAVLSet<ElementType>::Snapshot::operator=(Snapshot&& s) noexcept
+{
+    Snapshot stolen{std::move(s)};
+    swap(stolen);
+    return *this;
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::Snapshot::swap(Snapshot& s) noexcept
+{
+    std::swap(root, s.root);
+}
+
+
+template <typename ElementType>
+bool PersistentAVLSet<ElementType>::Snapshot::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void PersistentAVLSet<ElementType>::Snapshot::add(const ElementType&)
+{
+    throw SetException{"cannot add to a snapshot of a PersistentAVLSet"};
+}
+
+
+template <typename ElementType>
+bool PersistentAVLSet<ElementType>::Snapshot::contains(const ElementType& element) const
+{
+    // the snapshot's reference keeps every node in it alive
+    return search(root, element);
+}
+
+
+template <typename ElementType>
+unsigned int PersistentAVLSet<ElementType>::Snapshot::size() const noexcept
+{
+    return count_of(root);
+}
+
+
+template <typename ElementType>
+int PersistentAVLSet<ElementType>::Snapshot::height() const noexcept
+{
+    return height_of(root);
+}
+
+
+
+#endif // PERSISTENTAVLSET_HPP
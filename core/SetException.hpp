@@ -0,0 +1,36 @@
+// SetException.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A SetException is thrown when a Set can't do what's been asked of it:
+// for example, when a read-only Set is asked to add an element, or when
+// a Set stored in a file can't be loaded.
+
+#ifndef SETEXCEPTION_HPP
+#define SETEXCEPTION_HPP
+
+#include <string>
+
+
+
+class SetException
+{
+public:
+    explicit SetException(const std::string& reason)
+        : reasonText{reason}
+    {
+    }
+
+    const std::string& reason() const noexcept
+    {
+        return reasonText;
+    }
+
+private:
+    std::string reasonText;
+};
+
+
+
+#endif // SETEXCEPTION_HPP
@@ -4,7 +4,12 @@
 // Project #3: Set the Controls for the Heart of the Sun
 //
 // A SkipListSet is an implementation of a Set that is a skip list, implemented
-// as we discussed in lecture.  A skip list is a sequence of levels
+// as we discussed in lecture.  A skip list is a sequence of levels, each of
+// which is a sorted linked list that begins with -INF and ends with +INF.
+// Every element is on level 0; each element on a level is also on the next
+// level up when a "coin flip" says so, so each level has about half as many
+// elements as the one below it, and a search can skip over most of each
+// level by dropping down from the one above.
 //
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::set, std::map, or std::vector) to store the keys and their
@@ -20,12 +25,25 @@
 // A couple of utilities are included here: SkipListKind and SkipListKey.
 // You can feel free to use these as-is and probably will not need to
 // modify them, though you can make changes to them, if you'd like.
+//
+// The nodes come from a NodePool owned by the set, like AVLSet's, so
+// adding an element costs an allocation only every so often, rather than
+// one per level of its tower, and nodes added one after another sit next
+// to each other in memory.  Elements are never removed, so the pool never
+// needs to take a node back.
+//
+// The number of levels is capped, so that an unlucky run of coin flips
+// can't make the skip list much taller than it needs to be: with n
+// elements, there are at most 12 levels when n <= 16, and otherwise at
+// most 3 * ceil(log2 n).
 
 #ifndef SKIPLISTSET_HPP
 #define SKIPLISTSET_HPP
 
 #include <memory>
 #include <random>
+#include <utility>
+#include "NodePool.hpp"
 #include "Set.hpp"
 
 
@@ -168,6 +186,29 @@ std::unique_ptr<SkipListLevelTester<ElementType>> RandomSkipListLevelTester<Elem
 
 
 
+namespace impl_
+{
+    // the most levels a skip list of n elements is allowed to have: 12
+    // when n <= 16, and 3 * ceil(log2 n) otherwise (never more than 96)
+    inline unsigned int SkipListSet__levelCap(unsigned int n) noexcept
+    {
+        if (n <= 16)
+        {
+            return 12;
+        }
+
+        unsigned int log = 0;
+        while (log < 32 && (1ull << log) < n)
+        {
+            log++;
+        }
+
+        return 3 * log;
+    }
+}
+
+
+
 template <typename ElementType>
 class SkipListSet : public Set<ElementType>
 {
@@ -214,6 +255,20 @@ public:
     virtual bool contains(const ElementType& element) const override;
 
 
+    // containsSorted() looks up the elements in the range [first, last),
+    // storing whether the ith of them is in the set into results[i].  The
+    // answers are the same as calling contains() on each element, but when
+    // the elements are in ascending order, each search begins where the
+    // previous one left off (at a "finger") instead of at the top-left
+    // -INF: it climbs only as high as it needs to in order to skip past
+    // the elements in between, so looking up an element d positions past
+    // the previous one takes an expected time of O(log d) rather than
+    // O(log n).  An element smaller than the one before it is allowed, but
+    // its search starts over from the -INFs.
+    template <typename Iterator>
+    void containsSorted(Iterator first, Iterator last, bool* results) const;
+
+
     // size() returns the number of elements in the set.
     virtual unsigned int size() const noexcept override;
 
@@ -237,12 +292,46 @@ public:
     bool isElementOnLevel(const ElementType& element, unsigned int level) const;
 
 
+    // swap() exchanges the contents (and level testers) of two
+    // SkipListSets in constant time.
+    void swap(SkipListSet& s) noexcept;
+
+
 private:
+    // Each node is one level of one element's "tower," with a pointer to
+    // the node after it on the same level and one to the node for the
+    // same key on the level below.
+    struct Node
+    {
+        SkipListKey<ElementType> key;
+        Node* next;
+        Node* down;
+    };
+
+    // the cap is 3 * ceil(log2 n), which is never more than this
+    static constexpr unsigned int MAX_LEVELS = 96;
+
     std::unique_ptr<SkipListLevelTester<ElementType>> levelTester;
+    NodePool<Node> nodes;
+    // the -INF and +INF at the beginning and end of the top level, or
+    // nullptr if nothing has been added yet (in which case there's
+    // nothing to search, though there's still considered to be one level)
+    Node* top_head;
+    Node* top_tail;
+    unsigned int levels;
+    unsigned int sz;
+    unsigned int level_sizes[MAX_LEVELS];
+
+    void copy_this_foo(const SkipListSet& s);
+    void add_a_level_on_top();
 };
 
 
 
+template <typename ElementType>
+constexpr unsigned int SkipListSet<ElementType>::MAX_LEVELS;
+
+
 template <typename ElementType>
 SkipListSet<ElementType>::SkipListSet()
     : SkipListSet{std::make_unique<RandomSkipListLevelTester<ElementType>>()}
@@ -252,7 +341,7 @@ SkipListSet<ElementType>::SkipListSet()
 
 template <typename ElementType>
 SkipListSet<ElementType>::SkipListSet(std::unique_ptr<SkipListLevelTester<ElementType>> levelTester)
-    : levelTester{std::move(levelTester)}
+    : levelTester{std::move(levelTester)}, top_head{nullptr}, top_tail{nullptr}, levels{1}, sz{0}, level_sizes{}
 {
 }
 
@@ -260,24 +349,37 @@ SkipListSet<ElementType>::SkipListSet(std::unique_ptr<SkipListLevelTester<Elemen
 template <typename ElementType>
 SkipListSet<ElementType>::~SkipListSet() noexcept
 {
+    // the pool frees every node
 }
 
 
 template <typename ElementType>
 SkipListSet<ElementType>::SkipListSet(const SkipListSet& s)
+    : SkipListSet{s.levelTester != nullptr ? s.levelTester->clone() : nullptr}
 {
+    copy_this_foo(s);
 }
 
 
 template <typename ElementType>
 SkipListSet<ElementType>::SkipListSet(SkipListSet&& s) noexcept
+    : SkipListSet{nullptr}
 {
+    // the expiring set is left empty, and with no level tester; if it's
+    // ever added to, it gets a random one then
+    swap(s);
 }
 
 
 template <typename ElementType>
 SkipListSet<ElementType>& SkipListSet<ElementType>::operator=(const SkipListSet& s)
 {
+    if (this != &s)
+    {
+        SkipListSet copy{s};
+        swap(copy);
+    }
+
     return *this;
 }
 
@@ -285,55 +387,357 @@ SkipListSet<ElementType>& SkipListSet<ElementType>::operator=(const SkipListSet&
 template <typename ElementType>
 SkipListSet<ElementType>& SkipListSet<ElementType>::operator=(SkipListSet&& s) noexcept
 {
+    if (this != &s)
+    {
+        SkipListSet stolen{std::move(s)};
+        swap(stolen);
+    }
+
     return *this;
 }
 
 
+template <typename ElementType>
+void SkipListSet<ElementType>::swap(SkipListSet& s) noexcept
+{
+    std::swap(levelTester, s.levelTester);
+    nodes.swap(s.nodes);
+    std::swap(top_head, s.top_head);
+    std::swap(top_tail, s.top_tail);
+    std::swap(levels, s.levels);
+    std::swap(sz, s.sz);
+    std::swap(level_sizes, s.level_sizes);
+}
+
+
+template <typename ElementType>
+void SkipListSet<ElementType>::copy_this_foo(const SkipListSet& s)
+{
+    // expects this set to be empty
+    if (s.top_head == nullptr)
+    {
+        return;
+    }
+
+    // two sentinels on every level, plus every element's tower
+    unsigned int node_count = 2 * s.levels;
+    for (unsigned int level = 0; level < s.levels; ++level)
+    {
+        node_count += s.level_sizes[level];
+    }
+    nodes.reserve(node_count);
+
+    // find the -INF on every level of the original, from the bottom up
+    const Node* heads[MAX_LEVELS];
+    const Node* head = s.top_head;
+    for (unsigned int level = s.levels; level > 0; --level)
+    {
+        heads[level - 1] = head;
+        head = head->down;
+    }
+
+    // copy the levels from the bottom up; the nodes on each level point
+    // down to nodes on the level below, which is walked alongside the
+    // original's, since both have the same keys in the same order
+    Node* below_head = nullptr;
+    Node* below_tail = nullptr;
+
+    for (unsigned int level = 0; level < s.levels; ++level)
+    {
+        Node* new_head = nodes.make(heads[level]->key, nullptr, below_head);
+        Node* previous = new_head;
+
+        const Node* original_below = level > 0 ? heads[level - 1] : nullptr;
+        Node* copy_below = below_head;
+
+        for (const Node* original = heads[level]->next; original->next != nullptr; original = original->next)
+        {
+            Node* down = nullptr;
+            if (level > 0)
+            {
+                while (original_below != original->down)
+                {
+                    original_below = original_below->next;
+                    copy_below = copy_below->next;
+                }
+                down = copy_below;
+            }
+
+            previous->next = nodes.make(original->key, nullptr, down);
+            previous = previous->next;
+        }
+
+        Node* new_tail = nodes.make(SkipListKey<ElementType>{SkipListKind::PosInf, ElementType{}}, nullptr, below_tail);
+        previous->next = new_tail;
+
+        below_head = new_head;
+        below_tail = new_tail;
+    }
+
+    top_head = below_head;
+    top_tail = below_tail;
+    levels = s.levels;
+    sz = s.sz;
+    for (unsigned int level = 0; level < s.levels; ++level)
+    {
+        level_sizes[level] = s.level_sizes[level];
+    }
+}
+
+
 template <typename ElementType>
 bool SkipListSet<ElementType>::isImplemented() const noexcept
 {
-    return false;
+    return true;
 }
 
 
 template <typename ElementType>
 void SkipListSet<ElementType>::add(const ElementType& element)
 {
+    SkipListKey<ElementType> key{SkipListKind::Normal, element};
+
+    // the last node before the element on each level, from the top down
+    Node* before[MAX_LEVELS];
+
+    if (top_head != nullptr)
+    {
+        Node* node = top_head;
+        for (unsigned int level = levels; level > 0; --level)
+        {
+            while (node->next->key < key)
+            {
+                node = node->next;
+            }
+
+            before[level - 1] = node;
+            node = node->down;
+        }
+
+        if (before[0]->next->key == key)
+        {
+            return;
+        }
+    }
+
+    if (levelTester == nullptr)
+    {
+        levelTester = std::make_unique<RandomSkipListLevelTester<ElementType>>();
+    }
+
+    // flip the coins before changing anything
+    unsigned int cap = impl_::SkipListSet__levelCap(sz + 1);
+    unsigned int height = 1;
+    while (height < cap && levelTester->shouldOccupyNextLevel(element))
+    {
+        height++;
+    }
+
+    // every node this takes comes from the same block, so running out of
+    // memory can only happen before anything has been linked in
+    unsigned int new_levels = top_head == nullptr ? height : (height > levels ? height - levels : 0);
+    nodes.reserve(height + 2 * new_levels);
+
+    if (top_head == nullptr)
+    {
+        levels = 0;
+    }
+
+    while (levels < height)
+    {
+        add_a_level_on_top();
+        before[levels - 1] = top_head;
+    }
+
+    // link in the tower from the bottom up, so that if copying the key
+    // fails partway, what's been linked in so far is a shorter tower
+    Node* below = nullptr;
+    for (unsigned int level = 0; level < height; ++level)
+    {
+        Node* node = nodes.make(key, before[level]->next, below);
+        before[level]->next = node;
+        level_sizes[level]++;
+        below = node;
+
+        if (level == 0)
+        {
+            sz++;
+        }
+    }
+}
+
+
+template <typename ElementType>
+void SkipListSet<ElementType>::add_a_level_on_top()
+{
+    Node* tail = nodes.make(SkipListKey<ElementType>{SkipListKind::PosInf, ElementType{}}, nullptr, top_tail);
+    Node* head = nodes.make(SkipListKey<ElementType>{SkipListKind::NegInf, ElementType{}}, tail, top_head);
+
+    top_head = head;
+    top_tail = tail;
+    level_sizes[levels] = 0;
+    levels++;
 }
 
 
 template <typename ElementType>
 bool SkipListSet<ElementType>::contains(const ElementType& element) const
 {
-    return false;
+    if (top_head == nullptr)
+    {
+        return false;
+    }
+
+    SkipListKey<ElementType> key{SkipListKind::Normal, element};
+
+    // go right as far as possible without passing the element, then down,
+    // until there's no further down to go
+    const Node* node = top_head;
+    while (true)
+    {
+        while (node->next->key < key)
+        {
+            node = node->next;
+        }
+
+        if (node->down == nullptr)
+        {
+            return node->next->key == key;
+        }
+
+        node = node->down;
+    }
+}
+
+
+template <typename ElementType>
+template <typename Iterator>
+void SkipListSet<ElementType>::containsSorted(Iterator first, Iterator last, bool* results) const
+{
+    if (top_head == nullptr)
+    {
+        for (; first != last; ++first)
+        {
+            *results++ = false;
+        }
+        return;
+    }
+
+    // the finger: the last node before the previous element on each
+    // level, which starts out as every level's -INF.  A node that's on a
+    // level is on every level below it, so finger[level] is never after
+    // finger[level - 1], and as long as finger[0] is before the next
+    // element, every one of them is a valid place to search from (and
+    // the levels a search doesn't reach still hold the last node before
+    // the element it searched for).
+    const Node* heads[MAX_LEVELS];
+    const Node* finger[MAX_LEVELS];
+
+    const Node* head = top_head;
+    for (unsigned int level = levels; level > 0; --level)
+    {
+        heads[level - 1] = head;
+        finger[level - 1] = head;
+        head = head->down;
+    }
+
+    for (; first != last; ++first)
+    {
+        SkipListKey<ElementType> key{SkipListKind::Normal, *first};
+
+        if (!(finger[0]->key < key))
+        {
+            for (unsigned int level = 0; level < levels; ++level)
+            {
+                finger[level] = heads[level];
+            }
+        }
+
+        // climb as long as the level above also has something to skip
+        // over; once a level doesn't, none above it does either
+        unsigned int level = 0;
+        while (level + 1 < levels && finger[level + 1]->next->key < key)
+        {
+            level++;
+        }
+
+        // then search down from there, as contains() does.  Once the
+        // search has moved past a node on some level, it's after the
+        // finger on every level below, so dropping down is a better place
+        // to start; until then, the finger is.
+        const Node* node = finger[level];
+        bool moved = false;
+        while (true)
+        {
+            while (node->next->key < key)
+            {
+                node = node->next;
+                moved = true;
+            }
+
+            finger[level] = node;
+
+            if (level == 0)
+            {
+                break;
+            }
+
+            level--;
+            node = moved ? node->down : finger[level];
+        }
+
+        *results++ = node->next->key == key;
+    }
 }
 
 
 template <typename ElementType>
 unsigned int SkipListSet<ElementType>::size() const noexcept
 {
-    return 0;
+    return sz;
 }
 
 
 template <typename ElementType>
 unsigned int SkipListSet<ElementType>::levelCount() const noexcept
 {
-    return 0;
+    return levels;
 }
 
 
 template <typename ElementType>
 unsigned int SkipListSet<ElementType>::elementsOnLevel(unsigned int level) const noexcept
 {
-    return 0;
+    return top_head != nullptr && level < levels ? level_sizes[level] : 0;
 }
 
 
 template <typename ElementType>
 bool SkipListSet<ElementType>::isElementOnLevel(const ElementType& element, unsigned int level) const
 {
-    return false;
+    if (top_head == nullptr || level >= levels)
+    {
+        return false;
+    }
+
+    SkipListKey<ElementType> key{SkipListKind::Normal, element};
+
+    // search as contains() does, but stop on the given level
+    const Node* node = top_head;
+    for (unsigned int current = levels - 1; ; --current)
+    {
+        while (node->next->key < key)
+        {
+            node = node->next;
+        }
+
+        if (current == level)
+        {
+            return node->next->key == key;
+        }
+
+        node = node->down;
+    }
 }
 
 
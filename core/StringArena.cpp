@@ -0,0 +1,157 @@
+// StringArena.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include "StringArena.hpp"
+#include <cstring>
+
+
+ArenaString::ArenaString(const char* chars, unsigned int length) noexcept
+    : chars{chars}, length{length}
+{
+}
+
+
+ArenaString ArenaString::viewOf(const std::string& s) noexcept
+{
+    return ArenaString{s.data(), static_cast<unsigned int>(s.size())};
+}
+
+
+const char* ArenaString::data() const noexcept
+{
+    return chars;
+}
+
+
+unsigned int ArenaString::size() const noexcept
+{
+    return length;
+}
+
+
+std::string ArenaString::str() const
+{
+    return std::string(chars, length);
+}
+
+
+bool ArenaString::operator==(const ArenaString& other) const noexcept
+{
+    return length == other.length
+        && (chars == other.chars || std::memcmp(chars, other.chars, length) == 0);
+}
+
+
+bool ArenaString::operator!=(const ArenaString& other) const noexcept
+{
+    return !(*this == other);
+}
+
+
+bool ArenaString::operator<(const ArenaString& other) const noexcept
+{
+    // the same ordering as std::string: by characters (compared as
+    // unsigned), then by length when one is a prefix of the other
+    unsigned int shorter = length < other.length ? length : other.length;
+    int comparison = shorter == 0 ? 0 : std::memcmp(chars, other.chars, shorter);
+
+    return comparison < 0 || (comparison == 0 && length < other.length);
+}
+
+
+bool ArenaString::operator>(const ArenaString& other) const noexcept
+{
+    return other < *this;
+}
+
+
+StringArena::StringArena() noexcept
+    : current{nullptr}, used_bytes{0}, allocated_bytes{0}
+{
+}
+
+
+StringArena::~StringArena() noexcept
+{
+    while (current != nullptr)
+    {
+        Chunk* del = current;
+        current = current->previous;
+        delete[] del->chars;
+        delete del;
+    }
+}
+
+
+StringArena::StringArena(StringArena&& arena) noexcept
+    : current{arena.current}, used_bytes{arena.used_bytes}, allocated_bytes{arena.allocated_bytes}
+{
+    arena.current = nullptr;
+    arena.used_bytes = 0;
+    arena.allocated_bytes = 0;
+}
+
+
+ArenaString StringArena::store(const ArenaString& s)
+{
+    if (current == nullptr || current->capacity - current->used < s.size())
+    {
+        std::size_t capacity = s.size() > CHUNK_SIZE ? s.size() : CHUNK_SIZE;
+        current = new Chunk{current, capacity, 0, new char[capacity]};
+        allocated_bytes += capacity;
+    }
+
+    char* chars = current->chars + current->used;
+    if (s.size() > 0)
+    {
+        std::memcpy(chars, s.data(), s.size());
+    }
+
+    current->used += s.size();
+    used_bytes += s.size();
+
+    return ArenaString{chars, s.size()};
+}
+
+
+ArenaString StringArena::store(const std::string& s)
+{
+    return store(ArenaString::viewOf(s));
+}
+
+
+void StringArena::forgetLast(const ArenaString& s) noexcept
+{
+    if (current != nullptr && current->used >= s.size()
+        && current->chars + current->used - s.size() == s.data())
+    {
+        current->used -= s.size();
+        used_bytes -= s.size();
+    }
+}
+
+
+unsigned long long StringArena::bytesUsed() const noexcept
+{
+    return used_bytes;
+}
+
+
+unsigned long long StringArena::bytesAllocated() const noexcept
+{
+    return allocated_bytes;
+}
+
+
+unsigned int hashArenaString(const ArenaString& s) noexcept
+{
+    unsigned int hash = 2166136261u;
+    for (unsigned int i = 0; i < s.size(); ++i)
+    {
+        hash ^= static_cast<unsigned char>(s.data()[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,119 @@
+// StringArena.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A StringArena stores the characters of many strings packed end-to-end in
+// a few large, dynamically-allocated chunks, rather than in a separately
+// allocated block per string the way std::string does once a string is
+// too long to fit inside the std::string object itself.
+//
+// What the arena hands back for each stored string is an ArenaString: a
+// small handle (a pointer to the first character and a length) that can
+// be used as the ElementType of any of the sets in this project in place
+// of std::string.  ArenaStrings compare by their characters, the same way
+// std::strings do.  Chunks are never moved or resized once allocated, so
+// handles stay valid for as long as the arena does, even as more strings
+// are added (or the arena itself is moved).
+//
+// An ArenaString can also be made to refer to characters that aren't in
+// an arena at all (see viewOf()), which is how lookups are done: the
+// string being looked up is compared directly against the stored
+// characters, without being copied anywhere first.
+
+#ifndef STRINGARENA_HPP
+#define STRINGARENA_HPP
+
+#include <cstddef>
+#include <string>
+
+
+
+class ArenaString
+{
+public:
+    // Initializes an ArenaString referring to the given characters, which
+    // must outlive it.
+    ArenaString(const char* chars, unsigned int length) noexcept;
+
+    // viewOf() returns an ArenaString referring to the characters of the
+    // given std::string, which must outlive it (and not change).
+    static ArenaString viewOf(const std::string& s) noexcept;
+
+    const char* data() const noexcept;
+    unsigned int size() const noexcept;
+
+    // str() returns a std::string copy of the characters.
+    std::string str() const;
+
+    bool operator==(const ArenaString& other) const noexcept;
+    bool operator!=(const ArenaString& other) const noexcept;
+    bool operator<(const ArenaString& other) const noexcept;
+    bool operator>(const ArenaString& other) const noexcept;
+
+private:
+    const char* chars;
+    unsigned int length;
+};
+
+
+
+class StringArena
+{
+public:
+    // Initializes an empty arena.  Nothing is allocated until the first
+    // string is stored.
+    StringArena() noexcept;
+
+    // Frees every chunk, which invalidates every ArenaString referring to
+    // this arena.
+    ~StringArena() noexcept;
+
+    // An arena can be moved (handles into it stay valid) but not copied.
+    StringArena(StringArena&& arena) noexcept;
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+    StringArena& operator=(StringArena&&) = delete;
+
+    // store() copies the characters of the given string into the arena
+    // and returns a handle to them.
+    ArenaString store(const ArenaString& s);
+    ArenaString store(const std::string& s);
+
+    // forgetLast() takes back the space used by the given string, which
+    // must be the one most recently stored.  It's meant for undoing a
+    // store() that turns out not to have been needed.
+    void forgetLast(const ArenaString& s) noexcept;
+
+    // bytesUsed() returns the number of characters stored; bytesAllocated()
+    // returns the total size of the chunks allocated to store them.
+    unsigned long long bytesUsed() const noexcept;
+    unsigned long long bytesAllocated() const noexcept;
+
+private:
+    // The size of a chunk, unless a string longer than this comes along,
+    // in which case it gets a chunk of its own size.
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+    struct Chunk
+    {
+        Chunk* previous;
+        std::size_t capacity;
+        std::size_t used;
+        char* chars;
+    };
+
+    Chunk* current;
+    unsigned long long used_bytes;
+    unsigned long long allocated_bytes;
+};
+
+
+
+// hashArenaString() is an FNV-1a hash of an ArenaString's characters,
+// suitable for a HashSet<ArenaString>.
+unsigned int hashArenaString(const ArenaString& s) noexcept;
+
+
+
+#endif // STRINGARENA_HPP
@@ -0,0 +1,384 @@
+// StringHashes.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include "StringHashes.hpp"
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+    constexpr unsigned long long WY_P0 = 0xa0761d6478bd642full;
+    constexpr unsigned long long WY_P1 = 0xe7037ed1a0b428dbull;
+    constexpr unsigned long long WY_P2 = 0x8ebc6af09c88c6e3ull;
+    constexpr unsigned long long WY_P3 = 0x589965cc75374cc3ull;
+
+    constexpr unsigned long long PRIME64 = 0x9e3779b185ebca87ull;
+    constexpr unsigned long long PRIME32 = 0x9e3779b1ull;
+
+    // random 64-bit values mixed into the xxh3-style hash's input
+    const unsigned long long SECRET[24] = {
+        0x04280b9771e371a0ull, 0xc99286b935f25ed4ull, 0xf8f036a78605c58eull,
+        0x8cf70bf2c7905221ull, 0x5158a31ee291e55cull, 0xe5fc8e9d73c586faull,
+        0x75d00b8ae6f8f214ull, 0x17854cfdafd9abafull, 0x5605b451bea284f2ull,
+        0x941a903615ab06ceull, 0x60244e0cf715691eull, 0x8b74785ff8b26897ull,
+        0x9eb4dfe830a052b1ull, 0x902926d667bafeddull, 0x4dddd1c4f00c9434ull,
+        0x89b6ef0711792de8ull, 0xdd42c8a746dc6228ull, 0x09bef79c288cd362ull,
+        0x5767d2b7ab04c81cull, 0x22c98deb8bba2759ull, 0xd89f374ae3a63d2bull,
+        0x4c5b24525116592cull, 0x9179ee12c9a119eeull, 0x38f18bd49bbb3414ull,
+    };
+
+    // the long-key loop works in stripes of 64 bytes, and scrambles its
+    // accumulators after every block of this many stripes
+    constexpr std::size_t STRIPE = 64;
+    constexpr std::size_t STRIPES_PER_BLOCK = 8;
+
+
+    unsigned long long read64(const char* p) noexcept
+    {
+        unsigned long long v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+
+    unsigned long long read32(const char* p) noexcept
+    {
+        unsigned int v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+
+    // multiplies a by b into 128 bits and returns the two halves XORed
+    unsigned long long mum(unsigned long long a, unsigned long long b) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        return static_cast<unsigned long long>(product) ^ static_cast<unsigned long long>(product >> 64);
+#else
+        unsigned long long aLo = a & 0xffffffffull, aHi = a >> 32;
+        unsigned long long bLo = b & 0xffffffffull, bHi = b >> 32;
+        unsigned long long loLo = aLo * bLo, hiLo = aHi * bLo, loHi = aLo * bHi, hiHi = aHi * bHi;
+        unsigned long long cross = (loLo >> 32) + (hiLo & 0xffffffffull) + loHi;
+        unsigned long long lo = (cross << 32) | (loLo & 0xffffffffull);
+        unsigned long long hi = hiHi + (hiLo >> 32) + (cross >> 32);
+        return lo ^ hi;
+#endif
+    }
+
+
+    unsigned long long avalanche(unsigned long long h) noexcept
+    {
+        h ^= h >> 37;
+        h *= 0x165667919e3779f9ull;
+        h ^= h >> 32;
+        return h;
+    }
+
+
+    unsigned long long mix16(const char* p, const unsigned long long* key, unsigned long long seed) noexcept
+    {
+        return mum(read64(p) ^ (key[0] + seed), read64(p + 8) ^ (key[1] - seed));
+    }
+
+
+    // the xxh3-style hash of keys of up to 16 bytes
+    unsigned long long xxh3Short(const char* p, std::size_t length, unsigned long long seed) noexcept
+    {
+        if (length > 8)
+        {
+            unsigned long long lo = read64(p) ^ (SECRET[0] + seed);
+            unsigned long long hi = read64(p + length - 8) ^ (SECRET[1] - seed);
+            return avalanche(length + lo + hi + mum(lo, hi));
+        }
+        else if (length >= 4)
+        {
+            unsigned long long input = (read32(p) << 32) | read32(p + length - 4);
+            return avalanche(mum(input ^ (SECRET[2] + seed), PRIME64 + length));
+        }
+        else if (length > 0)
+        {
+            unsigned long long combined =
+                (static_cast<unsigned long long>(static_cast<unsigned char>(p[0])) << 16)
+                | (static_cast<unsigned long long>(static_cast<unsigned char>(p[length >> 1])) << 24)
+                | static_cast<unsigned char>(p[length - 1])
+                | (length << 8);
+            return avalanche(mum(combined ^ (SECRET[3] + seed), PRIME64));
+        }
+        else
+        {
+            return avalanche(seed ^ SECRET[4]);
+        }
+    }
+
+
+    // the xxh3-style hash of keys of 17 to 128 bytes
+    unsigned long long xxh3Medium(const char* p, std::size_t length, unsigned long long seed) noexcept
+    {
+        unsigned long long acc = length * PRIME64;
+        std::size_t pair = 0;
+
+        for (std::size_t i = 0; i + 16 < length; i += 16, pair += 2)
+        {
+            acc += mix16(p + i, SECRET + pair, seed);
+        }
+        acc += mix16(p + length - 16, SECRET + pair + 1, seed);
+
+        return avalanche(acc);
+    }
+
+
+    void accumulateStripeScalar(unsigned long long* acc, const char* p, const unsigned long long* key) noexcept
+    {
+        for (unsigned int lane = 0; lane < 8; ++lane)
+        {
+            unsigned long long data = read64(p + lane * 8);
+            unsigned long long dataKey = data ^ key[lane];
+            acc[lane ^ 1] += data;
+            acc[lane] += (dataKey & 0xffffffffull) * (dataKey >> 32);
+        }
+    }
+
+
+    void scrambleScalar(unsigned long long* acc, const unsigned long long* key) noexcept
+    {
+        for (unsigned int lane = 0; lane < 8; ++lane)
+        {
+            acc[lane] ^= acc[lane] >> 47;
+            acc[lane] ^= key[lane];
+            acc[lane] *= PRIME32;
+        }
+    }
+
+
+#if defined(__SSE2__)
+    // the same as accumulateStripeScalar(), two lanes at a time
+    void accumulateStripeSSE2(__m128i* acc, const char* p, const unsigned long long* key) noexcept
+    {
+        for (unsigned int pair = 0; pair < 4; ++pair)
+        {
+            __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + pair * 16));
+            __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + pair * 2));
+            __m128i dataKey = _mm_xor_si128(data, keys);
+
+            // low 32 bits of each lane times its high 32 bits
+            __m128i dataKeyHi = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+            __m128i product = _mm_mul_epu32(dataKey, dataKeyHi);
+
+            // each lane's data goes to its neighbor
+            __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+
+            acc[pair] = _mm_add_epi64(acc[pair], _mm_add_epi64(product, swapped));
+        }
+    }
+
+
+    // the same as scrambleScalar(), two lanes at a time
+    void scrambleSSE2(__m128i* acc, const unsigned long long* key) noexcept
+    {
+        const __m128i prime = _mm_set1_epi32(static_cast<int>(PRIME32));
+
+        for (unsigned int pair = 0; pair < 4; ++pair)
+        {
+            __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + pair * 2));
+            __m128i a = acc[pair];
+            a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+            a = _mm_xor_si128(a, keys);
+
+            // a 64-bit by 32-bit multiply, from two 32-by-32 ones
+            __m128i lo = _mm_mul_epu32(a, prime);
+            __m128i hi = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+            acc[pair] = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+        }
+    }
+#endif
+
+
+    unsigned long long mergeAccumulators(const unsigned long long* acc, std::size_t length, unsigned long long seed) noexcept
+    {
+        unsigned long long result = length * PRIME64 + seed;
+        for (unsigned int pair = 0; pair < 4; ++pair)
+        {
+            result += mum(acc[pair * 2] ^ SECRET[16 + pair * 2], acc[pair * 2 + 1] ^ SECRET[17 + pair * 2]);
+        }
+        return avalanche(result);
+    }
+
+
+    void initialAccumulators(unsigned long long* acc, unsigned long long seed) noexcept
+    {
+        for (unsigned int lane = 0; lane < 8; ++lane)
+        {
+            acc[lane] = SECRET[lane] + seed * (lane + 1);
+        }
+    }
+
+
+    // the xxh3-style hash of keys longer than 128 bytes, one lane at a time
+    unsigned long long xxh3LongScalar(const char* p, std::size_t length, unsigned long long seed) noexcept
+    {
+        unsigned long long acc[8];
+        initialAccumulators(acc, seed);
+
+        std::size_t stripes = (length - 1) / STRIPE;
+        for (std::size_t s = 0; s < stripes; ++s)
+        {
+            accumulateStripeScalar(acc, p + s * STRIPE, SECRET + s % STRIPES_PER_BLOCK);
+            if (s % STRIPES_PER_BLOCK == STRIPES_PER_BLOCK - 1)
+            {
+                scrambleScalar(acc, SECRET + 16);
+            }
+        }
+
+        // the last 64 bytes, which may overlap the last full stripe
+        accumulateStripeScalar(acc, p + length - STRIPE, SECRET + 8);
+
+        return mergeAccumulators(acc, length, seed);
+    }
+
+
+    unsigned long long xxh3Long(const char* p, std::size_t length, unsigned long long seed) noexcept
+    {
+#if defined(__SSE2__)
+        unsigned long long lanes[8];
+        initialAccumulators(lanes, seed);
+
+        __m128i acc[4];
+        for (unsigned int pair = 0; pair < 4; ++pair)
+        {
+            acc[pair] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes + pair * 2));
+        }
+
+        std::size_t stripes = (length - 1) / STRIPE;
+        for (std::size_t s = 0; s < stripes; ++s)
+        {
+            accumulateStripeSSE2(acc, p + s * STRIPE, SECRET + s % STRIPES_PER_BLOCK);
+            if (s % STRIPES_PER_BLOCK == STRIPES_PER_BLOCK - 1)
+            {
+                scrambleSSE2(acc, SECRET + 16);
+            }
+        }
+
+        accumulateStripeSSE2(acc, p + length - STRIPE, SECRET + 8);
+
+        for (unsigned int pair = 0; pair < 4; ++pair)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + pair * 2), acc[pair]);
+        }
+
+        return mergeAccumulators(lanes, length, seed);
+#else
+        return xxh3LongScalar(p, length, seed);
+#endif
+    }
+}
+
+
+unsigned long long fnv1aHash64(const char* data, std::size_t length, unsigned long long seed) noexcept
+{
+    unsigned long long hash = 14695981039346656037ull ^ seed;
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+
+unsigned long long wyHash64(const char* data, std::size_t length, unsigned long long seed) noexcept
+{
+    const char* p = data;
+    unsigned long long a;
+    unsigned long long b;
+
+    seed ^= mum(seed ^ WY_P0, WY_P1);
+
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            std::size_t middle = (length >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + middle);
+            b = (read32(p + length - 4) << 32) | read32(p + length - 4 - middle);
+        }
+        else if (length > 0)
+        {
+            a = (static_cast<unsigned long long>(static_cast<unsigned char>(p[0])) << 16)
+                | (static_cast<unsigned long long>(static_cast<unsigned char>(p[length >> 1])) << 8)
+                | static_cast<unsigned char>(p[length - 1]);
+            b = 0;
+        }
+        else
+        {
+            a = 0;
+            b = 0;
+        }
+    }
+    else
+    {
+        std::size_t remaining = length;
+        if (remaining > 48)
+        {
+            // three independent chains, 48 bytes at a time
+            unsigned long long seed1 = seed;
+            unsigned long long seed2 = seed;
+            do
+            {
+                seed = mum(read64(p) ^ WY_P1, read64(p + 8) ^ seed);
+                seed1 = mum(read64(p + 16) ^ WY_P2, read64(p + 24) ^ seed1);
+                seed2 = mum(read64(p + 32) ^ WY_P3, read64(p + 40) ^ seed2);
+                p += 48;
+                remaining -= 48;
+            }
+            while (remaining > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (remaining > 16)
+        {
+            seed = mum(read64(p) ^ WY_P1, read64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        a = read64(p + remaining - 16);
+        b = read64(p + remaining - 8);
+    }
+
+    return mum(WY_P1 ^ length, mum(a ^ WY_P1, b ^ seed));
+}
+
+
+unsigned long long xxh3Hash64(const char* data, std::size_t length, unsigned long long seed) noexcept
+{
+    if (length <= 16)
+    {
+        return xxh3Short(data, length, seed);
+    }
+    else if (length <= 128)
+    {
+        return xxh3Medium(data, length, seed);
+    }
+    else
+    {
+        return xxh3Long(data, length, seed);
+    }
+}
+
+
+unsigned long long xxh3Hash64Scalar(const char* data, std::size_t length, unsigned long long seed) noexcept
+{
+    if (length <= 128)
+    {
+        return xxh3Hash64(data, length, seed);
+    }
+    else
+    {
+        return xxh3LongScalar(data, length, seed);
+    }
+}
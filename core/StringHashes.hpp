@@ -0,0 +1,85 @@
+// StringHashes.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A small library of fast, non-cryptographic string hash functions that
+// spread words well across a HashSet's array.  (A hash like "add up the
+// characters" maps anagrams, and most short words, to a handful of
+// indexes, leaving long chains.)  There are three families:
+//
+// * FNV-1a: one multiply per byte.  Simple and well understood; fine for
+//   short words, but slow for long keys.
+// * wyhash-style: reads 8 bytes at a time and mixes with a 64x64-to-128-bit
+//   multiply, folding the two halves together.  Usually the fastest choice
+//   for words.
+// * xxh3-style: like the wyhash-style hash for short keys, but keys longer
+//   than 128 bytes are consumed 64 bytes at a time across eight independent
+//   accumulators.  When SSE2 is available, that loop works on two
+//   accumulators per instruction; the results are exactly the same either
+//   way.
+//
+// These follow the structure of the published algorithms they're named
+// after, but they aren't bit-for-bit compatible with them, so don't mix
+// their values with values produced by those libraries.  They read
+// multi-byte values in the machine's byte order, so the same string
+// hashes differently on big- and little-endian machines.
+//
+// Each family has a 64-bit function taking characters and a seed, and an
+// unsigned int version, taking anything with data() and size() (such as a
+// std::string or an ArenaString), that can be handed straight to a
+// HashSet:
+//
+//     HashSet<std::string> words{wyHash<std::string>};
+
+#ifndef STRINGHASHES_HPP
+#define STRINGHASHES_HPP
+
+#include <cstddef>
+
+
+
+unsigned long long fnv1aHash64(const char* data, std::size_t length, unsigned long long seed = 0) noexcept;
+unsigned long long wyHash64(const char* data, std::size_t length, unsigned long long seed = 0) noexcept;
+unsigned long long xxh3Hash64(const char* data, std::size_t length, unsigned long long seed = 0) noexcept;
+
+
+// xxh3Hash64Scalar() is xxh3Hash64() without the SSE2 loop, always giving
+// the same results; it exists so the two can be checked against each other.
+unsigned long long xxh3Hash64Scalar(const char* data, std::size_t length, unsigned long long seed = 0) noexcept;
+
+
+namespace impl_
+{
+    // folds a 64-bit hash into the unsigned int that a HashSet wants,
+    // keeping the influence of all 64 bits
+    inline unsigned int StringHashes__fold(unsigned long long hash) noexcept
+    {
+        return static_cast<unsigned int>(hash ^ (hash >> 32));
+    }
+}
+
+
+template <typename StringType>
+unsigned int fnv1aHash(const StringType& s) noexcept
+{
+    return impl_::StringHashes__fold(fnv1aHash64(s.data(), s.size()));
+}
+
+
+template <typename StringType>
+unsigned int wyHash(const StringType& s) noexcept
+{
+    return impl_::StringHashes__fold(wyHash64(s.data(), s.size()));
+}
+
+
+template <typename StringType>
+unsigned int xxh3Hash(const StringType& s) noexcept
+{
+    return impl_::StringHashes__fold(xxh3Hash64(s.data(), s.size()));
+}
+
+
+
+#endif // STRINGHASHES_HPP
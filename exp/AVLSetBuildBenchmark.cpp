@@ -0,0 +1,103 @@
+// AVLSetBuildBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Measures the life cycle of an AVLSet built from a sorted word list:
+// how long it takes to build (by adding the words one at a time, and by
+// handing them all to assignSorted(), with and without checking that
+// they're sorted), how much memory it takes, how long it takes to copy,
+// and how long it takes to tear down.  This is done for the given words
+// and, if there are fewer than that, for a million synthetic ones.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LOOKUPS = 1000000;
+    constexpr unsigned int LARGE_WORD_COUNT = 1000000;
+
+
+    enum class Build
+    {
+        addingOneAtATime,
+        assignSorted,
+        assignSortedUnverified
+    };
+
+
+    void measure(const char* name, Build build, const std::vector<std::string>& words)
+    {
+        unsigned long long heapBefore = liveHeapBytes();
+        Stopwatch watch;
+
+        AVLSet<std::string>* set = new AVLSet<std::string>;
+        if (build == Build::addingOneAtATime)
+        {
+            for (const std::string& word : words)
+            {
+                set->add(word);
+            }
+        }
+        else
+        {
+            set->assignSorted(words.begin(), words.end(), build == Build::assignSorted);
+        }
+
+        double buildSeconds = watch.seconds();
+        unsigned long long heapBytes = liveHeapBytes() - heapBefore;
+        // memory freed by earlier runs gets reused, so the growth in the
+        // resident set size wouldn't mean much; its total does
+        unsigned long long resident = residentBytes();
+        double nanoseconds = nanosecondsPerLookup(*set, words, LOOKUPS);
+
+        watch.restart();
+        AVLSet<std::string>* copy = new AVLSet<std::string>{*set};
+        double copySeconds = watch.seconds();
+        keep(copy->size());
+        delete copy;
+
+        watch.restart();
+        delete set;
+        double teardownSeconds = watch.seconds();
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "    " << std::left << std::setw(28) << name << std::right
+                  << " build " << std::setw(7) << buildSeconds * 1e3 << " ms, "
+                  << "copy " << std::setw(6) << copySeconds * 1e3 << " ms, "
+                  << "teardown " << std::setw(6) << teardownSeconds * 1e3 << " ms, "
+                  << std::setw(5) << static_cast<double>(heapBytes) / words.size() << " bytes/word, "
+                  << "RSS " << std::setw(6) << resident / (1024.0 * 1024.0) << " MB, "
+                  << "lookup " << std::setw(6) << nanoseconds << " ns"
+                  << std::endl;
+    }
+
+
+    void measureAll(std::vector<std::string> words)
+    {
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+
+        std::cout << "  " << words.size() << " sorted words" << std::endl;
+        measure("add() one at a time", Build::addingOneAtATime, words);
+        measure("assignSorted()", Build::assignSorted, words);
+        measure("assignSorted(), unverified", Build::assignSortedUnverified, words);
+    }
+}
+
+
+void runAVLSetBuildBenchmark(const std::vector<std::string>& words)
+{
+    measureAll(words);
+
+    if (words.size() < LARGE_WORD_COUNT)
+    {
+        measureAll(syntheticWords(LARGE_WORD_COUNT));
+    }
+}
@@ -0,0 +1,90 @@
+// AVLSetMergeBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Measures merging a smaller "overlay" dictionary (say, a user's own
+// words) into a large base dictionary, both AVLSets: adding the overlay's
+// words one at a time, against unionWith().  Half of the overlay's words
+// are already in the base.  intersect() and difference() are timed with
+// the same two sets.  The base is the given words, or a million synthetic
+// ones if there are fewer than that.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LARGE_WORD_COUNT = 1000000;
+    constexpr unsigned int OVERLAY_WORD_COUNT = 50000;
+
+
+    void report(const char* name, double seconds, unsigned int size)
+    {
+        std::cout << std::fixed << std::setprecision(1)
+                  << "    " << std::left << std::setw(28) << name << std::right
+                  << std::setw(8) << seconds * 1e3 << " ms, "
+                  << size << " words after" << std::endl;
+    }
+}
+
+
+void runAVLSetMergeBenchmark(const std::vector<std::string>& words)
+{
+    std::vector<std::string> baseWords =
+        words.size() < LARGE_WORD_COUNT ? syntheticWords(LARGE_WORD_COUNT) : words;
+    std::sort(baseWords.begin(), baseWords.end());
+    baseWords.erase(std::unique(baseWords.begin(), baseWords.end()), baseWords.end());
+
+    AVLSet<std::string> base;
+    base.assignSorted(baseWords.begin(), baseWords.end());
+
+    // half of the overlay is already in the base, and the other half are
+    // misspellings of base words, which (mostly) aren't
+    std::mt19937 random{46};
+    AVLSet<std::string> overlay;
+    for (unsigned int i = 0; i < OVERLAY_WORD_COUNT; ++i)
+    {
+        const std::string& word = baseWords[random() % baseWords.size()];
+        overlay.add(i % 2 == 0 ? word : misspell(word, i));
+    }
+
+    std::cout << "  " << base.size() << " base words, " << overlay.size() << " overlay words" << std::endl;
+
+    {
+        AVLSet<std::string> merged{base};
+        Stopwatch watch;
+        for (const std::string& word : overlay)
+        {
+            merged.add(word);
+        }
+        report("add() one at a time", watch.seconds(), merged.size());
+    }
+
+    {
+        AVLSet<std::string> merged{base};
+        Stopwatch watch;
+        merged.unionWith(overlay);
+        report("unionWith()", watch.seconds(), merged.size());
+    }
+
+    {
+        AVLSet<std::string> kept{base};
+        Stopwatch watch;
+        kept.intersect(overlay);
+        report("intersect()", watch.seconds(), kept.size());
+    }
+
+    {
+        AVLSet<std::string> kept{base};
+        Stopwatch watch;
+        kept.difference(overlay);
+        report("difference()", watch.seconds(), kept.size());
+    }
+}
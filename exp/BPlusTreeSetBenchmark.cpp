@@ -0,0 +1,97 @@
+// BPlusTreeSetBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares a BPlusTreeSet against an AVLSet: how long each takes to build
+// (adding the words in a scattered order, adding them in ascending order,
+// and with assignSorted()), how much memory each takes, how tall each
+// tree is, and how long lookups take.  This is done for the given words
+// and, if there are fewer than that, for a million synthetic ones.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "BPlusTreeSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LARGE_WORD_COUNT = 1000000;
+
+
+    enum class Build
+    {
+        addingShuffled,
+        addingAscending,
+        assignSorted
+    };
+
+
+    template <typename SetType>
+    void build(SetType& set, Build how, const std::vector<std::string>& sorted, const std::vector<std::string>& shuffled)
+    {
+        if (how == Build::assignSorted)
+        {
+            set.assignSorted(sorted.begin(), sorted.end());
+        }
+        else
+        {
+            for (const std::string& word : how == Build::addingShuffled ? shuffled : sorted)
+            {
+                set.add(word);
+            }
+        }
+    }
+
+
+    template <typename SetType>
+    void measure(
+        const char* name, Build how,
+        const std::vector<std::string>& sorted, const std::vector<std::string>& shuffled)
+    {
+        measureBuildMemoryLookup<SetType>(
+            name, sorted,
+            [&](SetType& set) { build(set, how, sorted, shuffled); },
+            [](const SetType& set, std::ostream& out)
+            {
+                out << "height " << std::setw(2) << static_cast<int>(set.height()) << ", ";
+            });
+    }
+
+
+    void measureAll(std::vector<std::string> words)
+    {
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+
+        std::vector<std::string> shuffled{words};
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{46});
+
+        std::cout << "  " << words.size() << " words (B+ tree leaves hold "
+                  << BPlusTreeSet<std::string>::LEAF_CAPACITY << ", inner nodes "
+                  << BPlusTreeSet<std::string>::INNER_CAPACITY << ")" << std::endl;
+
+        measure<AVLSet<std::string>>("AVLSet, add() scattered", Build::addingShuffled, words, shuffled);
+        measure<AVLSet<std::string>>("AVLSet, add() ascending", Build::addingAscending, words, shuffled);
+        measure<AVLSet<std::string>>("AVLSet, assignSorted()", Build::assignSorted, words, shuffled);
+        measure<BPlusTreeSet<std::string>>("BPlusTreeSet, add() scattered", Build::addingShuffled, words, shuffled);
+        measure<BPlusTreeSet<std::string>>("BPlusTreeSet, add() ascending", Build::addingAscending, words, shuffled);
+        measure<BPlusTreeSet<std::string>>("BPlusTreeSet, assignSorted()", Build::assignSorted, words, shuffled);
+    }
+}
+
+
+void runBPlusTreeSetBenchmark(const std::vector<std::string>& words)
+{
+    measureAll(words);
+
+    if (words.size() < LARGE_WORD_COUNT)
+    {
+        measureAll(syntheticWords(LARGE_WORD_COUNT));
+    }
+}
@@ -0,0 +1,295 @@
+// BenchmarkSupport.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include "BenchmarkSupport.hpp"
+#include <atomic>
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+
+std::vector<std::string> loadWords(const std::string& path)
+{
+    std::vector<std::string> words;
+    std::ifstream in{path};
+    std::string word;
+
+    while (in >> word)
+    {
+        for (char& c : word)
+        {
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+        words.push_back(word);
+    }
+
+    return words;
+}
+
+
+std::vector<std::string> syntheticWords(unsigned int count)
+{
+    std::vector<std::string> words;
+    std::unordered_set<std::string> seen;
+    std::mt19937 engine{count};
+    std::uniform_int_distribution<int> lengths{3, 12};
+    std::uniform_int_distribution<int> letters{0, 25};
+
+    words.reserve(count);
+    while (words.size() < count)
+    {
+        std::string word(lengths(engine), 'A');
+        for (char& c : word)
+        {
+            c = static_cast<char>('A' + letters(engine));
+        }
+        if (seen.insert(word).second)
+        {
+            words.push_back(word);
+        }
+    }
+
+    return words;
+}
+
+
+std::string misspell(const std::string& word, unsigned int seed)
+{
+    std::string misspelled = word;
+    if (!misspelled.empty())
+    {
+        unsigned int index = seed % misspelled.size();
+        misspelled[index] = static_cast<char>('A' + (misspelled[index] - 'A' + 1 + seed % 25) % 26);
+    }
+    return misspelled;
+}
+
+
+double nanosecondsPerLookup(
+    const Set<std::string>& set, const std::vector<std::string>& words, unsigned int lookups)
+{
+    Stopwatch watch;
+    unsigned long long found = 0;
+    for (unsigned int i = 0; i < lookups; ++i)
+    {
+        const std::string& word = words[(i * 7919ull) % words.size()];
+        found += set.contains(i % 2 == 0 ? word : misspell(word, i));
+    }
+    keep(found);
+    return watch.seconds() * 1e9 / lookups;
+}
+
+
+unsigned int benchmarkHash(const std::string& s)
+{
+    unsigned int hash = 2166136261u;
+    for (char c : s)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+namespace
+{
+    volatile unsigned long long sink;
+
+    std::atomic<unsigned long long> liveBytes{0};
+
+    // every block handed out by operator new is preceded by its size,
+    // padded so the block keeps malloc()'s alignment
+    constexpr std::size_t SIZE_PREFIX = alignof(std::max_align_t);
+}
+
+
+void* operator new(std::size_t size)
+{
+    void* p = std::malloc(size + SIZE_PREFIX);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+
+    *static_cast<std::size_t*>(p) = size;
+    liveBytes += size;
+    return static_cast<char*>(p) + SIZE_PREFIX;
+}
+
+
+void operator delete(void* p) noexcept
+{
+    if (p != nullptr)
+    {
+        void* block = static_cast<char*>(p) - SIZE_PREFIX;
+        liveBytes -= *static_cast<std::size_t*>(block);
+        std::free(block);
+    }
+}
+
+
+void operator delete(void* p, std::size_t size) noexcept
+{
+    operator delete(p);
+}
+
+
+unsigned long long liveHeapBytes() noexcept
+{
+    return liveBytes.load();
+}
+
+
+unsigned long long residentBytes()
+{
+#if defined(__linux__)
+    // the second number in statm is the resident set size, in pages
+    std::ifstream statm{"/proc/self/statm"};
+    unsigned long long totalPages = 0;
+    unsigned long long residentPages = 0;
+    if (statm >> totalPages >> residentPages)
+    {
+        return residentPages * static_cast<unsigned long long>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+
+    return 0;
+}
+
+
+void keep(unsigned long long value)
+{
+    sink = value;
+}
+
+
+double stress(
+    Set<std::string>& set, const std::vector<std::string>& words,
+    unsigned int threadCount, unsigned int writeEvery, bool& allFound,
+    double seconds)
+{
+    std::size_t half = words.size() / 2;
+    for (std::size_t i = 0; i < half; ++i)
+    {
+        set.add(words[i]);
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<unsigned long long> operations{0};
+    std::vector<std::size_t> added(threadCount, 0);
+    std::vector<std::thread> threads;
+
+    for (unsigned int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t] {
+            // this thread adds words[half + t], words[half + t + threadCount], ...
+            std::size_t nextAdd = half + t;
+            unsigned long long ops = 0;
+            unsigned long long found = 0;
+
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                for (unsigned int i = 0; i < 256; ++i, ++ops)
+                {
+                    if (ops % writeEvery == 0 && nextAdd < words.size())
+                    {
+                        set.add(words[nextAdd]);
+                        nextAdd += threadCount;
+                    }
+                    else
+                    {
+                        const std::string& word = words[(ops * 7919 + t * 104729) % half];
+                        found += set.contains(ops % 2 == 0 ? word : misspell(word, ops));
+                    }
+                }
+            }
+
+            keep(found);
+            operations += ops;
+            added[t] = nextAdd;
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (unsigned int t = 0; t < threadCount; ++t)
+    {
+        for (std::size_t i = half + t; i < added[t]; i += threadCount)
+        {
+            allFound = allFound && set.contains(words[i]);
+        }
+    }
+
+    return operations.load() / seconds / 1e6;
+}
+
+
+void compareUnderStress(
+    const std::vector<std::string>& words,
+    const std::string& concurrentName,
+    const std::function<std::unique_ptr<Set<std::string>>()>& makeConcurrent,
+    const std::string& lockedName,
+    const std::function<std::unique_ptr<Set<std::string>>()>& makeLocked)
+{
+    unsigned int maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads < 4)
+    {
+        maxThreads = 4;
+    }
+
+    for (unsigned int writeEvery : {100u, 10u})
+    {
+        std::cout << "  1 add per " << writeEvery << " operations" << std::endl;
+
+        for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+        {
+            bool allFound = true;
+
+            double concurrentRate = stress(*makeConcurrent(), words, threads, writeEvery, allFound);
+            double lockedRate = stress(*makeLocked(), words, threads, writeEvery, allFound);
+
+            std::cout << std::fixed << std::setprecision(2)
+                      << "    " << std::setw(2) << threads << " threads: "
+                      << concurrentName << " " << std::setw(7) << concurrentRate << " Mops/s, "
+                      << lockedName << " " << std::setw(7) << lockedRate << " Mops/s"
+                      << (allFound ? "" : "  (LOST ADDS!)") << std::endl;
+        }
+    }
+}
+
+
+Stopwatch::Stopwatch()
+    : start{std::chrono::steady_clock::now()}
+{
+}
+
+
+void Stopwatch::restart()
+{
+    start = std::chrono::steady_clock::now();
+}
+
+
+double Stopwatch::seconds() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,211 @@
+// BenchmarkSupport.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Utilities shared by the benchmarks in this directory: getting a list
+// of words to work with, timing things, keeping the optimizer from
+// throwing away the work being timed, and stress-testing sets that are
+// shared among threads.
+
+#ifndef BENCHMARKSUPPORT_HPP
+#define BENCHMARKSUPPORT_HPP
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Set.hpp"
+
+
+
+// loadWords() reads whitespace-separated words from the given file,
+// converting them to uppercase the way the spell checker expects.  If the
+// file can't be opened, the returned vector is empty.
+std::vector<std::string> loadWords(const std::string& path);
+
+
+// syntheticWords() generates count distinct, uppercase, word-like strings
+// (3 to 12 letters long), always the same ones for the same count, for
+// when no word list is given.
+std::vector<std::string> syntheticWords(unsigned int count);
+
+
+// misspell() returns a copy of the word with one letter replaced, which is
+// the same kind of probe that WordChecker::findSuggestions() generates.
+std::string misspell(const std::string& word, unsigned int seed);
+
+
+// nanosecondsPerLookup() times the given number of calls to contains() on
+// the set, alternating between words from the list (in a scattered order)
+// and misspellings of them, and returns the average time per call.
+double nanosecondsPerLookup(
+    const Set<std::string>& set, const std::vector<std::string>& words, unsigned int lookups);
+
+
+// benchmarkHash() is a reasonable string hash (FNV-1a) for benchmarks
+// that need to build a HashSet.
+unsigned int benchmarkHash(const std::string& s);
+
+
+// liveHeapBytes() returns the number of bytes currently allocated with
+// the global operator new, which this program replaces with one that
+// keeps count.  The difference between two calls measures how much memory
+// something allocated.
+unsigned long long liveHeapBytes() noexcept;
+
+
+// residentBytes() returns how much of this program's memory is actually
+// in RAM (its resident set size), which, unlike liveHeapBytes(), includes
+// what the memory allocator is holding onto and its own overhead.  It
+// returns 0 where that can't be determined.
+unsigned long long residentBytes();
+
+
+// keep() makes it look to the compiler like the given value is used, so
+// that the computation that produced it can't be optimized away.
+void keep(unsigned long long value);
+
+
+// stress() is a multi-threaded read/write workload.  Half of the words
+// are added to the set up front; then each of the given number of
+// threads runs a mix of lookups (words and misspellings) and adds (its
+// own share of the other half of the words), one add in every writeEvery
+// operations, for the given number of seconds.  Afterward, every word
+// that was added is looked up, and allFound is set to false if any of
+// them is missing, so that a lost update shows up.  Returns millions of
+// operations per second.
+double stress(
+    Set<std::string>& set, const std::vector<std::string>& words,
+    unsigned int threadCount, unsigned int writeEvery, bool& allFound,
+    double seconds = 0.5);
+
+
+// compareUnderStress() runs stress() at one add per 100 operations and
+// one per 10, with 1, 2, 4, ... threads (up to the number of cores, but
+// at least 4), on a fresh set from each of the two functions given, and
+// prints the two rates side by side.
+void compareUnderStress(
+    const std::vector<std::string>& words,
+    const std::string& concurrentName,
+    const std::function<std::unique_ptr<Set<std::string>>()>& makeConcurrent,
+    const std::string& lockedName,
+    const std::function<std::unique_ptr<Set<std::string>>()>& makeLocked);
+
+
+
+// A Stopwatch measures elapsed wall-clock time since it was created or
+// last restarted.
+class Stopwatch
+{
+public:
+    Stopwatch();
+
+    void restart();
+    double seconds() const;
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+
+
+// measureBuildMemoryLookup() builds a SetType on the heap by calling
+// build() with it, then prints a line with the given name saying how long
+// that took, how much memory the set takes per word, and how long lookups
+// of the given words (and misspellings of them) take.  describe() is
+// given the set and the output stream, and can add anything else worth
+// knowing about the set to the line.  The shorter form builds the set by
+// adding the words in the given order and describes nothing more.
+template <typename SetType, typename Build, typename Describe>
+void measureBuildMemoryLookup(
+    const char* name, const std::vector<std::string>& words, Build build, Describe describe)
+{
+    constexpr unsigned int lookups = 1000000;
+
+    unsigned long long heapBefore = liveHeapBytes();
+    Stopwatch watch;
+
+    std::unique_ptr<SetType> set{new SetType};
+    build(*set);
+
+    double buildSeconds = watch.seconds();
+    unsigned long long heapBytes = liveHeapBytes() - heapBefore;
+    double nanoseconds = nanosecondsPerLookup(*set, words, lookups);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "    " << std::left << std::setw(34) << name << std::right
+              << " build " << std::setw(7) << buildSeconds * 1e3 << " ms, "
+              << std::setw(5) << static_cast<double>(heapBytes) / words.size() << " bytes/word, ";
+    describe(*set, std::cout);
+    std::cout << "lookup " << std::setw(6) << nanoseconds << " ns" << std::endl;
+}
+
+
+template <typename SetType>
+void measureBuildMemoryLookup(
+    const char* name, const std::vector<std::string>& order, const std::vector<std::string>& words)
+{
+    measureBuildMemoryLookup<SetType>(
+        name, words,
+        [&order](SetType& set)
+        {
+            for (const std::string& word : order)
+            {
+                set.add(word);
+            }
+        },
+        [](const SetType&, std::ostream&) {});
+}
+
+
+
+// A LockedSet is what we'd do to share a set among threads without a
+// concurrent one: take one lock around everything.  The constructor's
+// arguments are passed along to the SetType's.
+template <typename SetType>
+class LockedSet : public Set<std::string>
+{
+public:
+    template <typename... Args>
+    explicit LockedSet(Args&&... args)
+        : set{std::forward<Args>(args)...}
+    {
+    }
+
+    bool isImplemented() const noexcept override
+    {
+        return true;
+    }
+
+    void add(const std::string& element) override
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        set.add(element);
+    }
+
+    bool contains(const std::string& element) const override
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return set.contains(element);
+    }
+
+    unsigned int size() const noexcept override
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return set.size();
+    }
+
+private:
+    SetType set;
+    mutable std::mutex mutex;
+};
+
+
+
+#endif // BENCHMARKSUPPORT_HPP
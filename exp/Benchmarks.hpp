@@ -0,0 +1,76 @@
+// Benchmarks.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Each benchmark is a function that takes the words it should work with
+// and prints what it measured to std::cout.  expmain.cpp decides which
+// one to run based on its command-line arguments.
+
+#ifndef BENCHMARKS_HPP
+#define BENCHMARKS_HPP
+
+#include <string>
+#include <vector>
+
+
+
+// Compares HashSet::containsMany() against looping over contains().
+void runContainsManyBenchmark(const std::vector<std::string>& words);
+
+// Multi-threaded read/write stress test of ConcurrentHashSet against a
+// HashSet behind a global mutex.
+void runConcurrentHashSetBenchmark(const std::vector<std::string>& words);
+
+// Startup cost of building a HashSet against opening a HashSetImage, and
+// lookups into each.
+void runHashSetImageBenchmark(const std::vector<std::string>& words);
+
+// Build time, memory, and lookup time of PerfectHashSet, HashSet, and
+// AVLSet.
+void runPerfectHashSetBenchmark(const std::vector<std::string>& words);
+
+// Bytes per word and lookup time of sets of std::string against
+// ArenaStringSets.
+void runStringArenaBenchmark(const std::vector<std::string>& words);
+
+// Throughput of the hashes in StringHashes.hpp at several key lengths,
+// and how evenly each spreads words across a HashSet.
+void runStringHashesBenchmark(const std::vector<std::string>& words);
+
+// Building an AVLSet from sorted words one add() at a time, against
+// assignSorted(), along with the memory it takes and how long copying and
+// destroying it take.
+void runAVLSetBuildBenchmark(const std::vector<std::string>& words);
+
+// Lookups in an EytzingerSet against an AVLSet and a HashSet, with warm
+// and cold caches.
+void runEytzingerSetBenchmark(const std::vector<std::string>& words);
+
+// Build time, memory, height, and lookup time of a BPlusTreeSet against
+// an AVLSet.
+void runBPlusTreeSetBenchmark(const std::vector<std::string>& words);
+
+// Merging a small AVLSet into a large one by adding its elements one at
+// a time, against unionWith(), along with intersect() and difference().
+void runAVLSetMergeBenchmark(const std::vector<std::string>& words);
+
+// Build time, memory, and lookup time of a SkipListSet against an
+// AVLSet.
+void runSkipListSetBenchmark(const std::vector<std::string>& words);
+
+// Multi-threaded read/write stress test of ConcurrentSkipListSet against
+// a SkipListSet behind a global mutex.
+void runConcurrentSkipListSetBenchmark(const std::vector<std::string>& words);
+
+// Sorted batches of lookups into a SkipListSet, looping over contains()
+// against containsSorted().
+void runSkipListSetFingerBenchmark(const std::vector<std::string>& words);
+
+// Build time, memory, and lookup time of a PackedSkipListSet against a
+// SkipListSet.
+void runPackedSkipListSetBenchmark(const std::vector<std::string>& words);
+
+
+
+#endif // BENCHMARKS_HPP
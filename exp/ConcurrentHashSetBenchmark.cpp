@@ -0,0 +1,24 @@
+// ConcurrentHashSetBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A multi-threaded read/write stress test (see stress() in
+// BenchmarkSupport.hpp) comparing ConcurrentHashSet against what we'd do
+// without it: a HashSet behind one global mutex.
+
+#include <memory>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "ConcurrentHashSet.hpp"
+#include "HashSet.hpp"
+
+
+
+void runConcurrentHashSetBenchmark(const std::vector<std::string>& words)
+{
+    compareUnderStress(
+        words,
+        "ConcurrentHashSet", [] { return std::make_unique<ConcurrentHashSet<std::string>>(benchmarkHash); },
+        "HashSet + mutex", [] { return std::make_unique<LockedSet<HashSet<std::string>>>(benchmarkHash); });
+}
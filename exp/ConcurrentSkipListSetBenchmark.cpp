@@ -0,0 +1,24 @@
+// ConcurrentSkipListSetBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// A multi-threaded read/write stress test (see stress() in
+// BenchmarkSupport.hpp) comparing ConcurrentSkipListSet against what we'd
+// do without it: a SkipListSet behind one global mutex.
+
+#include <memory>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "ConcurrentSkipListSet.hpp"
+#include "SkipListSet.hpp"
+
+
+
+void runConcurrentSkipListSetBenchmark(const std::vector<std::string>& words)
+{
+    compareUnderStress(
+        words,
+        "ConcurrentSkipListSet", [] { return std::make_unique<ConcurrentSkipListSet<std::string>>(); },
+        "SkipListSet + mutex", [] { return std::make_unique<LockedSet<SkipListSet<std::string>>>(); });
+}
@@ -0,0 +1,86 @@
+// ContainsManyBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Times batches of lookups into a HashSet holding every word, done once
+// by looping over contains() and once with containsMany().  Half of each
+// batch are words in the set and half are misspellings of them, roughly
+// like the probes that WordChecker::findSuggestions() makes.
+
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "HashSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LOOKUPS_PER_RUN = 4000000;
+
+
+    void compareForBatchSize(
+        const HashSet<std::string>& set, const std::vector<std::string>& probes,
+        unsigned int batchSize)
+    {
+        unsigned int batches = LOOKUPS_PER_RUN / batchSize;
+        std::unique_ptr<bool[]> results{new bool[batchSize]};
+
+        Stopwatch watch;
+        unsigned long long found = 0;
+        for (unsigned int b = 0; b < batches; ++b)
+        {
+            const std::string* batch = &probes[(b * batchSize) % (probes.size() - batchSize)];
+            for (unsigned int i = 0; i < batchSize; ++i)
+            {
+                found += set.contains(batch[i]);
+            }
+        }
+        double loopSeconds = watch.seconds();
+        keep(found);
+
+        watch.restart();
+        found = 0;
+        for (unsigned int b = 0; b < batches; ++b)
+        {
+            const std::string* batch = &probes[(b * batchSize) % (probes.size() - batchSize)];
+            set.containsMany(batch, batchSize, results.get());
+            for (unsigned int i = 0; i < batchSize; ++i)
+            {
+                found += results[i];
+            }
+        }
+        double batchSeconds = watch.seconds();
+        keep(found);
+
+        double lookups = static_cast<double>(batches) * batchSize;
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  batch of " << std::setw(3) << batchSize << ": "
+                  << "contains() loop " << loopSeconds * 1e9 / lookups << " ns/lookup, "
+                  << "containsMany() " << batchSeconds * 1e9 / lookups << " ns/lookup, "
+                  << std::setprecision(2) << "speedup " << loopSeconds / batchSeconds << "x"
+                  << std::endl;
+    }
+}
+
+
+void runContainsManyBenchmark(const std::vector<std::string>& words)
+{
+    HashSet<std::string> set{words.begin(), words.end(), benchmarkHash};
+
+    // probes in random order, so consecutive lookups land far apart
+    std::vector<std::string> probes;
+    std::mt19937 engine{46};
+    std::uniform_int_distribution<std::size_t> pick{0, words.size() - 1};
+    for (unsigned int i = 0; i < 1 << 18; ++i)
+    {
+        const std::string& word = words[pick(engine)];
+        probes.push_back(i % 2 == 0 ? word : misspell(word, i));
+    }
+
+    compareForBatchSize(set, probes, 26);
+    compareForBatchSize(set, probes, 256);
+}
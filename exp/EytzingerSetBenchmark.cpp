@@ -0,0 +1,211 @@
+// EytzingerSetBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares lookups in an EytzingerSet against an AVLSet (built both by
+// adding words one at a time, which scatters its nodes across the heap,
+// and with assignSorted(), which packs them together) and a HashSet.
+// Each is measured with warm caches, by looking up the same thousand
+// words over and over, and with cold caches, by sweeping through a buffer
+// bigger than the processor's caches before every single lookup and
+// timing only the lookup itself (less what it costs to read the clock).
+// Half of the lookups are misspellings, which aren't in the set.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "EytzingerSet.hpp"
+#include "HashSet.hpp"
+#include "StringHashes.hpp"
+
+
+namespace
+{
+    constexpr unsigned int HOT_WORD_COUNT = 1000;
+    constexpr unsigned int WARM_LOOKUPS = 2000000;
+    constexpr unsigned int COLD_LOOKUPS = 256;
+    constexpr unsigned int LARGE_WORD_COUNT = 1000000;
+    constexpr unsigned long long CACHE_SWEEP_BYTES = 64ull * 1024 * 1024;
+
+
+    // the queries are built ahead of time, so that building a misspelling
+    // isn't part of what's timed
+    std::vector<std::string> makeQueries(const std::vector<std::string>& words, unsigned int count)
+    {
+        std::vector<std::string> queries;
+        queries.reserve(count);
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            const std::string& word = words[(i / 2) % words.size()];
+            queries.push_back(i % 2 == 0 ? word : misspell(word, i));
+        }
+
+        std::shuffle(queries.begin(), queries.end(), std::mt19937{46});
+        return queries;
+    }
+
+
+    // touches every cache line of a large buffer, so that whatever the
+    // set had in the caches is evicted
+    void evictTheCaches()
+    {
+        static std::vector<char> sweep(CACHE_SWEEP_BYTES);
+
+        unsigned long long sum = 0;
+        for (unsigned long long i = 0; i < sweep.size(); i += 64)
+        {
+            sweep[i]++;
+            sum += sweep[i];
+        }
+
+        keep(sum);
+    }
+
+
+    double nanosecondsPerQuery(const Set<std::string>& set, const std::vector<std::string>& queries, unsigned int rounds)
+    {
+        unsigned long long found = 0;
+        Stopwatch watch;
+
+        for (unsigned int round = 0; round < rounds; ++round)
+        {
+            for (const std::string& query : queries)
+            {
+                found += set.contains(query);
+            }
+        }
+
+        double seconds = watch.seconds();
+        keep(found);
+        return seconds * 1e9 / (static_cast<double>(queries.size()) * rounds);
+    }
+
+
+    // how long it takes to read the Stopwatch, which is subtracted from
+    // each cold lookup's time
+    double stopwatchOverhead()
+    {
+        constexpr unsigned int samples = 10000;
+        double total = 0.0;
+
+        Stopwatch watch;
+        for (unsigned int i = 0; i < samples; ++i)
+        {
+            watch.restart();
+            total += watch.seconds();
+        }
+
+        return total / samples;
+    }
+
+
+    // evicts the caches before each lookup, so that none of them can
+    // benefit from what the lookups before it brought into the caches
+    double coldNanosecondsPerQuery(const Set<std::string>& set, const std::vector<std::string>& queries)
+    {
+        double overhead = stopwatchOverhead();
+        double total = 0.0;
+        unsigned long long found = 0;
+        Stopwatch watch;
+
+        for (unsigned int i = 0; i < COLD_LOOKUPS; ++i)
+        {
+            const std::string& query = queries[(i * 7919ull) % queries.size()];
+            evictTheCaches();
+
+            // only the set should be cold, not the query itself
+            unsigned long long touched = 0;
+            for (char c : query)
+            {
+                touched += static_cast<unsigned char>(c);
+            }
+            keep(touched);
+
+            watch.restart();
+            found += set.contains(query);
+            total += watch.seconds() - overhead;
+        }
+
+        keep(found);
+        return total * 1e9 / COLD_LOOKUPS;
+    }
+
+
+    void measure(
+        const char* name, const Set<std::string>& set,
+        const std::vector<std::string>& hotQueries, const std::vector<std::string>& coldQueries)
+    {
+        // one round first, so that the warm measurement starts warm
+        nanosecondsPerQuery(set, hotQueries, 1);
+        double warm = nanosecondsPerQuery(set, hotQueries, WARM_LOOKUPS / hotQueries.size());
+
+        double cold = coldNanosecondsPerQuery(set, coldQueries);
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "    " << std::left << std::setw(24) << name << std::right
+                  << " warm " << std::setw(6) << warm << " ns, "
+                  << "cold " << std::setw(6) << cold << " ns"
+                  << std::endl;
+    }
+
+
+    void measureAll(std::vector<std::string> words)
+    {
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+
+        std::vector<std::string> shuffled{words};
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{19});
+
+        std::vector<std::string> hotWords{
+            shuffled.begin(), shuffled.begin() + std::min<std::size_t>(HOT_WORD_COUNT, shuffled.size())};
+        std::vector<std::string> hotQueries = makeQueries(hotWords, 2 * hotWords.size());
+        std::vector<std::string> coldQueries = makeQueries(shuffled, 2 * shuffled.size());
+
+        std::cout << "  " << words.size() << " words" << std::endl;
+
+        {
+            AVLSet<std::string> set;
+            for (const std::string& word : shuffled)
+            {
+                set.add(word);
+            }
+            measure("AVLSet, add()", set, hotQueries, coldQueries);
+        }
+
+        AVLSet<std::string> sorted;
+        sorted.assignSorted(words.begin(), words.end());
+        measure("AVLSet, assignSorted()", sorted, hotQueries, coldQueries);
+
+        {
+            EytzingerSet<std::string> set{sorted};
+            measure("EytzingerSet", set, hotQueries, coldQueries);
+        }
+
+        {
+            HashSet<std::string> set{wyHash<std::string>};
+            for (const std::string& word : shuffled)
+            {
+                set.add(word);
+            }
+            measure("HashSet (wyhash)", set, hotQueries, coldQueries);
+        }
+    }
+}
+
+
+void runEytzingerSetBenchmark(const std::vector<std::string>& words)
+{
+    measureAll(words);
+
+    if (words.size() < LARGE_WORD_COUNT)
+    {
+        measureAll(syntheticWords(LARGE_WORD_COUNT));
+    }
+}
@@ -0,0 +1,63 @@
+// HashSetImageBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares what it costs to get a dictionary ready at startup: building a
+// HashSet one add() at a time, against opening a HashSetImage that was
+// written ahead of time (with and without verifying its checksum).  Also
+// compares lookups into each once they're ready.
+
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "HashSet.hpp"
+#include "HashSetImage.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LOOKUPS = 2000000;
+}
+
+
+void runHashSetImageBenchmark(const std::vector<std::string>& words)
+{
+    std::string path = "HashSetImageBenchmark.img";
+
+    Stopwatch watch;
+    HashSet<std::string> set{benchmarkHash};
+    for (const std::string& word : words)
+    {
+        set.add(word);
+    }
+    double buildSeconds = watch.seconds();
+
+    watch.restart();
+    HashSetImage::write(path, words.begin(), words.end(), benchmarkHash);
+    double writeSeconds = watch.seconds();
+
+    watch.restart();
+    double verifiedSeconds;
+    {
+        HashSetImage verified{path, benchmarkHash, true};
+        verifiedSeconds = watch.seconds();
+    }
+
+    watch.restart();
+    HashSetImage image{path, benchmarkHash, false};
+    double openSeconds = watch.seconds();
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "  build HashSet with add():     " << buildSeconds * 1e3 << " ms" << std::endl
+              << "  write image (done ahead):     " << writeSeconds * 1e3 << " ms" << std::endl
+              << "  open image, verify checksum:  " << verifiedSeconds * 1e3 << " ms" << std::endl
+              << "  open image, header only:      " << openSeconds * 1e3 << " ms" << std::endl
+              << std::setprecision(1)
+              << "  lookups: HashSet " << nanosecondsPerLookup(set, words, LOOKUPS) << " ns, "
+              << "image " << nanosecondsPerLookup(image, words, LOOKUPS) << " ns" << std::endl;
+
+    std::remove(path.c_str());
+}
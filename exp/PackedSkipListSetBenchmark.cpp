@@ -0,0 +1,53 @@
+// PackedSkipListSetBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares a PackedSkipListSet, which keeps each element and its "next"
+// pointers in one tower, against a SkipListSet, which has a two-pointer
+// node for every level of every element: how long each takes to build
+// (adding the words in a scattered order and in ascending order), how
+// much memory each takes, and how long lookups take.  This is done for
+// the given words and, if there are fewer than that, for a million
+// synthetic ones.
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "PackedSkipListSet.hpp"
+#include "SkipListSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LARGE_WORD_COUNT = 1000000;
+
+
+    void measureAll(std::vector<std::string> words)
+    {
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+
+        std::vector<std::string> shuffled{words};
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{46});
+
+        std::cout << "  " << words.size() << " words" << std::endl;
+        measureBuildMemoryLookup<SkipListSet<std::string>>("SkipListSet, scattered", shuffled, words);
+        measureBuildMemoryLookup<SkipListSet<std::string>>("SkipListSet, ascending", words, words);
+        measureBuildMemoryLookup<PackedSkipListSet<std::string>>("PackedSkipListSet, scattered", shuffled, words);
+        measureBuildMemoryLookup<PackedSkipListSet<std::string>>("PackedSkipListSet, ascending", words, words);
+    }
+}
+
+
+void runPackedSkipListSetBenchmark(const std::vector<std::string>& words)
+{
+    measureAll(words);
+
+    if (words.size() < LARGE_WORD_COUNT)
+    {
+        measureAll(syntheticWords(LARGE_WORD_COUNT));
+    }
+}
@@ -0,0 +1,70 @@
+// PerfectHashSetBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares PerfectHashSet against HashSet and AVLSet: how long each takes
+// to build from the word list, how much memory each allocates, and how
+// long a lookup takes.
+
+#include <iomanip>
+#include <iostream>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "HashSet.hpp"
+#include "PerfectHashSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LOOKUPS = 2000000;
+
+
+    void report(
+        const char* name, double buildSeconds, unsigned long long bytes,
+        const Set<std::string>& set, const std::vector<std::string>& words)
+    {
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  " << std::left << std::setw(15) << name << std::right
+                  << " build " << std::setw(8) << buildSeconds * 1e3 << " ms, "
+                  << std::setw(6) << static_cast<double>(bytes) / words.size() << " bytes/word, "
+                  << "lookup " << std::setw(6) << nanosecondsPerLookup(set, words, LOOKUPS) << " ns"
+                  << std::endl;
+    }
+}
+
+
+void runPerfectHashSetBenchmark(const std::vector<std::string>& words)
+{
+    {
+        unsigned long long before = liveHeapBytes();
+        Stopwatch watch;
+        PerfectHashSet set{words.begin(), words.end()};
+        double seconds = watch.seconds();
+        report("PerfectHashSet", seconds, liveHeapBytes() - before, set, words);
+
+        std::cout << std::setprecision(2) << "  (" << set.hashBitsPerElement()
+                  << " bits/word of hash function)" << std::endl;
+    }
+
+    {
+        unsigned long long before = liveHeapBytes();
+        Stopwatch watch;
+        HashSet<std::string> set{words.begin(), words.end(), benchmarkHash};
+        double seconds = watch.seconds();
+        report("HashSet", seconds, liveHeapBytes() - before, set, words);
+    }
+
+    {
+        unsigned long long before = liveHeapBytes();
+        Stopwatch watch;
+        AVLSet<std::string> set;
+        for (const std::string& word : words)
+        {
+            set.add(word);
+        }
+        double seconds = watch.seconds();
+        report("AVLSet", seconds, liveHeapBytes() - before, set, words);
+    }
+}
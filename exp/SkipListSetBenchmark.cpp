@@ -0,0 +1,51 @@
+// SkipListSetBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Compares a SkipListSet against an AVLSet: how long each takes to build
+// (adding the words in a scattered order and in ascending order), how
+// much memory each takes, and how long lookups take.  This is done for
+// the given words and, if there are fewer than that, for a million
+// synthetic ones.
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "SkipListSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LARGE_WORD_COUNT = 1000000;
+
+
+    void measureAll(std::vector<std::string> words)
+    {
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+
+        std::vector<std::string> shuffled{words};
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{46});
+
+        std::cout << "  " << words.size() << " words" << std::endl;
+        measureBuildMemoryLookup<AVLSet<std::string>>("AVLSet, scattered", shuffled, words);
+        measureBuildMemoryLookup<AVLSet<std::string>>("AVLSet, ascending", words, words);
+        measureBuildMemoryLookup<SkipListSet<std::string>>("SkipListSet, scattered", shuffled, words);
+        measureBuildMemoryLookup<SkipListSet<std::string>>("SkipListSet, ascending", words, words);
+    }
+}
+
+
+void runSkipListSetBenchmark(const std::vector<std::string>& words)
+{
+    measureAll(words);
+
+    if (words.size() < LARGE_WORD_COUNT)
+    {
+        measureAll(syntheticWords(LARGE_WORD_COUNT));
+    }
+}
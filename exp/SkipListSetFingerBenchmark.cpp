@@ -0,0 +1,116 @@
+// SkipListSetFingerBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Times sorted batches of lookups into a SkipListSet holding every word,
+// done once by looping over contains() and once with containsSorted().
+// Each batch is like the de-duplicated vocabulary of a document: words
+// picked at random, some of them misspelled, sorted, with the repeats
+// removed.  The bigger the batch, the closer together its words are in
+// the set, so the less a finger search has to skip over.
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "SkipListSet.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LOOKUPS_PER_RUN = 2000000;
+    constexpr unsigned int BATCHES = 16;
+
+
+    std::vector<std::vector<std::string>> makeBatches(const std::vector<std::string>& words, unsigned int batchSize)
+    {
+        std::vector<std::vector<std::string>> batches;
+        std::mt19937 engine{batchSize};
+        std::uniform_int_distribution<std::size_t> pick{0, words.size() - 1};
+
+        for (unsigned int b = 0; b < BATCHES; ++b)
+        {
+            std::vector<std::string> batch;
+            for (unsigned int i = 0; i < batchSize; ++i)
+            {
+                const std::string& word = words[pick(engine)];
+                batch.push_back(i % 4 == 0 ? misspell(word, i) : word);
+            }
+
+            std::sort(batch.begin(), batch.end());
+            batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+            batches.push_back(batch);
+        }
+
+        return batches;
+    }
+
+
+    void compareForBatchSize(
+        const SkipListSet<std::string>& set, const std::vector<std::string>& words,
+        unsigned int batchSize)
+    {
+        std::vector<std::vector<std::string>> batches = makeBatches(words, batchSize);
+        std::unique_ptr<bool[]> results{new bool[batchSize]};
+
+        unsigned long long lookups = 0;
+        unsigned int rounds = 0;
+        while (lookups < LOOKUPS_PER_RUN)
+        {
+            lookups += batches[rounds % BATCHES].size();
+            rounds++;
+        }
+
+        Stopwatch watch;
+        unsigned long long found = 0;
+        for (unsigned int r = 0; r < rounds; ++r)
+        {
+            for (const std::string& word : batches[r % BATCHES])
+            {
+                found += set.contains(word);
+            }
+        }
+        double loopSeconds = watch.seconds();
+        keep(found);
+
+        watch.restart();
+        found = 0;
+        for (unsigned int r = 0; r < rounds; ++r)
+        {
+            const std::vector<std::string>& batch = batches[r % BATCHES];
+            set.containsSorted(batch.begin(), batch.end(), results.get());
+            for (std::size_t i = 0; i < batch.size(); ++i)
+            {
+                found += results[i];
+            }
+        }
+        double fingerSeconds = watch.seconds();
+        keep(found);
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "  batch of " << std::setw(6) << batchSize << ": "
+                  << "contains() loop " << std::setw(6) << loopSeconds * 1e9 / lookups << " ns/lookup, "
+                  << "containsSorted() " << std::setw(6) << fingerSeconds * 1e9 / lookups << " ns/lookup, "
+                  << std::setprecision(2) << "speedup " << loopSeconds / fingerSeconds << "x"
+                  << std::endl;
+    }
+}
+
+
+void runSkipListSetFingerBenchmark(const std::vector<std::string>& words)
+{
+    SkipListSet<std::string> set;
+    for (const std::string& word : words)
+    {
+        set.add(word);
+    }
+
+    for (unsigned int batchSize : {100u, 1000u, 10000u, 100000u})
+    {
+        compareForBatchSize(set, words, batchSize);
+    }
+}
@@ -0,0 +1,76 @@
+// StringArenaBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Measures how many bytes per word HashSet and AVLSet allocate when they
+// store std::strings, against when they store ArenaStrings inside an
+// ArenaStringSet, along with lookup times.  It's done twice: once with
+// the words as given, and once with every word lengthened past what fits
+// inside a std::string object, which is when each std::string needs a
+// separately allocated block for its characters.
+
+#include <iomanip>
+#include <iostream>
+#include "ArenaStringSet.hpp"
+#include "AVLSet.hpp"
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "HashSet.hpp"
+#include "StringArena.hpp"
+
+
+namespace
+{
+    constexpr unsigned int LOOKUPS = 1000000;
+
+
+    template <typename SetType, typename... Args>
+    void measure(const char* name, const std::vector<std::string>& words, Args&&... args)
+    {
+        unsigned long long before = liveHeapBytes();
+        SetType set{std::forward<Args>(args)...};
+        for (const std::string& word : words)
+        {
+            set.add(word);
+        }
+        unsigned long long bytes = liveHeapBytes() - before;
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "    " << std::left << std::setw(36) << name << std::right
+                  << std::setw(6) << static_cast<double>(bytes) / words.size() << " bytes/word, "
+                  << "lookup " << std::setw(6) << nanosecondsPerLookup(set, words, LOOKUPS) << " ns"
+                  << std::endl;
+    }
+
+
+    void measureAll(const std::vector<std::string>& words)
+    {
+        double characters = 0;
+        for (const std::string& word : words)
+        {
+            characters += word.size();
+        }
+        std::cout << "  average word length " << std::setprecision(1) << characters / words.size()
+                  << std::endl;
+
+        measure<HashSet<std::string>>("HashSet<std::string>", words, benchmarkHash);
+        measure<ArenaStringSet<HashSet<ArenaString>>>(
+            "ArenaStringSet<HashSet<ArenaString>>", words, hashArenaString);
+        measure<AVLSet<std::string>>("AVLSet<std::string>", words);
+        measure<ArenaStringSet<AVLSet<ArenaString>>>("ArenaStringSet<AVLSet<ArenaString>>", words);
+    }
+}
+
+
+void runStringArenaBenchmark(const std::vector<std::string>& words)
+{
+    measureAll(words);
+
+    std::vector<std::string> longWords;
+    for (const std::string& word : words)
+    {
+        longWords.push_back(word + "ISTICALNESS");
+    }
+    measureAll(longWords);
+}
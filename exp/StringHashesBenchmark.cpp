@@ -0,0 +1,124 @@
+// StringHashesBenchmark.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Measures the hash functions in StringHashes.hpp two ways: how many bytes
+// per second each one hashes at several key lengths, and how evenly each
+// spreads the word list across a HashSet's array (compared against the
+// kind of weak hash that sums the characters).
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
+#include "HashSet.hpp"
+#include "StringHashes.hpp"
+
+
+namespace
+{
+    constexpr unsigned long long BYTES_PER_LENGTH = 256ull * 1024 * 1024;
+    constexpr unsigned int LOOKUPS = 2000000;
+
+
+    using Hash64 = unsigned long long (*)(const char*, std::size_t, unsigned long long);
+    using Hash32 = unsigned int (*)(const std::string&);
+
+
+    unsigned int sumOfCharactersHash(const std::string& s)
+    {
+        unsigned int sum = 0;
+        for (char c : s)
+        {
+            sum += static_cast<unsigned char>(c);
+        }
+        return sum;
+    }
+
+
+    double gigabytesPerSecond(Hash64 hash, unsigned int length)
+    {
+        // enough keys that they don't all sit in the L1 cache
+        std::string buffer(length + 4096, 'X');
+        for (std::size_t i = 0; i < buffer.size(); ++i)
+        {
+            buffer[i] = static_cast<char>('A' + (i * 7919) % 26);
+        }
+
+        unsigned long long calls = BYTES_PER_LENGTH / length;
+        unsigned long long total = 0;
+
+        Stopwatch watch;
+        for (unsigned long long i = 0; i < calls; ++i)
+        {
+            total += hash(buffer.data() + (i * 64) % 4096, length, total);
+        }
+        double seconds = watch.seconds();
+
+        keep(total);
+        return static_cast<double>(calls) * length / seconds / 1e9;
+    }
+
+
+    void reportDistribution(const char* name, Hash32 hash, const std::vector<std::string>& words)
+    {
+        HashSet<std::string> set{words.begin(), words.end(), hash};
+        double nanoseconds = nanosecondsPerLookup(set, words, LOOKUPS);
+        HashSetStats stats = set.stats();
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "  " << std::left << std::setw(14) << name << std::right
+                  << " occupied " << std::setw(6)
+                  << 100.0 * stats.occupiedIndexes / stats.capacity << "%, "
+                  << "mean chain " << std::setw(7) << stats.meanChainLength() << ", "
+                  << "longest " << std::setw(6) << stats.longestChain << ", "
+                  << "probes/lookup " << std::setw(7) << stats.probesPerLookup() << ", "
+                  << std::setprecision(1) << "lookup " << std::setw(7) << nanoseconds << " ns"
+                  << std::endl;
+    }
+}
+
+
+void runStringHashesBenchmark(const std::vector<std::string>& words)
+{
+    struct NamedHash
+    {
+        const char* name;
+        Hash64 hash;
+    };
+
+    const NamedHash hashes[] = {
+        {"fnv1a", fnv1aHash64},
+        {"wyhash", wyHash64},
+        {"xxh3", xxh3Hash64},
+        {"xxh3 (scalar)", xxh3Hash64Scalar}
+    };
+
+    std::cout << "Throughput (GB/s) by key length:" << std::endl;
+    std::cout << "  " << std::setw(14) << "";
+    for (unsigned int length : {4u, 8u, 16u, 32u, 64u, 256u, 1024u, 4096u})
+    {
+        std::cout << std::setw(8) << length;
+    }
+    std::cout << std::endl;
+
+    for (const NamedHash& h : hashes)
+    {
+        std::cout << "  " << std::left << std::setw(14) << h.name << std::right
+                  << std::fixed << std::setprecision(2);
+        for (unsigned int length : {4u, 8u, 16u, 32u, 64u, 256u, 1024u, 4096u})
+        {
+            std::cout << std::setw(8) << gigabytesPerSecond(h.hash, length);
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "Distribution of " << words.size() << " words in a HashSet:" << std::endl;
+    reportDistribution("sum of chars", sumOfCharactersHash, words);
+    reportDistribution("fnv1a", fnv1aHash<std::string>, words);
+    reportDistribution("wyhash", wyHash<std::string>, words);
+    reportDistribution("xxh3", xxh3Hash<std::string>, words);
+}
@@ -6,12 +6,89 @@
 // Do whatever you'd like here.  This is intended to allow you to experiment
 // with your code, outside of the context of the broader program or Google
 // Test.
+//
+// Runs one of the benchmarks declared in Benchmarks.hpp:
+//
+//     exp <benchmark> [word file]
+//
+// When no word file is given, a list of synthetic words is used instead.
 
+#include <iostream>
+#include <string>
+#include <vector>
+#include "BenchmarkSupport.hpp"
+#include "Benchmarks.hpp"
 
-int main()
+
+namespace
 {
+    struct Benchmark
+    {
+        const char* name;
+        void (*run)(const std::vector<std::string>& words);
+    };
+
+
+    const Benchmark benchmarks[] = {
+        {"containsMany", runContainsManyBenchmark},
+        {"concurrentHashSet", runConcurrentHashSetBenchmark},
+        {"hashSetImage", runHashSetImageBenchmark},
+        {"perfectHashSet", runPerfectHashSetBenchmark},
+        {"stringArena", runStringArenaBenchmark},
+        {"stringHashes", runStringHashesBenchmark},
+        {"avlSetBuild", runAVLSetBuildBenchmark},
+        {"eytzingerSet", runEytzingerSetBenchmark},
+        {"bPlusTreeSet", runBPlusTreeSetBenchmark},
+        {"avlSetMerge", runAVLSetMergeBenchmark},
+        {"skipListSet", runSkipListSetBenchmark},
+        {"concurrentSkipListSet", runConcurrentSkipListSetBenchmark},
+        {"skipListSetFinger", runSkipListSetFingerBenchmark},
+        {"packedSkipListSet", runPackedSkipListSetBenchmark},
+    };
 
 
-    return 0;
+    constexpr unsigned int SYNTHETIC_WORD_COUNT = 200000;
 }
 
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "usage: " << argv[0] << " <benchmark> [word file]" << std::endl;
+        std::cout << "benchmarks:" << std::endl;
+        for (const Benchmark& benchmark : benchmarks)
+        {
+            std::cout << "    " << benchmark.name << std::endl;
+        }
+        return 0;
+    }
+
+    std::vector<std::string> words;
+    if (argc >= 3)
+    {
+        words = loadWords(argv[2]);
+        if (words.empty())
+        {
+            std::cout << "ERROR: no words could be read from " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        words = syntheticWords(SYNTHETIC_WORD_COUNT);
+    }
+
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        if (argv[1] == std::string{benchmark.name})
+        {
+            std::cout << benchmark.name << ": " << words.size() << " words" << std::endl;
+            benchmark.run(words);
+            return 0;
+        }
+    }
+
+    std::cout << "ERROR: unknown benchmark " << argv[1] << std::endl;
+    return 1;
+}
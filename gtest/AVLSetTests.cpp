@@ -0,0 +1,742 @@
+// AVLSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the parts of AVLSet that go beyond what the sanity
+// checks cover.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AllocationCounter.hpp"
+#include "AVLSet.hpp"
+
+
+TEST(AVLSetTests, movingStealsTheNodesWithoutAllocating)
+{
+    AVLSet<std::string> s;
+    s.add("HELLO");
+    s.add("THERE");
+    s.add("BOO");
+
+    unsigned long long before = allocationCount();
+    AVLSet<std::string> moved{std::move(s)};
+    AVLSet<std::string> assigned;
+    assigned = std::move(moved);
+    moved.swap(assigned);
+    unsigned long long after = allocationCount();
+
+    EXPECT_EQ(before, after);
+
+    EXPECT_EQ(3, moved.size());
+    EXPECT_TRUE(moved.contains("BOO"));
+    EXPECT_EQ(0, assigned.size());
+    EXPECT_FALSE(assigned.contains("BOO"));
+    EXPECT_EQ(0, s.size());
+    EXPECT_EQ(-1, s.height());
+}
+
+
+TEST(AVLSetTests, addingADuplicateHasNoEffect)
+{
+    AVLSet<int> balanced;
+    AVLSet<int> notBalanced{false};
+    for (int i : {5, 3, 8, 3, 5, 8})
+    {
+        balanced.add(i);
+        notBalanced.add(i);
+    }
+
+    EXPECT_EQ(3, balanced.size());
+    EXPECT_EQ(3, notBalanced.size());
+    EXPECT_EQ(1, balanced.height());
+    EXPECT_EQ(1, notBalanced.height());
+}
+
+
+TEST(AVLSetTests, rotationsKeepTheElementsInOrder)
+{
+    // these orders need each of the four kinds of rotation
+    for (std::vector<int> order : std::vector<std::vector<int>>{
+             {1, 2, 3}, {3, 2, 1}, {3, 1, 2}, {1, 3, 2}, {50, 20, 80, 10, 30, 25, 27, 26}})
+    {
+        AVLSet<int> s;
+        for (int i : order)
+        {
+            s.add(i);
+        }
+
+        std::vector<int> visited;
+        s.inorder([&](int i) { visited.push_back(i); });
+
+        std::sort(order.begin(), order.end());
+        EXPECT_EQ(order, visited);
+    }
+}
+
+
+TEST(AVLSetTests, heightStaysLogarithmicForSortedKeys)
+{
+    constexpr int count = 1000000;
+    AVLSet<int> s;
+    for (int i = 0; i < count; ++i)
+    {
+        s.add(i);
+    }
+
+    // an AVL tree with n nodes is never taller than about 1.44 log2(n + 2)
+    EXPECT_EQ(count, s.size());
+    EXPECT_LE(s.height(), static_cast<int>(1.4405 * std::log2(count + 2.0)));
+
+    // a degenerate tree would need about 500 billion comparisons for this,
+    // rather than a few tens of millions
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i)
+    {
+        ASSERT_TRUE(s.contains(i));
+    }
+    EXPECT_FALSE(s.contains(count));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_LT(elapsed, std::chrono::seconds{5});
+}
+
+
+TEST(AVLSetTests, unbalancedTreeKeepsTrackOfItsHeight)
+{
+    AVLSet<int> s{false};
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+    s.add(-1);
+
+    EXPECT_EQ(999, s.height());
+}
+
+
+TEST(AVLSetTests, assignSortedBuildsAPerfectlyBalancedTree)
+{
+    std::vector<int> elements;
+    for (int i = 0; i < 1000; ++i)
+    {
+        elements.push_back(i * 2);
+    }
+
+    AVLSet<int> s;
+    s.add(-5);
+    s.assignSorted(elements.begin(), elements.end());
+
+    EXPECT_EQ(1000, s.size());
+    EXPECT_EQ(9, s.height());
+    EXPECT_FALSE(s.contains(-5));
+
+    std::vector<int> visited;
+    s.inorder([&](int i) { visited.push_back(i); });
+    EXPECT_EQ(elements, visited);
+
+    // it's still an AVL tree afterward
+    for (int i = 2000; i < 3000; ++i)
+    {
+        s.add(i);
+    }
+    EXPECT_LE(s.height(), 11);
+    EXPECT_TRUE(s.contains(998));
+}
+
+
+TEST(AVLSetTests, assignSortedAllocatesOnceForAForwardRange)
+{
+    std::vector<int> elements;
+    for (int i = 0; i < 100000; ++i)
+    {
+        elements.push_back(i);
+    }
+
+    AVLSet<int> s;
+    s.assignSorted(elements.begin(), elements.end(), false);
+
+    // growing block by block would take at least a dozen
+    EXPECT_EQ(1, s.nodeBlockCount());
+    EXPECT_EQ(100000, s.size());
+    EXPECT_EQ(16, s.height());
+}
+
+
+TEST(AVLSetTests, assignSortedSkipsRepeatsAndAcceptsSinglePassRanges)
+{
+    std::istringstream in{"ALPHA ALPHA BETA DELTA DELTA DELTA GAMMA"};
+    AVLSet<std::string> s;
+    s.assignSorted(std::istream_iterator<std::string>{in}, std::istream_iterator<std::string>{});
+
+    EXPECT_EQ(4, s.size());
+    EXPECT_TRUE(s.contains("ALPHA"));
+    EXPECT_TRUE(s.contains("GAMMA"));
+    EXPECT_EQ(2, s.height());
+}
+
+
+TEST(AVLSetTests, assignSortedRejectsUnsortedInputWithoutChangingTheSet)
+{
+    std::vector<std::string> words{"BOO", "HELLO", "HI", "THERE", "ALPHA"};
+    AVLSet<std::string> s;
+    s.add("EXISTING");
+
+    EXPECT_THROW(s.assignSorted(words.begin(), words.end()), SetException);
+
+    EXPECT_EQ(1, s.size());
+    EXPECT_TRUE(s.contains("EXISTING"));
+    EXPECT_FALSE(s.contains("BOO"));
+}
+
+
+namespace
+{
+    // builds the tree that adding 50, 30, 70, 20, 40, 60, 80, 35, 45
+    // without balancing makes:
+    //
+    //            50
+    //        30      70
+    //      20  40  60  80
+    //         35 45
+    AVLSet<int> sampleTree()
+    {
+        AVLSet<int> s{false};
+        for (int i : {50, 30, 70, 20, 40, 60, 80, 35, 45})
+        {
+            s.add(i);
+        }
+        return s;
+    }
+}
+
+
+TEST(AVLSetTests, traversalsVisitInTheRightOrder)
+{
+    AVLSet<int> s = sampleTree();
+    std::vector<int> pre;
+    std::vector<int> in;
+    std::vector<int> post;
+
+    s.preorder([&](int i) { pre.push_back(i); });
+    s.inorder([&](int i) { in.push_back(i); });
+    s.postorder([&](int i) { post.push_back(i); });
+
+    EXPECT_EQ((std::vector<int>{50, 30, 20, 40, 35, 45, 70, 60, 80}), pre);
+    EXPECT_EQ((std::vector<int>{20, 30, 35, 40, 45, 50, 60, 70, 80}), in);
+    EXPECT_EQ((std::vector<int>{20, 35, 45, 40, 30, 60, 80, 70, 50}), post);
+}
+
+
+TEST(AVLSetTests, visitFunctionsStillWork)
+{
+    AVLSet<int> s = sampleTree();
+    std::vector<int> post;
+    AVLSet<int>::VisitFunction visit = [&](const int& i) { post.push_back(i); };
+
+    s.postorder(visit);
+
+    EXPECT_EQ((std::vector<int>{20, 35, 45, 40, 30, 60, 80, 70, 50}), post);
+}
+
+
+TEST(AVLSetTests, traversalsOfAnEmptyTreeVisitNothing)
+{
+    AVLSet<int> s;
+    int visits = 0;
+    s.preorder([&](int) { ++visits; });
+    s.inorder([&](int) { ++visits; });
+    s.postorder([&](int) { ++visits; });
+
+    EXPECT_EQ(0, visits);
+    EXPECT_EQ(s.begin(), s.end());
+}
+
+
+TEST(AVLSetTests, traversalsOfADegenerateTreeDontOverflowTheStack)
+{
+    // a tree this tall would take megabytes of stack to traverse
+    // recursively
+    constexpr int count = 50000;
+    AVLSet<int> s{false};
+    for (int i = 0; i < count; ++i)
+    {
+        s.add(i);
+    }
+
+    long long preSum = 0;
+    int last = -1;
+    bool ascending = true;
+    int postFirst = -1;
+
+    s.preorder([&](int i) { preSum += i; });
+    s.inorder([&](int i) { ascending = ascending && i == last + 1; last = i; });
+    s.postorder([&](int i) { if (postFirst < 0) postFirst = i; });
+
+    EXPECT_EQ(static_cast<long long>(count) * (count - 1) / 2, preSum);
+    EXPECT_TRUE(ascending);
+    EXPECT_EQ(count - 1, postFirst);
+}
+
+
+TEST(AVLSetTests, iteratorsWalkInOrderInBothDirections)
+{
+    AVLSet<int> s;
+    for (int i : {50, 30, 70, 20, 40, 60, 80, 35, 45, 10})
+    {
+        s.add(i);
+    }
+
+    std::vector<int> forward{s.begin(), s.end()};
+    EXPECT_EQ((std::vector<int>{10, 20, 30, 35, 40, 45, 50, 60, 70, 80}), forward);
+
+    std::vector<int> backward;
+    for (auto i = s.end(); i != s.begin();)
+    {
+        --i;
+        backward.push_back(*i);
+    }
+    std::reverse(backward.begin(), backward.end());
+    EXPECT_EQ(forward, backward);
+}
+
+
+TEST(AVLSetTests, iteratingAMillionElementsAllocatesNothing)
+{
+    std::vector<int> elements;
+    for (int i = 0; i < 1000000; ++i)
+    {
+        elements.push_back(i);
+    }
+
+    AVLSet<int> s;
+    s.assignSorted(elements.begin(), elements.end());
+
+    unsigned long long before = allocationCount();
+    long long sum = 0;
+    for (int i : s)
+    {
+        sum += i;
+    }
+    EXPECT_EQ(before, allocationCount());
+    EXPECT_EQ(999999LL * 1000000 / 2, sum);
+}
+
+
+TEST(AVLSetTests, copiesHaveTheSameShapeAndAreIndependent)
+{
+    AVLSet<int> s = sampleTree();
+    AVLSet<int> copy{s};
+    copy.add(100);
+
+    std::vector<int> originalOrder;
+    std::vector<int> copyOrder;
+    s.preorder([&](int i) { originalOrder.push_back(i); });
+    copy.preorder([&](int i) { copyOrder.push_back(i); });
+    copyOrder.pop_back();
+
+    EXPECT_EQ(originalOrder, copyOrder);
+    EXPECT_EQ(9, s.size());
+    EXPECT_EQ(10, copy.size());
+    EXPECT_EQ(3, s.height());
+    EXPECT_FALSE(s.contains(100));
+
+    // the copy isn't balanced either, so 100 goes to the far right
+    EXPECT_EQ(3, copy.height());
+}
+
+
+TEST(AVLSetTests, copiesOfBalancedTreesKeepBalancing)
+{
+    AVLSet<int> s;
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(i);
+    }
+
+    AVLSet<int> copy{s};
+    EXPECT_EQ(1, copy.nodeBlockCount());
+
+    for (int i = 100; i < 1000; ++i)
+    {
+        copy.add(i);
+    }
+
+    EXPECT_EQ(1000, copy.size());
+    EXPECT_LE(copy.height(), 14);
+    std::vector<int> visited{copy.begin(), copy.end()};
+    EXPECT_TRUE(std::is_sorted(visited.begin(), visited.end()));
+    EXPECT_EQ(100, s.size());
+}
+
+
+TEST(AVLSetTests, copyAssignmentReplacesTheContents)
+{
+    AVLSet<std::string> s;
+    s.add("HELLO");
+    s.add("THERE");
+
+    AVLSet<std::string> other;
+    other.add("BOO");
+    other = s;
+    other = other;
+
+    EXPECT_EQ(2, other.size());
+    EXPECT_TRUE(other.contains("HELLO"));
+    EXPECT_FALSE(other.contains("BOO"));
+    EXPECT_EQ(1, other.height());
+}
+
+
+TEST(AVLSetTests, clearEmptiesTheSetForReuse)
+{
+    AVLSet<std::string> s;
+    for (std::string word : {"HELLO", "THERE", "BOO", "HI"})
+    {
+        s.add(word);
+    }
+
+    s.clear();
+
+    EXPECT_EQ(0, s.size());
+    EXPECT_EQ(-1, s.height());
+    EXPECT_FALSE(s.contains("HELLO"));
+    EXPECT_EQ(s.begin(), s.end());
+
+    s.add("AGAIN");
+    EXPECT_EQ(1, s.size());
+    EXPECT_TRUE(s.contains("AGAIN"));
+}
+
+
+TEST(AVLSetTests, boundsFindTheNeighborsOfAnElement)
+{
+    AVLSet<int> s = sampleTree();
+
+    EXPECT_EQ(40, *s.lowerBound(40));
+    EXPECT_EQ(45, *s.upperBound(40));
+    EXPECT_EQ(45, *s.lowerBound(41));
+    EXPECT_EQ(45, *s.upperBound(41));
+    EXPECT_EQ(20, *s.lowerBound(-1000));
+    EXPECT_EQ(s.end(), s.lowerBound(81));
+    EXPECT_EQ(s.end(), s.upperBound(80));
+
+    std::vector<int> range{s.lowerBound(35), s.lowerBound(60)};
+    EXPECT_EQ((std::vector<int>{35, 40, 45, 50}), range);
+
+    AVLSet<int> empty;
+    EXPECT_EQ(empty.end(), empty.lowerBound(1));
+}
+
+
+TEST(AVLSetTests, forEachWithPrefixVisitsCompletionsInOrder)
+{
+    std::vector<std::string> words{
+        "CAR", "CARD", "CARDS", "CARE", "CARGO", "CART", "CAT", "CATALOG", "DOG", "CA"};
+    std::sort(words.begin(), words.end());
+
+    AVLSet<std::string> s;
+    s.assignSorted(words.begin(), words.end());
+
+    std::vector<std::string> completions;
+    unsigned int count = s.forEachWithPrefix(
+        "CAR", [&](const std::string& word) { completions.push_back(word); });
+
+    EXPECT_EQ(6, count);
+    EXPECT_EQ((std::vector<std::string>{"CAR", "CARD", "CARDS", "CARE", "CARGO", "CART"}), completions);
+
+    completions.clear();
+    EXPECT_EQ(2, s.forEachWithPrefix("CA", [&](const std::string& word) { completions.push_back(word); }, 2));
+    EXPECT_EQ((std::vector<std::string>{"CA", "CAR"}), completions);
+
+    EXPECT_EQ(0, s.forEachWithPrefix("CB", [](const std::string&) {}));
+    EXPECT_EQ(0, s.forEachWithPrefix("DOGS", [](const std::string&) {}));
+    EXPECT_EQ(10, s.forEachWithPrefix("", [](const std::string&) {}));
+}
+
+
+TEST(AVLSetTests, rankAndSelectAreInverses)
+{
+    AVLSet<int> s;
+    for (int i = 0; i < 1000; ++i)
+    {
+        // in a scrambled order, so that every kind of rotation happens
+        s.add((i * 389) % 1000 * 2);
+    }
+
+    for (unsigned int i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(static_cast<int>(i * 2), *s.select(i));
+        ASSERT_EQ(i, s.rank(i * 2));
+        ASSERT_EQ(i + 1, s.rank(i * 2 + 1));
+    }
+
+    EXPECT_EQ(0, s.rank(-5));
+    EXPECT_EQ(1000, s.rank(5000));
+    EXPECT_EQ(s.end(), s.select(1000));
+}
+
+
+TEST(AVLSetTests, rankAndSelectWorkOnEveryKindOfTree)
+{
+    std::vector<int> elements;
+    for (int i = 0; i < 100; ++i)
+    {
+        elements.push_back(i);
+    }
+
+    AVLSet<int> built;
+    built.assignSorted(elements.begin(), elements.end());
+    AVLSet<int> copied{built};
+    AVLSet<int> unbalanced{false};
+    for (int i : {50, 30, 70, 20, 40, 60, 80, 35, 45})
+    {
+        unbalanced.add(i);
+    }
+
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(static_cast<int>(i), *built.select(i));
+        EXPECT_EQ(i, copied.rank(static_cast<int>(i)));
+    }
+
+    EXPECT_EQ(4, unbalanced.rank(45));
+    EXPECT_EQ(60, *unbalanced.select(6));
+}
+
+
+namespace
+{
+    AVLSet<int> randomSet(unsigned int count, int range, unsigned int seed, std::set<int>& expected)
+    {
+        AVLSet<int> s;
+        std::mt19937 random{seed};
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            int n = static_cast<int>(random() % range);
+            s.add(n);
+            expected.insert(n);
+        }
+        return s;
+    }
+
+
+    // checks the elements, and also that the parent pointers (which the
+    // iterators follow backward), subtree counts (which select() uses),
+    // and heights were all kept up to date
+    void expectSameAs(const AVLSet<int>& s, const std::set<int>& expected)
+    {
+        ASSERT_EQ(expected.size(), s.size());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), s.begin()));
+        EXPECT_TRUE(std::equal(expected.rbegin(), expected.rend(), std::make_reverse_iterator(s.end())));
+        EXPECT_LE(s.height(), 1.45 * std::log2(expected.size() + 2));
+
+        unsigned int position = 0;
+        for (int element : expected)
+        {
+            ASSERT_EQ(element, *s.select(position));
+            position++;
+        }
+    }
+}
+
+
+TEST(AVLSetTests, setOperationsMatchTheirDefinitions)
+{
+    for (unsigned int seed = 0; seed < 20; ++seed)
+    {
+        std::set<int> a;
+        std::set<int> b;
+        AVLSet<int> sa = randomSet(50 + seed * 37, 2000, seed, a);
+        AVLSet<int> sb = randomSet(10 + seed * 61, 2000, seed + 100, b);
+
+        std::set<int> expected;
+        AVLSet<int> s{sa};
+        s.unionWith(sb);
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+        expectSameAs(s, expected);
+
+        expected.clear();
+        s = sa;
+        s.intersect(sb);
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+        expectSameAs(s, expected);
+
+        expected.clear();
+        s = sa;
+        s.difference(sb);
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()));
+        expectSameAs(s, expected);
+
+        // the other set is never changed
+        expectSameAs(sb, b);
+    }
+}
+
+
+TEST(AVLSetTests, setOperationsWorkInParallelOnLargeSets)
+{
+    std::set<int> base;
+    std::set<int> overlay;
+    AVLSet<int> sbase = randomSet(200000, 1000000, 46, base);
+    AVLSet<int> soverlay = randomSet(50000, 1000000, 19, overlay);
+
+    std::set<int> expected{base};
+    expected.insert(overlay.begin(), overlay.end());
+    AVLSet<int> s{sbase};
+    s.unionWith(soverlay);
+    expectSameAs(s, expected);
+
+    expected.clear();
+    std::set_difference(base.begin(), base.end(), overlay.begin(), overlay.end(), std::inserter(expected, expected.end()));
+    s = sbase;
+    s.difference(soverlay);
+    expectSameAs(s, expected);
+}
+
+
+TEST(AVLSetTests, setOperationsWithItselfOrAnEmptySet)
+{
+    std::set<int> a;
+    AVLSet<int> s = randomSet(100, 1000, 7, a);
+    AVLSet<int> empty;
+
+    s.unionWith(s);
+    s.intersect(s);
+    expectSameAs(s, a);
+
+    s.unionWith(empty);
+    s.difference(empty);
+    expectSameAs(s, a);
+
+    empty.unionWith(s);
+    expectSameAs(empty, a);
+
+    s.intersect(AVLSet<int>{});
+    expectSameAs(s, std::set<int>{});
+
+    empty.difference(empty);
+    EXPECT_EQ(0, empty.size());
+}
+
+
+namespace
+{
+    // an element that keeps track of how many of its kind are alive, so
+    // that a test can tell how many nodes a set's pool is holding on to
+    struct Counted
+    {
+        static int alive;
+
+        int value;
+
+        Counted(int value = 0) : value{value} { alive++; }
+        Counted(const Counted& c) : value{c.value} { alive++; }
+        ~Counted() { alive--; }
+
+        bool operator<(const Counted& c) const { return value < c.value; }
+        bool operator>(const Counted& c) const { return value > c.value; }
+        bool operator==(const Counted& c) const { return value == c.value; }
+    };
+
+    int Counted::alive = 0;
+}
+
+
+TEST(AVLSetTests, droppedNodesDontPileUpInThePool)
+{
+    {
+        AVLSet<Counted> s;
+        AVLSet<Counted> same;
+        for (int i = 0; i < 1000; ++i)
+        {
+            s.add(Counted{i});
+            same.add(Counted{i});
+        }
+
+        // every union drops all 1000 of s's own nodes in favor of copies
+        // of the other set's; without anything to bound it, the pool
+        // would end up holding 100000 nodes
+        for (int i = 0; i < 100; ++i)
+        {
+            s.unionWith(same);
+            ASSERT_EQ(1000, s.size());
+            ASSERT_LE(Counted::alive, 1000 + 3 * 1000);
+        }
+
+        for (int i = 0; i < 100; ++i)
+        {
+            AVLSet<Counted> copy{s};
+            copy.difference(same);
+            ASSERT_EQ(0, copy.size());
+            copy.unionWith(same);
+            copy.intersect(same);
+            ASSERT_EQ(1000, copy.size());
+            ASSERT_LE(Counted::alive, 2 * 1000 + 3 * 1000);
+        }
+
+        EXPECT_TRUE(s.contains(Counted{999}));
+        EXPECT_FALSE(s.contains(Counted{1000}));
+    }
+
+    EXPECT_EQ(0, Counted::alive);
+}
+
+
+TEST(AVLSetTests, joinTakesOverTheNodesOfALargerSet)
+{
+    AVLSet<int> small;
+    AVLSet<int> large;
+    std::set<int> expected;
+    for (int i = 0; i < 10; ++i)
+    {
+        small.add(i);
+        expected.insert(i);
+    }
+    for (int i = 100; i < 10000; ++i)
+    {
+        large.add(i);
+        expected.insert(i);
+    }
+
+    unsigned long long before = allocationCount();
+    small.join(std::move(large));
+    EXPECT_EQ(before, allocationCount());
+
+    expectSameAs(small, expected);
+    EXPECT_EQ(0, large.size());
+    EXPECT_TRUE(large.begin() == large.end());
+
+    // the nodes taken over stay valid after the other set is gone
+    large.add(5);
+    EXPECT_TRUE(small.contains(9999));
+}
+
+
+TEST(AVLSetTests, joinRejectsOverlappingOrUnbalancedSets)
+{
+    AVLSet<int> s;
+    AVLSet<int> t;
+    s.add(1);
+    s.add(5);
+    t.add(5);
+    t.add(6);
+
+    EXPECT_THROW(s.join(std::move(t)), SetException);
+    EXPECT_EQ(2, s.size());
+    EXPECT_EQ(2, t.size());
+
+    AVLSet<int> unbalanced{false};
+    unbalanced.add(10);
+    EXPECT_THROW(s.join(std::move(unbalanced)), SetException);
+    EXPECT_THROW(s.unionWith(unbalanced), SetException);
+    EXPECT_THROW(unbalanced.intersect(s), SetException);
+}
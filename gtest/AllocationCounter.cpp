@@ -0,0 +1,102 @@
+// AllocationCounter.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+
+#include "AllocationCounter.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+namespace
+{
+    std::atomic<unsigned long long> allocations{0};
+
+
+    // every form of operator new comes here, so that each is counted and
+    // everything is freed with std::free(), no matter which form of
+    // operator delete is called on it
+    void* allocate(std::size_t size) noexcept
+    {
+        allocations++;
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+
+    void* allocateOrThrow(std::size_t size)
+    {
+        void* p = allocate(size);
+        if (p == nullptr)
+        {
+            throw std::bad_alloc{};
+        }
+        return p;
+    }
+}
+
+
+unsigned long long allocationCount() noexcept
+{
+    return allocations.load();
+}
+
+
+void* operator new(std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+
+void* operator new[](std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
@@ -0,0 +1,25 @@
+// AllocationCounter.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// The test program replaces the global operator new with one that counts
+// how many times it's been called, so that tests can check that some
+// operation allocates nothing:
+//
+//     unsigned long long before = allocationCount();
+//     ... operation ...
+//     EXPECT_EQ(before, allocationCount());
+
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+
+
+// allocationCount() returns the number of times the global operator new
+// has been called so far, by any thread.
+unsigned long long allocationCount() noexcept;
+
+
+
+#endif // ALLOCATIONCOUNTER_HPP
@@ -0,0 +1,190 @@
+// BPlusTreeSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for BPlusTreeSet.
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "BPlusTreeSet.hpp"
+
+
+namespace
+{
+    template <typename ElementType>
+    void expectSameAs(const BPlusTreeSet<ElementType>& s, const std::set<ElementType>& expected)
+    {
+        ASSERT_EQ(expected.size(), s.size());
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), s.begin()));
+
+        for (const ElementType& element : expected)
+        {
+            ASSERT_TRUE(s.contains(element));
+        }
+    }
+
+
+    // strings that share long prefixes, so that many keys have the same
+    // slice and the searches have to fall back to comparing the keys
+    std::string wordFor(unsigned int n)
+    {
+        std::string word = "PREFIXED" + std::to_string(n % 10);
+        for (unsigned int i = 0; i < n % 7; ++i)
+        {
+            word += static_cast<char>('A' + (n / 10 + i) % 26);
+        }
+        return word + std::to_string(n);
+    }
+}
+
+
+TEST(BPlusTreeSetTests, containsWhatWasAddedInAnyOrder)
+{
+    BPlusTreeSet<int> s;
+    std::set<int> expected;
+
+    std::mt19937 random{46};
+    for (int i = 0; i < 20000; ++i)
+    {
+        int n = static_cast<int>(random() % 50000) * 2;
+        s.add(n);
+        expected.insert(n);
+    }
+
+    expectSameAs(s, expected);
+    for (int i = -1; i < 100000; i += 2)
+    {
+        ASSERT_FALSE(s.contains(i));
+    }
+
+    EXPECT_GT(s.height(), 1u);
+}
+
+
+TEST(BPlusTreeSetTests, addingInAscendingOrderFillsTheNodes)
+{
+    BPlusTreeSet<int> ascending;
+    BPlusTreeSet<int> descending;
+    std::set<int> expected;
+
+    const int count = 100000;
+    for (int i = 0; i < count; ++i)
+    {
+        ascending.add(i);
+        descending.add(count - i - 1);
+        expected.insert(i);
+    }
+
+    expectSameAs(ascending, expected);
+    expectSameAs(descending, expected);
+
+    // full leaves need fewer levels than half-full ones
+    EXPECT_LE(ascending.height(), descending.height());
+}
+
+
+TEST(BPlusTreeSetTests, comparesFullStringsWhenSlicesMatch)
+{
+    BPlusTreeSet<std::string> s;
+    std::set<std::string> expected;
+
+    std::mt19937 random{19};
+    for (int i = 0; i < 5000; ++i)
+    {
+        std::string word = wordFor(random() % 20000);
+        s.add(word);
+        expected.insert(word);
+    }
+
+    // short strings, strings with the same first eight characters, and
+    // characters above 127
+    for (std::string word : {"", "A", "PREFIXED", "PREFIXED\xff", "\xff\xfe", "PREFIXE"})
+    {
+        s.add(word);
+        expected.insert(word);
+    }
+
+    expectSameAs(s, expected);
+    EXPECT_FALSE(s.contains("PREFIXED0Z"));
+    EXPECT_FALSE(s.contains("PREFIXED\xfe"));
+    EXPECT_FALSE(s.contains("B"));
+}
+
+
+TEST(BPlusTreeSetTests, assignSortedBuildsTheSameSet)
+{
+    std::vector<std::string> words;
+    for (unsigned int i = 0; i < 30000; ++i)
+    {
+        words.push_back(wordFor(i));
+    }
+    std::sort(words.begin(), words.end());
+
+    // repeats are skipped
+    std::vector<std::string> withRepeats{words};
+    withRepeats.insert(withRepeats.begin() + 100, words[100]);
+
+    BPlusTreeSet<std::string> s;
+    s.add("GONE");
+    s.assignSorted(withRepeats.begin(), withRepeats.end());
+
+    expectSameAs(s, std::set<std::string>{words.begin(), words.end()});
+    EXPECT_FALSE(s.contains("GONE"));
+
+    // and the tree can still be added to afterward
+    s.add("AAA");
+    s.add("ZZZ");
+    s.add(words[500] + "!");
+    EXPECT_EQ(words.size() + 3, s.size());
+    EXPECT_TRUE(s.contains(words[500] + "!"));
+    EXPECT_TRUE(std::is_sorted(s.begin(), s.end()));
+}
+
+
+TEST(BPlusTreeSetTests, assignSortedRejectsUnsortedInputAndLeavesTheSetAlone)
+{
+    BPlusTreeSet<int> s;
+    s.add(7);
+
+    std::vector<int> unsorted{1, 2, 4, 3};
+    EXPECT_THROW(s.assignSorted(unsorted.begin(), unsorted.end()), SetException);
+
+    EXPECT_EQ(1, s.size());
+    EXPECT_TRUE(s.contains(7));
+}
+
+
+TEST(BPlusTreeSetTests, canBeCopiedMovedAndCleared)
+{
+    BPlusTreeSet<int> s;
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i * 3 % 1000);
+    }
+
+    BPlusTreeSet<int> copy{s};
+    s.add(5000);
+    EXPECT_EQ(1000, copy.size());
+    EXPECT_FALSE(copy.contains(5000));
+    EXPECT_TRUE(std::equal(copy.begin(), copy.end(), s.begin()));
+
+    BPlusTreeSet<int> moved{std::move(s)};
+    EXPECT_EQ(1001, moved.size());
+    EXPECT_EQ(0, s.size());
+    EXPECT_TRUE(s.begin() == s.end());
+
+    copy = moved;
+    EXPECT_TRUE(copy.contains(5000));
+
+    copy.clear();
+    EXPECT_EQ(0, copy.size());
+    EXPECT_EQ(0u, copy.height());
+    EXPECT_FALSE(copy.contains(0));
+    copy.add(1);
+    EXPECT_TRUE(copy.contains(1));
+}
@@ -0,0 +1,217 @@
+// ConcurrentHashSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for ConcurrentHashSet and the EpochDomain it's built on.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ConcurrentHashSet.hpp"
+#include "EpochDomain.hpp"
+
+
+namespace
+{
+    unsigned int identityHash(const int& i)
+    {
+        return static_cast<unsigned int>(i);
+    }
+
+
+    unsigned int lengthHash(const std::string& s)
+    {
+        return static_cast<unsigned int>(s.length());
+    }
+}
+
+
+TEST(ConcurrentHashSetTests, inheritFromSet)
+{
+    ConcurrentHashSet<std::string> s{lengthHash};
+    Set<std::string>& ss = s;
+    EXPECT_TRUE(ss.isImplemented());
+    EXPECT_EQ(0, ss.size());
+}
+
+
+TEST(ConcurrentHashSetTests, containsOnlyElementsAdded)
+{
+    ConcurrentHashSet<std::string> s{lengthHash};
+    s.add("HELLO");
+    s.add("THERE");
+    s.add("BOO");
+    s.add("BOO");
+
+    EXPECT_EQ(3, s.size());
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_TRUE(s.contains("THERE"));
+    EXPECT_TRUE(s.contains("BOO"));
+    EXPECT_FALSE(s.contains("BOOK"));
+}
+
+
+TEST(ConcurrentHashSetTests, growsPastLoadFactor)
+{
+    ConcurrentHashSet<int> s{identityHash};
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(1000, s.size());
+    EXPECT_GE(s.capacity() * 4, s.size() * 5);
+    EXPECT_EQ(0, s.capacity() % ConcurrentHashSet<int>::STRIPES);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+}
+
+
+TEST(ConcurrentHashSetTests, aResizeThatThrowsLeavesTheSetUsable)
+{
+    // the hash function fails on the element 7 whenever it's told to,
+    // which will be partway through copying the array
+    bool fail = false;
+    ConcurrentHashSet<int> s{[&fail](const int& i)
+    {
+        if (fail && i == 7)
+        {
+            throw std::runtime_error{"hash failed"};
+        }
+
+        return static_cast<unsigned int>(i);
+    }};
+
+    for (int i = 0; i < 12; ++i)
+    {
+        s.add(i);
+    }
+
+    fail = true;
+    EXPECT_THROW(s.add(12), std::runtime_error);
+    EXPECT_EQ(16, s.capacity());
+    fail = false;
+
+    // if the stripes were still locked, this would never finish
+    for (int i = 13; i < 100; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(100, s.size());
+    EXPECT_GT(s.capacity(), 100);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+}
+
+
+TEST(ConcurrentHashSetTests, concurrentAddsAreAllKept)
+{
+    constexpr int threadCount = 4;
+    constexpr int perThread = 5000;
+
+    ConcurrentHashSet<int> s{identityHash};
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&s, t] {
+            // every thread also adds some elements that others add
+            for (int i = 0; i < perThread; ++i)
+            {
+                s.add(t * perThread + i);
+                s.add(i);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(threadCount * perThread, s.size());
+    for (int i = 0; i < threadCount * perThread; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+}
+
+
+TEST(ConcurrentHashSetTests, readersAlwaysFindElementsAddedBeforeThemDuringResizes)
+{
+    constexpr int preloaded = 1000;
+    constexpr int added = 50000;
+
+    ConcurrentHashSet<int> s{identityHash};
+    for (int i = 0; i < preloaded; ++i)
+    {
+        s.add(i);
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<int> misses{0};
+    std::vector<std::thread> readers;
+
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&] {
+            while (!done.load())
+            {
+                for (int i = 0; i < preloaded; ++i)
+                {
+                    if (!s.contains(i))
+                    {
+                        misses++;
+                    }
+                }
+            }
+        });
+    }
+
+    for (int i = preloaded; i < preloaded + added; ++i)
+    {
+        s.add(i);
+    }
+    done = true;
+
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(0, misses.load());
+    EXPECT_EQ(preloaded + added, s.size());
+}
+
+
+TEST(ConcurrentHashSetTests, synchronizeWaitsForExistingReadGuards)
+{
+    EpochDomain domain;
+    std::atomic<bool> synchronized{false};
+
+    std::unique_ptr<EpochDomain::ReadGuard> guard{new EpochDomain::ReadGuard{domain}};
+
+    std::thread writer{[&] {
+        domain.synchronize();
+        synchronized = true;
+    }};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(synchronized.load());
+
+    guard.reset();
+    writer.join();
+    EXPECT_TRUE(synchronized.load());
+}
+
@@ -0,0 +1,143 @@
+// ConcurrentSkipListSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for ConcurrentSkipListSet.
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ConcurrentSkipListSet.hpp"
+#include "SkipListTestSupport.hpp"
+
+
+TEST(ConcurrentSkipListSetTests, inheritFromSet)
+{
+    ConcurrentSkipListSet<std::string> s;
+    Set<std::string>& ss = s;
+    EXPECT_TRUE(ss.isImplemented());
+    EXPECT_EQ(0, ss.size());
+    EXPECT_FALSE(ss.contains(""));
+}
+
+
+TEST(ConcurrentSkipListSetTests, containsWhatWasAddedInAnyOrder)
+{
+    ConcurrentSkipListSet<std::string> s;
+    expectToContainWhatWasAdded(s);
+}
+
+
+TEST(ConcurrentSkipListSetTests, levelsFollowTheLevelTester)
+{
+    ConcurrentSkipListSet<int> s{std::make_unique<TrailingZerosLevelTester>()};
+    for (int i = 64; i >= 1; --i)
+    {
+        s.add(i);
+    }
+
+    expectTrailingZerosShape(s);
+}
+
+
+TEST(ConcurrentSkipListSetTests, concurrentAddsAreAllKeptExactlyOnce)
+{
+    constexpr int threadCount = 4;
+    constexpr int perThread = 5000;
+
+    ConcurrentSkipListSet<int> s;
+
+    // every thread adds its own elements and also everyone's multiples
+    // of 3, so that the same element is often added by several threads
+    // at once
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&s, t]()
+        {
+            for (int i = 0; i < perThread; ++i)
+            {
+                int n = i * threadCount + t;
+                s.add(n);
+                s.add(n - n % 3);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(threadCount * perThread, s.size());
+    EXPECT_EQ(threadCount * perThread, s.elementsOnLevel(0));
+    for (int n = 0; n < threadCount * perThread; ++n)
+    {
+        ASSERT_TRUE(s.contains(n)) << n;
+    }
+    EXPECT_FALSE(s.contains(-1));
+    EXPECT_FALSE(s.contains(threadCount * perThread));
+
+    // every level is a subset of the one below it
+    for (unsigned int level = 1; level < s.levelCount(); ++level)
+    {
+        EXPECT_LE(s.elementsOnLevel(level), s.elementsOnLevel(level - 1));
+    }
+}
+
+
+TEST(ConcurrentSkipListSetTests, readersNeverMissAnElementWhoseAddReturned)
+{
+    constexpr int count = 20000;
+
+    ConcurrentSkipListSet<int> s;
+    std::atomic<int> added{0};
+    std::atomic<bool> done{false};
+    std::atomic<int> misses{0};
+
+    // the elements 0, 2, 4, ... are added in order, so every one less
+    // than twice the count published so far has to be there
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&s, &added, &done, &misses, r]()
+        {
+            std::mt19937 random(r);
+
+            while (!done.load())
+            {
+                int n = added.load();
+                if (n > 0 && !s.contains(static_cast<int>(random() % n) * 2))
+                {
+                    misses++;
+                }
+
+                // odd numbers are never added
+                if (s.contains(static_cast<int>(random() % count) * 2 + 1))
+                {
+                    misses++;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        s.add(i * 2);
+        added.store(i + 1);
+    }
+
+    done.store(true);
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(0, misses.load());
+    EXPECT_EQ(count, s.size());
+}
@@ -0,0 +1,81 @@
+// EytzingerSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for EytzingerSet.
+
+#include <list>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AVLSet.hpp"
+#include "EytzingerSet.hpp"
+
+
+TEST(EytzingerSetTests, containsExactlyWhatItWasBuiltFrom)
+{
+    // every size up to a few levels deep, so that every shape of bottom
+    // level is covered
+    for (int n = 0; n < 70; ++n)
+    {
+        std::vector<int> elements;
+        for (int i = 0; i < n; ++i)
+        {
+            elements.push_back(i * 2);
+        }
+
+        EytzingerSet<int> s{elements.begin(), elements.end()};
+
+        EXPECT_EQ(n, s.size());
+        for (int i = -1; i <= n * 2; ++i)
+        {
+            ASSERT_EQ(i >= 0 && i % 2 == 0 && i < n * 2, s.contains(i)) << "n = " << n << ", i = " << i;
+        }
+    }
+}
+
+
+TEST(EytzingerSetTests, canBeBuiltFromAnAVLSet)
+{
+    AVLSet<std::string> tree;
+    for (std::string word : {"THERE", "HELLO", "BOO", "HI", "ALPHA"})
+    {
+        tree.add(word);
+    }
+
+    EytzingerSet<std::string> s{tree};
+
+    EXPECT_EQ(5, s.size());
+    EXPECT_TRUE(s.contains("ALPHA"));
+    EXPECT_TRUE(s.contains("THERE"));
+    EXPECT_FALSE(s.contains("HELL"));
+    EXPECT_FALSE(s.contains("ZZZ"));
+    EXPECT_FALSE(s.contains(""));
+}
+
+
+TEST(EytzingerSetTests, skipsRepeatsAndRejectsUnsortedInput)
+{
+    std::list<std::string> repeats{"A", "A", "B", "C", "C"};
+    EytzingerSet<std::string> s{repeats.begin(), repeats.end()};
+    EXPECT_EQ(3, s.size());
+    EXPECT_TRUE(s.contains("C"));
+
+    std::vector<std::string> unsorted{"A", "C", "B"};
+    EXPECT_THROW((EytzingerSet<std::string>{unsorted.begin(), unsorted.end()}), SetException);
+}
+
+
+TEST(EytzingerSetTests, isReadOnlyAndMovable)
+{
+    std::vector<int> elements{1, 2, 3};
+    EytzingerSet<int> s{elements.begin(), elements.end()};
+
+    EXPECT_THROW(s.add(4), SetException);
+
+    EytzingerSet<int> moved{std::move(s)};
+    EXPECT_TRUE(moved.contains(3));
+    EXPECT_EQ(0, s.size());
+    EXPECT_FALSE(s.contains(3));
+}
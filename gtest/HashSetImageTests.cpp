@@ -0,0 +1,286 @@
+// HashSetImageTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for HashSetImage.
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "HashSetImage.hpp"
+
+
+namespace
+{
+    unsigned int lengthHash(const std::string& s)
+    {
+        return static_cast<unsigned int>(s.length());
+    }
+
+
+    unsigned int firstLetterHash(const std::string& s)
+    {
+        return s.empty() ? 0 : static_cast<unsigned char>(s[0]);
+    }
+
+
+    std::string imagePath(const std::string& name)
+    {
+        return testing::TempDir() + "HashSetImageTests_" + name + ".img";
+    }
+
+
+    void writeSomeWords(const std::string& path)
+    {
+        std::vector<std::string> words{"HELLO", "THERE", "BOO", "HELLO", "ABDC", ""};
+        HashSetImage::write(path, words.begin(), words.end(), lengthHash);
+    }
+
+
+    // flips one byte at the given offset from the end of the file
+    void corruptFromEnd(const std::string& path, long offsetFromEnd)
+    {
+        std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+        file.seekg(-offsetFromEnd, std::ios::end);
+        char c = static_cast<char>(file.get());
+        file.seekp(-offsetFromEnd, std::ios::end);
+        file.put(static_cast<char>(c ^ 0x20));
+    }
+
+
+    // overwrites the 4-byte integer at the given offset from the start of
+    // the file; the header is 64 bytes, and the bucket boundaries follow
+    template <typename Value>
+    void overwriteAt(const std::string& path, long offset, Value value)
+    {
+        std::fstream file{path, std::ios::in | std::ios::out | std::ios::binary};
+        file.seekp(offset);
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+
+    // recomputes the header's checksum (FNV-1a over everything before it,
+    // the way HashSetImage does), as a forger who knows the format would
+    void resealTheHeader(const std::string& path)
+    {
+        constexpr long checksumOffset = 56;
+
+        char header[checksumOffset];
+        {
+            std::ifstream file{path, std::ios::binary};
+            file.read(header, checksumOffset);
+        }
+
+        unsigned long long hash = 14695981039346656037ull;
+        for (char c : header)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+
+        overwriteAt(path, checksumOffset, hash);
+    }
+}
+
+
+TEST(HashSetImageTests, containsWhatWasWritten)
+{
+    std::string path = imagePath("contains");
+    writeSomeWords(path);
+
+    HashSetImage image{path, lengthHash};
+    Set<std::string>& set = image;
+
+    EXPECT_TRUE(set.isImplemented());
+    EXPECT_EQ(5, set.size());
+    EXPECT_TRUE(set.contains("HELLO"));
+    EXPECT_TRUE(set.contains("THERE"));
+    EXPECT_TRUE(set.contains("BOO"));
+    EXPECT_TRUE(set.contains("ABDC"));
+    EXPECT_TRUE(set.contains(""));
+    EXPECT_FALSE(set.contains("HELL"));
+    EXPECT_FALSE(set.contains("HELLP"));
+    EXPECT_FALSE(set.contains("BOOO"));
+
+    std::remove(path.c_str());
+}
+
+
+TEST(HashSetImageTests, canWriteAnEmptyImage)
+{
+    std::string path = imagePath("empty");
+    std::vector<std::string> none;
+    HashSetImage::write(path, none.begin(), none.end(), lengthHash);
+
+    HashSetImage image{path, lengthHash};
+    EXPECT_EQ(0, image.size());
+    EXPECT_FALSE(image.contains(""));
+
+    std::remove(path.c_str());
+}
+
+
+TEST(HashSetImageTests, addIsRejected)
+{
+    std::string path = imagePath("add");
+    writeSomeWords(path);
+
+    HashSetImage image{path, lengthHash};
+    EXPECT_THROW(image.add("NEW"), SetException);
+    EXPECT_FALSE(image.contains("NEW"));
+
+    std::remove(path.c_str());
+}
+
+
+TEST(HashSetImageTests, movedImageKeepsItsMapping)
+{
+    std::string path = imagePath("move");
+    writeSomeWords(path);
+
+    HashSetImage image{path, lengthHash};
+    HashSetImage moved{std::move(image)};
+
+    EXPECT_TRUE(moved.contains("BOO"));
+    EXPECT_EQ(0, image.size());
+    EXPECT_FALSE(image.contains("BOO"));
+
+    std::remove(path.c_str());
+}
+
+
+TEST(HashSetImageTests, missingFileIsRejected)
+{
+    EXPECT_THROW(HashSetImage(imagePath("missing"), lengthHash), SetException);
+}
+
+
+TEST(HashSetImageTests, differentHashFunctionIsRejected)
+{
+    std::string path = imagePath("hash");
+    writeSomeWords(path);
+
+    EXPECT_THROW(HashSetImage(path, firstLetterHash), SetException);
+
+    std::remove(path.c_str());
+}
+
+
+TEST(HashSetImageTests, corruptedStringsFailTheChecksum)
+{
+    std::string path = imagePath("corrupt");
+    writeSomeWords(path);
+    corruptFromEnd(path, 2);
+
+    EXPECT_THROW(HashSetImage(path, lengthHash), SetException);
+
+    // without verification, the image opens (it's just wrong)
+    HashSetImage unverified{path, lengthHash, false};
+    EXPECT_EQ(5, unverified.size());
+
+    std::remove(path.c_str());
+}
+
+
+TEST(HashSetImageTests, fileThatIsNotAnImageIsRejected)
+{
+    std::string path = imagePath("notimage");
+    {
+        std::ofstream out{path};
+        out << "HELLO THERE BOO HELLO THERE BOO HELLO THERE BOO HELLO THERE BOO HELLO";
+    }
+
+    EXPECT_THROW(HashSetImage(path, lengthHash), SetException);
+
+    std::remove(path.c_str());
+}
+
+
+TEST(HashSetImageTests, inconsistentBucketsAreRejectedEvenWithoutTheChecksum)
+{
+    std::string path = imagePath("buckets");
+    writeSomeWords(path);
+
+    // the fourth bucket boundary, pointed far past the entries
+    overwriteAt(path, 64 + 3 * 4, 1000u);
+
+    EXPECT_THROW(HashSetImage(path, lengthHash, false), SetException);
+
+    std::remove(path.c_str());
+}
+
+
+TEST(HashSetImageTests, entriesOutsideTheStringsAreNeverRead)
+{
+    std::string path = imagePath("entries");
+    std::vector<std::string> words{"HELLO"};
+    HashSetImage::write(path, words.begin(), words.end(), lengthHash);
+
+    // one word means two buckets, so three bucket boundaries and then
+    // the word's entry, which begins with its offset
+    overwriteAt(path, 64 + 3 * 4, 0xfffffff0u);
+
+    HashSetImage image{path, lengthHash, false};
+    EXPECT_FALSE(image.contains("HELLO"));
+
+    std::remove(path.c_str());
+}
+
+
+TEST(HashSetImageTests, stringSizesThatWrapAroundAreRejected)
+{
+    std::string path = imagePath("wrap");
+    std::vector<std::string> words{"HELLO"};
+    HashSetImage::write(path, words.begin(), words.end(), lengthHash);
+
+    // claim a second element (whose 8 bytes of entry make the strings
+    // start past the end of the file) and 8 fewer bytes of strings than
+    // there are, which wraps around to a huge number; the total still
+    // adds up to the file's size, modulo 2^64
+    overwriteAt(path, 20, 2u);
+    overwriteAt(path, 32, 5ull - 8ull);
+    overwriteAt(path, 64 + 2 * 4, 2u);
+    resealTheHeader(path);
+
+    EXPECT_THROW(HashSetImage(path, lengthHash, false), SetException);
+
+    std::remove(path.c_str());
+}
+
+
+TEST(HashSetImageTests, concurrentWritersLeaveOneCompleteImage)
+{
+    std::string path = imagePath("writers");
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t)
+    {
+        writers.emplace_back([&path, t]()
+        {
+            std::vector<std::string> words;
+            for (int i = 0; i < 2000; ++i)
+            {
+                words.push_back(std::to_string(t) + "_" + std::to_string(i));
+            }
+
+            for (int round = 0; round < 5; ++round)
+            {
+                HashSetImage::write(path, words.begin(), words.end(), lengthHash);
+            }
+        });
+    }
+
+    for (std::thread& writer : writers)
+    {
+        writer.join();
+    }
+
+    HashSetImage image{path, lengthHash};
+    EXPECT_EQ(2000, image.size());
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,665 @@
+// HashSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the parts of HashSet that go beyond what the sanity
+// checks cover.
+
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AllocationCounter.hpp"
+#include "HashSet.hpp"
+#include "SetException.hpp"
+
+
+namespace
+{
+    unsigned int identityHash(const int& i)
+    {
+        return static_cast<unsigned int>(i);
+    }
+
+
+    unsigned int lengthHash(const std::string& s)
+    {
+        return static_cast<unsigned int>(s.length());
+    }
+
+
+    // an int whose copy constructor throws once a given number of copies
+    // have been made, and that keeps track of how many of its kind are
+    // alive, so that tests can tell whether a failed copy leaks
+    struct FragileInt
+    {
+        static int copiesLeft;
+        static int alive;
+
+        int value;
+
+        FragileInt(int value) : value{value} { alive++; }
+
+        FragileInt(const FragileInt& i)
+            : value{i.value}
+        {
+            if (copiesLeft-- == 0)
+            {
+                throw std::runtime_error{"copy failed"};
+            }
+
+            alive++;
+        }
+
+        FragileInt& operator=(const FragileInt& i) = default;
+        ~FragileInt() { alive--; }
+
+        bool operator==(const FragileInt& i) const { return value == i.value; }
+    };
+
+    int FragileInt::copiesLeft = -1;
+    int FragileInt::alive = 0;
+
+
+    unsigned int fragileHash(const FragileInt& i)
+    {
+        return static_cast<unsigned int>(i.value);
+    }
+}
+
+
+TEST(HashSetTests, reserveKeepsExistingElements)
+{
+    HashSet<int> s{identityHash};
+    for (int i = 0; i < 8; ++i)
+    {
+        s.add(i);
+    }
+
+    s.reserve(1000);
+
+    EXPECT_EQ(8, s.size());
+    for (int i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+        EXPECT_TRUE(s.isElementAtIndex(i, i));
+    }
+    EXPECT_FALSE(s.contains(8));
+}
+
+
+TEST(HashSetTests, reservePresizesSoAddsStayInTheirIndex)
+{
+    HashSet<int> s{identityHash};
+    s.reserve(1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    // with an identity hash, an element only leaves index i if the
+    // array was resized after it was added
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(s.isElementAtIndex(i, i));
+    }
+}
+
+
+TEST(HashSetTests, canBulkConstructFromForwardRange)
+{
+    std::vector<std::string> words{"BOO", "HELLO", "THERE", "BOO", "HI"};
+    HashSet<std::string> s{words.begin(), words.end(), lengthHash};
+
+    EXPECT_EQ(4, s.size());
+    EXPECT_TRUE(s.contains("BOO"));
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_TRUE(s.contains("THERE"));
+    EXPECT_TRUE(s.contains("HI"));
+    EXPECT_FALSE(s.contains("HELL"));
+}
+
+
+TEST(HashSetTests, canBulkConstructFromSinglePassRange)
+{
+    std::istringstream in{"BOO HELLO THERE HI"};
+    HashSet<std::string> s{
+        std::istream_iterator<std::string>{in}, std::istream_iterator<std::string>{},
+        lengthHash};
+
+    EXPECT_EQ(4, s.size());
+    EXPECT_TRUE(s.contains("THERE"));
+}
+
+
+TEST(HashSetTests, copiesAreIndependentAndKeepTheHashFunction)
+{
+    std::list<int> elements;
+    for (int i = 0; i < 100; ++i)
+    {
+        elements.push_back(i);
+    }
+
+    HashSet<int> s{elements.begin(), elements.end(), identityHash};
+    HashSet<int> copy{s};
+    copy.add(100);
+
+    EXPECT_EQ(100, s.size());
+    EXPECT_EQ(101, copy.size());
+    EXPECT_FALSE(s.contains(100));
+
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_TRUE(copy.contains(i));
+        EXPECT_TRUE(copy.isElementAtIndex(i, i));
+    }
+}
+
+
+TEST(HashSetTests, copyAssignmentThatFailsLeavesTheSetUnchanged)
+{
+    {
+        HashSet<FragileInt> s{fragileHash};
+        HashSet<FragileInt> t{fragileHash};
+        for (int i = 0; i < 10; ++i)
+        {
+            s.add(FragileInt{i});
+            t.add(FragileInt{i + 100});
+        }
+
+        int aliveBefore = FragileInt::alive;
+
+        // the sixth element copied fails
+        FragileInt::copiesLeft = 5;
+        EXPECT_THROW(s = t, std::runtime_error);
+        FragileInt::copiesLeft = -1;
+
+        EXPECT_EQ(aliveBefore, FragileInt::alive);
+        EXPECT_EQ(10, s.size());
+        for (int i = 0; i < 10; ++i)
+        {
+            EXPECT_TRUE(s.contains(FragileInt{i}));
+            EXPECT_FALSE(s.contains(FragileInt{i + 100}));
+        }
+
+        s = t;
+        EXPECT_TRUE(s.contains(FragileInt{109}));
+        EXPECT_FALSE(s.contains(FragileInt{9}));
+    }
+
+    EXPECT_EQ(0, FragileInt::alive);
+}
+
+
+TEST(HashSetTests, elementsSurviveManyResizes)
+{
+    HashSet<int> s{identityHash};
+    for (int i = 0; i < 5000; ++i)
+    {
+        s.add(i * 7);
+    }
+
+    EXPECT_EQ(5000, s.size());
+    for (int i = 0; i < 5000; ++i)
+    {
+        EXPECT_TRUE(s.contains(i * 7));
+    }
+}
+
+
+TEST(HashSetTests, containsManyAgreesWithContains)
+{
+    HashSet<int> s{identityHash};
+    for (int i = 0; i < 100; i += 3)
+    {
+        s.add(i);
+    }
+
+    int elements[40];
+    bool results[40];
+    for (int i = 0; i < 40; ++i)
+    {
+        elements[i] = i * 2;
+    }
+
+    s.containsMany(elements, 40, results);
+
+    for (int i = 0; i < 40; ++i)
+    {
+        EXPECT_EQ(s.contains(elements[i]), results[i]);
+    }
+}
+
+
+TEST(HashSetTests, resizesOnceLoadFactorExceedsPointEight)
+{
+    HashSet<int> s{identityHash};
+    for (int i = 0; i < 8; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_EQ(10, s.stats().capacity);
+
+    s.add(8);
+
+    EXPECT_EQ(20, s.stats().capacity);
+    EXPECT_EQ(1, s.stats().resizeCount);
+}
+
+
+TEST(HashSetTests, statsDescribeChainLengths)
+{
+    HashSet<int> s{identityHash};
+    s.add(1);
+    s.add(11);
+    s.add(21);
+    s.add(2);
+
+    HashSetStats stats = s.stats();
+
+    EXPECT_EQ(10, stats.capacity);
+    EXPECT_EQ(4, stats.size);
+    EXPECT_EQ(2, stats.occupiedIndexes);
+    EXPECT_EQ(3, stats.longestChain);
+    EXPECT_DOUBLE_EQ(2.0, stats.meanChainLength());
+    EXPECT_EQ(8, stats.chainLengthHistogram[0]);
+    EXPECT_EQ(1, stats.chainLengthHistogram[1]);
+    EXPECT_EQ(0, stats.chainLengthHistogram[2]);
+    EXPECT_EQ(1, stats.chainLengthHistogram[3]);
+}
+
+
+TEST(HashSetTests, statsCountProbesPerLookup)
+{
+    HashSet<int> s{identityHash};
+    s.add(1);
+    s.add(11);
+    s.add(21);
+
+    s.contains(1);
+    s.contains(21);
+    s.contains(5);
+
+    HashSetStats stats = s.stats();
+
+    EXPECT_EQ(3, stats.lookups);
+    EXPECT_EQ(4, stats.probes);
+
+    std::ostringstream out;
+    out << stats;
+    EXPECT_NE(std::string::npos, out.str().find("probes per lookup"));
+}
+
+
+TEST(HashSetTests, constSetsCanBeSearchedFromManyThreadsAtOnce)
+{
+    HashSet<int> s{identityHash};
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    constexpr int threadCount = 4;
+    constexpr int lookupsPerThread = 10000;
+
+    // the lookups update the counters that stats() reports, which has to
+    // be safe (and exact) even though the set is shared as const
+    const HashSet<int>& shared = s;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&shared, t]()
+        {
+            bool results[10];
+            int elements[10];
+            for (int i = 0; i < lookupsPerThread; i += 20)
+            {
+                for (int j = 0; j < 10; ++j)
+                {
+                    shared.contains((i + j + t) % 2000);
+                    elements[j] = (i + j) % 1000;
+                }
+                shared.containsMany(elements, 10, results);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(static_cast<unsigned long long>(threadCount) * lookupsPerThread, s.stats().lookups);
+}
+
+
+TEST(HashSetTests, movingStealsTheArrayWithoutAllocating)
+{
+    HashSet<std::string> s{lengthHash};
+    s.add("HELLO");
+    s.add("THERE");
+    s.add("BOO");
+
+    unsigned long long before = allocationCount();
+    HashSet<std::string> moved{std::move(s)};
+    HashSet<std::string> assigned{lengthHash};
+    unsigned long long afterConstructing = allocationCount();
+    assigned = std::move(moved);
+    moved.swap(assigned);
+    unsigned long long after = allocationCount();
+
+    // only constructing "assigned" itself allocated anything
+    EXPECT_EQ(before + 1, afterConstructing);
+    EXPECT_EQ(afterConstructing, after);
+
+    EXPECT_EQ(3, moved.size());
+    EXPECT_TRUE(moved.contains("THERE"));
+    EXPECT_EQ(0, assigned.size());
+    EXPECT_EQ(0, s.size());
+    EXPECT_FALSE(s.contains("HELLO"));
+    EXPECT_EQ(0, s.elementsAtIndex(0));
+}
+
+
+TEST(HashSetTests, movedFromSetCanBeReassignedAndReused)
+{
+    HashSet<int> s{identityHash};
+    s.add(1);
+
+    HashSet<int> moved{std::move(s)};
+    s = HashSet<int>{identityHash};
+    s.add(2);
+
+    EXPECT_EQ(1, s.size());
+    EXPECT_TRUE(s.contains(2));
+    EXPECT_TRUE(moved.contains(1));
+}
+
+
+TEST(HashSetTests, movedFromSetsRejectAddsUntilTheyreAssignedAgain)
+{
+    HashSet<int> s{identityHash};
+    s.add(1);
+
+    HashSet<int> moved{std::move(s)};
+    EXPECT_EQ(0, s.size());
+    EXPECT_FALSE(s.contains(1));
+    EXPECT_THROW(s.add(2), SetException);
+    EXPECT_THROW(s.reserve(100), SetException);
+    EXPECT_EQ(0, s.size());
+
+    EXPECT_EQ(1, moved.size());
+    moved.add(2);
+    EXPECT_TRUE(moved.contains(2));
+
+    // assigning gives it a hash function again
+    s = HashSet<int>{identityHash};
+    s.add(12);
+    EXPECT_TRUE(s.contains(12));
+
+    HashSet<int> assigned{identityHash};
+    assigned = std::move(moved);
+    EXPECT_THROW(moved.add(3), SetException);
+    EXPECT_TRUE(assigned.contains(1));
+
+    moved = assigned;
+    moved.add(3);
+    EXPECT_TRUE(moved.contains(3));
+    EXPECT_FALSE(assigned.contains(3));
+}
+
+
+TEST(HashSetTests, iteratesOverEveryElementOnce)
+{
+    HashSet<int> s{identityHash};
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i * 3);
+    }
+
+    std::vector<int> seen;
+    for (int element : s)
+    {
+        seen.push_back(element);
+    }
+
+    std::sort(seen.begin(), seen.end());
+    ASSERT_EQ(1000, seen.size());
+    for (int i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(i * 3, seen[i]);
+    }
+}
+
+
+TEST(HashSetTests, iteratingAnEmptyOrMovedFromSetVisitsNothing)
+{
+    HashSet<int> s{identityHash};
+    EXPECT_EQ(s.begin(), s.end());
+
+    s.add(1);
+    HashSet<int> moved{std::move(s)};
+    EXPECT_EQ(s.begin(), s.end());
+    EXPECT_EQ(1, std::distance(moved.begin(), moved.end()));
+}
+
+
+TEST(HashSetTests, iteratingAllocatesNothing)
+{
+    HashSet<std::string> s{lengthHash};
+    s.add("BOO");
+    s.add("HELLO");
+    s.add("THERE");
+
+    unsigned long long before = allocationCount();
+    std::size_t totalLength = 0;
+    for (const std::string& element : s)
+    {
+        totalLength += element.size();
+    }
+    EXPECT_EQ(before, allocationCount());
+    EXPECT_EQ(13, totalLength);
+}
+
+
+TEST(HashSetTests, parallelForEachVisitsEveryElementOnceWithPerWorkerState)
+{
+    // the elements are spread across the whole array, so that every
+    // worker has some of them
+    HashSet<int> s{identityHash};
+    s.reserve(10000);
+    for (int i = 0; i < 10000; ++i)
+    {
+        s.add(i);
+    }
+
+    constexpr unsigned int workers = 4;
+    long long sums[workers] = {};
+    unsigned int counts[workers] = {};
+
+    s.parallelForEach(
+        [&](int element, unsigned int worker)
+        {
+            sums[worker] += element;
+            counts[worker]++;
+        },
+        workers);
+
+    long long sum = 0;
+    unsigned int count = 0;
+    for (unsigned int w = 0; w < workers; ++w)
+    {
+        sum += sums[w];
+        count += counts[w];
+        EXPECT_GT(counts[w], 0);
+    }
+
+    EXPECT_EQ(10000, count);
+    EXPECT_EQ(10000LL * 9999 / 2, sum);
+}
+
+
+TEST(HashSetTests, parallelForEachRethrowsWhatItsFunctionThrows)
+{
+    HashSet<int> s{identityHash};
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_THROW(
+        s.parallelForEach(
+            [](int element, unsigned int)
+            {
+                if (element == 57)
+                {
+                    throw std::runtime_error{"57"};
+                }
+            },
+            3),
+        std::runtime_error);
+}
+
+
+TEST(HashSetTests, removeUnlinksOnlyThatElement)
+{
+    HashSet<int> s{identityHash};
+    s.add(1);
+    s.add(11);
+    s.add(21);
+    s.add(2);
+
+    EXPECT_TRUE(s.remove(11));
+    EXPECT_FALSE(s.remove(11));
+    EXPECT_FALSE(s.remove(31));
+
+    EXPECT_EQ(3, s.size());
+    EXPECT_FALSE(s.contains(11));
+    EXPECT_TRUE(s.contains(1));
+    EXPECT_TRUE(s.contains(21));
+    EXPECT_EQ(2, s.elementsAtIndex(1));
+
+    EXPECT_TRUE(s.remove(2));
+    EXPECT_EQ(1, s.stats().occupiedIndexes);
+}
+
+
+TEST(HashSetTests, addReusesRemovedNodesWithoutAllocating)
+{
+    HashSet<int> s{identityHash};
+    for (int i = 0; i < 8; ++i)
+    {
+        s.add(i);
+    }
+
+    unsigned long long before = allocationCount();
+    for (int i = 0; i < 8; ++i)
+    {
+        s.remove(i);
+        s.add(i + 100);
+    }
+    EXPECT_EQ(before, allocationCount());
+
+    EXPECT_EQ(8, s.size());
+    EXPECT_TRUE(s.contains(107));
+    EXPECT_FALSE(s.contains(7));
+}
+
+
+TEST(HashSetTests, doesNotShrinkUnlessAskedTo)
+{
+    HashSet<int> s{identityHash};
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+    unsigned int grownCapacity = s.stats().capacity;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.remove(i);
+    }
+
+    EXPECT_EQ(0, s.size());
+    EXPECT_EQ(grownCapacity, s.stats().capacity);
+}
+
+
+TEST(HashSetTests, shrinksByHalfBelowPointTwoWhenAskedTo)
+{
+    HashSet<int> s{identityHash};
+    s.setShrinkOnLowLoad(true);
+    s.reserve(80);
+    for (int i = 0; i < 80; ++i)
+    {
+        s.add(i);
+    }
+    ASSERT_EQ(100, s.stats().capacity);
+
+    // 20 of 100 is still 0.2, which doesn't shrink
+    for (int i = 20; i < 80; ++i)
+    {
+        s.remove(i);
+    }
+    EXPECT_EQ(100, s.stats().capacity);
+
+    s.remove(19);
+    EXPECT_EQ(50, s.stats().capacity);
+
+    // a load of 0.38 is nowhere near growing again
+    s.add(19);
+    EXPECT_EQ(50, s.stats().capacity);
+
+    for (int i = 0; i < 19; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+}
+
+
+TEST(HashSetTests, neverShrinksBelowTheDefaultCapacity)
+{
+    HashSet<int> s{identityHash};
+    s.setShrinkOnLowLoad(true);
+    for (int i = 0; i < 100; ++i)
+    {
+        s.add(i);
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        s.remove(i);
+    }
+
+    EXPECT_EQ(HashSet<int>::DEFAULT_CAPACITY, s.stats().capacity);
+}
+
+
+TEST(HashSetTests, shrinkToFitSizesTheArrayForWhatsLeft)
+{
+    HashSet<int> s{identityHash};
+    for (int i = 0; i < 1000; ++i)
+    {
+        s.add(i);
+    }
+    for (int i = 80; i < 1000; ++i)
+    {
+        s.remove(i);
+    }
+
+    s.shrinkToFit();
+
+    EXPECT_EQ(100, s.stats().capacity);
+    EXPECT_EQ(80, s.size());
+    for (int i = 0; i < 80; ++i)
+    {
+        EXPECT_TRUE(s.contains(i));
+    }
+}
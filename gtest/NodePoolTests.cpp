@@ -0,0 +1,148 @@
+// NodePoolTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for NodePool.
+
+#include <string>
+#include <gtest/gtest.h>
+#include "AllocationCounter.hpp"
+#include "NodePool.hpp"
+
+
+namespace
+{
+    struct Node
+    {
+        std::string value;
+        Node* next = nullptr;
+    };
+
+
+    struct CountedNode
+    {
+        static int alive;
+
+        CountedNode()
+        {
+            ++alive;
+        }
+
+        ~CountedNode()
+        {
+            --alive;
+        }
+    };
+
+    int CountedNode::alive = 0;
+}
+
+
+TEST(NodePoolTests, makesNodesFromTheirMembers)
+{
+    NodePool<Node> pool;
+    Node* first = pool.make("HELLO");
+    Node* second = pool.make("THERE", first);
+
+    EXPECT_EQ("HELLO", first->value);
+    EXPECT_EQ(nullptr, first->next);
+    EXPECT_EQ("THERE", second->value);
+    EXPECT_EQ(first, second->next);
+    EXPECT_EQ(2, pool.size());
+}
+
+
+TEST(NodePoolTests, allocatesInBlocks)
+{
+    NodePool<int> pool;
+
+    unsigned long long before = allocationCount();
+    for (unsigned int i = 0; i < NodePool<int>::FIRST_BLOCK_CAPACITY; ++i)
+    {
+        pool.make(static_cast<int>(i));
+    }
+    EXPECT_EQ(1, pool.blockCount());
+    unsigned long long firstBlockBytes = pool.bytesAllocated();
+    EXPECT_GE(firstBlockBytes, NodePool<int>::FIRST_BLOCK_CAPACITY * sizeof(int));
+
+    // the next block is twice as big
+    pool.make(0);
+    EXPECT_EQ(2, pool.blockCount());
+    EXPECT_GE(pool.bytesAllocated() - firstBlockBytes, 2 * NodePool<int>::FIRST_BLOCK_CAPACITY * sizeof(int));
+
+    // a node at a time would have taken dozens of allocations
+    EXPECT_LE(allocationCount() - before, 4);
+}
+
+
+TEST(NodePoolTests, reservedNodesAreContiguous)
+{
+    NodePool<int> pool;
+    pool.make(1);
+    pool.reserve(1000);
+
+    unsigned long long before = allocationCount();
+    int* first = pool.make(0);
+    for (int i = 1; i < 1000; ++i)
+    {
+        EXPECT_EQ(first + i, pool.make(i));
+    }
+    EXPECT_EQ(before, allocationCount());
+}
+
+
+TEST(NodePoolTests, destroysEveryNode)
+{
+    {
+        NodePool<CountedNode> pool;
+        for (int i = 0; i < 100; ++i)
+        {
+            pool.make();
+        }
+
+        NodePool<CountedNode> moved{std::move(pool)};
+        EXPECT_EQ(100, CountedNode::alive);
+        EXPECT_EQ(0, pool.size());
+
+        moved.clear();
+        EXPECT_EQ(0, CountedNode::alive);
+        EXPECT_EQ(0, moved.bytesAllocated());
+
+        moved.make();
+    }
+
+    EXPECT_EQ(0, CountedNode::alive);
+}
+
+
+TEST(NodePoolTests, spliceMovesNodesWithoutCopyingThem)
+{
+    {
+        NodePool<CountedNode> pool;
+        NodePool<CountedNode> other;
+        pool.make();
+        for (int i = 0; i < 100; ++i)
+        {
+            other.make();
+        }
+        unsigned long long bytes = pool.bytesAllocated() + other.bytesAllocated();
+
+        unsigned long long before = allocationCount();
+        pool.splice(other);
+        EXPECT_EQ(before, allocationCount());
+
+        EXPECT_EQ(101, pool.size());
+        EXPECT_EQ(bytes, pool.bytesAllocated());
+        EXPECT_EQ(0, other.size());
+        EXPECT_EQ(0, other.bytesAllocated());
+        EXPECT_EQ(101, CountedNode::alive);
+
+        // the nodes belong to this pool now, so clearing the other one
+        // doesn't destroy them
+        other.clear();
+        EXPECT_EQ(101, CountedNode::alive);
+    }
+
+    EXPECT_EQ(0, CountedNode::alive);
+}
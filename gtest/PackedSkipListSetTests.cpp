@@ -0,0 +1,209 @@
+// PackedSkipListSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for PackedSkipListSet.
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <gtest/gtest.h>
+#include "AllocationCounter.hpp"
+#include "PackedSkipListSet.hpp"
+#include "SkipListTestSupport.hpp"
+
+
+namespace
+{
+    // an element that keeps track of how many of its kind are alive, so
+    // that tests can tell whether every element has been destroyed
+    struct Counted
+    {
+        static int alive;
+
+        std::string value;
+
+        Counted(const std::string& value = "") : value{value} { alive++; }
+        Counted(const Counted& c) : value{c.value} { alive++; }
+        ~Counted() { alive--; }
+
+        bool operator<(const Counted& c) const { return value < c.value; }
+        bool operator==(const Counted& c) const { return value == c.value; }
+    };
+
+    int Counted::alive = 0;
+
+
+    // an element whose copy constructor throws whenever it's told to
+    struct Fragile
+    {
+        static bool failCopies;
+
+        int value;
+
+        Fragile(int value) : value{value} { }
+
+        Fragile(const Fragile& f)
+            : value{f.value}
+        {
+            if (failCopies)
+            {
+                throw std::runtime_error{"copy failed"};
+            }
+        }
+
+        Fragile& operator=(const Fragile& f) = default;
+
+        bool operator<(const Fragile& f) const { return value < f.value; }
+        bool operator==(const Fragile& f) const { return value == f.value; }
+    };
+
+    bool Fragile::failCopies = false;
+
+
+    class AlwaysGrowLevelTester : public SkipListLevelTester<Fragile>
+    {
+    public:
+        virtual bool shouldOccupyNextLevel(const Fragile&) override
+        {
+            return true;
+        }
+
+        virtual std::unique_ptr<SkipListLevelTester<Fragile>> clone() override
+        {
+            return std::make_unique<AlwaysGrowLevelTester>();
+        }
+    };
+}
+
+
+TEST(PackedSkipListSetTests, levelsFollowTheLevelTester)
+{
+    PackedSkipListSet<int> s{std::make_unique<TrailingZerosLevelTester>()};
+    for (int i = 1; i <= 64; ++i)
+    {
+        s.add(i);
+    }
+
+    expectTrailingZerosShape(s);
+}
+
+
+TEST(PackedSkipListSetTests, containsWhatWasAddedInAnyOrder)
+{
+    PackedSkipListSet<std::string> s;
+    expectToContainWhatWasAdded(s);
+}
+
+
+TEST(PackedSkipListSetTests, towersAreCarvedOutOfLargeBlocks)
+{
+    PackedSkipListSet<int> s;
+
+    unsigned long long before = allocationCount();
+    for (int i = 1; i <= 100000; ++i)
+    {
+        s.add(i);
+    }
+
+    EXPECT_LT(allocationCount() - before, 100);
+    EXPECT_TRUE(s.contains(50000));
+}
+
+
+TEST(PackedSkipListSetTests, copiesHaveTheSameLevelsAndAreIndependent)
+{
+    PackedSkipListSet<int> s{std::make_unique<TrailingZerosLevelTester>()};
+    for (int i = 100; i >= 1; --i)
+    {
+        s.add(i);
+    }
+
+    PackedSkipListSet<int> copy{s};
+
+    EXPECT_EQ(100, copy.size());
+    EXPECT_EQ(s.levelCount(), copy.levelCount());
+    for (unsigned int level = 0; level < copy.levelCount(); ++level)
+    {
+        EXPECT_EQ(s.elementsOnLevel(level), copy.elementsOnLevel(level));
+    }
+    for (int i = 1; i <= 100; ++i)
+    {
+        ASSERT_TRUE(copy.contains(i));
+        EXPECT_EQ(s.isElementOnLevel(i, 3), copy.isElementOnLevel(i, 3));
+    }
+
+    s.add(1000);
+    EXPECT_FALSE(copy.contains(1000));
+
+    // the copy has its own level tester
+    copy.add(128);
+    EXPECT_TRUE(copy.isElementOnLevel(128, 7));
+
+    copy = s;
+    EXPECT_TRUE(copy.contains(1000));
+    EXPECT_FALSE(copy.contains(128));
+}
+
+
+TEST(PackedSkipListSetTests, movedFromSetsAreEmptyAndReusable)
+{
+    PackedSkipListSet<int> s;
+    s.add(1);
+    s.add(2);
+
+    PackedSkipListSet<int> moved{std::move(s)};
+    EXPECT_EQ(2, moved.size());
+    EXPECT_TRUE(moved.contains(2));
+
+    EXPECT_EQ(0, s.size());
+    EXPECT_EQ(1, s.levelCount());
+    EXPECT_FALSE(s.contains(1));
+
+    s.add(3);
+    EXPECT_TRUE(s.contains(3));
+    EXPECT_FALSE(moved.contains(3));
+}
+
+
+TEST(PackedSkipListSetTests, everyElementIsDestroyed)
+{
+    {
+        PackedSkipListSet<Counted> s;
+        for (int i = 0; i < 1000; ++i)
+        {
+            s.add(Counted{std::to_string(i * 7 % 500)});
+        }
+
+        PackedSkipListSet<Counted> copy{s};
+        EXPECT_EQ(500, copy.size());
+        EXPECT_TRUE(copy.contains(Counted{"499"}));
+        EXPECT_EQ(1000, Counted::alive);
+    }
+
+    EXPECT_EQ(0, Counted::alive);
+}
+
+
+TEST(PackedSkipListSetTests, aFailedAddLeavesTheLevelsAsTheyWere)
+{
+    PackedSkipListSet<Fragile> s{std::make_unique<AlwaysGrowLevelTester>()};
+
+    // the tower would be 12 levels tall, but the element can't be copied
+    // into it
+    Fragile::failCopies = true;
+    EXPECT_THROW(s.add(Fragile{1}), std::runtime_error);
+    Fragile::failCopies = false;
+
+    EXPECT_EQ(0, s.size());
+    EXPECT_EQ(1, s.levelCount());
+    EXPECT_EQ(0, s.elementsOnLevel(0));
+    EXPECT_EQ(0, s.elementsOnLevel(1));
+    EXPECT_FALSE(s.contains(Fragile{1}));
+
+    s.add(Fragile{1});
+    EXPECT_EQ(12, s.levelCount());
+    EXPECT_EQ(1, s.elementsOnLevel(11));
+    EXPECT_TRUE(s.contains(Fragile{1}));
+}
@@ -0,0 +1,104 @@
+// PerfectHashSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for PerfectHashSet.
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "PerfectHashSet.hpp"
+
+
+namespace
+{
+    std::vector<std::string> numberedWords(unsigned int count)
+    {
+        std::vector<std::string> words;
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            words.push_back("WORD" + std::to_string(i));
+        }
+        return words;
+    }
+}
+
+
+TEST(PerfectHashSetTests, inheritFromSet)
+{
+    std::vector<std::string> words{"HELLO"};
+    PerfectHashSet s{words.begin(), words.end()};
+    Set<std::string>& ss = s;
+
+    EXPECT_TRUE(ss.isImplemented());
+    EXPECT_EQ(1, ss.size());
+}
+
+
+TEST(PerfectHashSetTests, containsExactlyTheWordsItWasBuiltFrom)
+{
+    std::vector<std::string> words{"HELLO", "THERE", "BOO", "HELLO", "", "ABDC"};
+    PerfectHashSet s{words.begin(), words.end()};
+
+    EXPECT_EQ(5, s.size());
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_TRUE(s.contains("THERE"));
+    EXPECT_TRUE(s.contains("BOO"));
+    EXPECT_TRUE(s.contains(""));
+    EXPECT_TRUE(s.contains("ABDC"));
+    EXPECT_FALSE(s.contains("HELL"));
+    EXPECT_FALSE(s.contains("HELLOO"));
+    EXPECT_FALSE(s.contains("ABCD"));
+}
+
+
+TEST(PerfectHashSetTests, emptySetContainsNothing)
+{
+    std::vector<std::string> none;
+    PerfectHashSet s{none.begin(), none.end()};
+
+    EXPECT_EQ(0, s.size());
+    EXPECT_FALSE(s.contains(""));
+}
+
+
+TEST(PerfectHashSetTests, addIsRejected)
+{
+    std::vector<std::string> words{"HELLO"};
+    PerfectHashSet s{words.begin(), words.end()};
+
+    EXPECT_THROW(s.add("THERE"), SetException);
+    EXPECT_FALSE(s.contains("THERE"));
+}
+
+
+TEST(PerfectHashSetTests, worksForManyWords)
+{
+    std::vector<std::string> words = numberedWords(100000);
+    PerfectHashSet s{words.begin(), words.end()};
+
+    EXPECT_EQ(100000, s.size());
+    for (const std::string& word : words)
+    {
+        ASSERT_TRUE(s.contains(word));
+    }
+    for (unsigned int i = 100000; i < 110000; ++i)
+    {
+        ASSERT_FALSE(s.contains("WORD" + std::to_string(i)));
+    }
+
+    EXPECT_LT(s.hashBitsPerElement(), 4.5);
+}
+
+
+TEST(PerfectHashSetTests, movedSetKeepsItsWords)
+{
+    std::vector<std::string> words = numberedWords(100);
+    PerfectHashSet s{words.begin(), words.end()};
+    PerfectHashSet moved{std::move(s)};
+
+    EXPECT_TRUE(moved.contains("WORD42"));
+    EXPECT_EQ(0, s.size());
+    EXPECT_FALSE(s.contains("WORD42"));
+}
@@ -0,0 +1,199 @@
+// PersistentAVLSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for PersistentAVLSet and its Snapshots.
+
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AllocationCounter.hpp"
+#include "PersistentAVLSet.hpp"
+#include "WordChecker.hpp"
+
+
+namespace
+{
+    // an element that keeps track of how many of its kind are alive, so
+    // that tests can tell whether every node has been deleted
+    struct Counted
+    {
+        static int alive;
+
+        int value;
+
+        Counted(int value = 0) : value{value} { alive++; }
+        Counted(const Counted& c) : value{c.value} { alive++; }
+        ~Counted() { alive--; }
+        Counted& operator=(const Counted& c) = default;
+
+        bool operator<(const Counted& c) const { return value < c.value; }
+    };
+
+    int Counted::alive = 0;
+}
+
+
+TEST(PersistentAVLSetTests, containsWhatWasAddedAndStaysBalanced)
+{
+    PersistentAVLSet<int> s;
+    std::set<int> expected;
+
+    std::mt19937 random{46};
+    for (int i = 0; i < 20000; ++i)
+    {
+        int n = static_cast<int>(random() % 40000);
+        s.add(n);
+        expected.insert(n);
+    }
+
+    EXPECT_EQ(expected.size(), s.size());
+    for (int i = -1; i <= 40000; ++i)
+    {
+        ASSERT_EQ(expected.count(i) == 1, s.contains(i)) << i;
+    }
+
+    // an AVL tree is never taller than about 1.44 log2(n)
+    PersistentAVLSet<int>::Snapshot snapshot = s.snapshot();
+    EXPECT_LE(snapshot.height(), 1.45 * std::log2(expected.size() + 2));
+}
+
+
+TEST(PersistentAVLSetTests, addCopiesOnlyThePathToTheNewElement)
+{
+    PersistentAVLSet<int> s;
+    for (int i = 0; i < 4096; ++i)
+    {
+        s.add(i * 2);
+    }
+
+    int height = s.snapshot().height();
+
+    unsigned long long before = allocationCount();
+    s.add(4097);
+    unsigned long long after = allocationCount();
+
+    EXPECT_LE(after - before, static_cast<unsigned long long>(height) + 2);
+}
+
+
+TEST(PersistentAVLSetTests, snapshotsDoNotChangeWhenTheSetDoes)
+{
+    PersistentAVLSet<std::string> s;
+    s.add("HELLO");
+    s.add("THERE");
+
+    PersistentAVLSet<std::string>::Snapshot before = s.snapshot();
+    s.add("BOO");
+
+    EXPECT_EQ(3, s.size());
+    EXPECT_TRUE(s.contains("BOO"));
+    EXPECT_EQ(2, before.size());
+    EXPECT_FALSE(before.contains("BOO"));
+    EXPECT_TRUE(before.contains("HELLO"));
+
+    PersistentAVLSet<std::string>::Snapshot copy{before};
+    EXPECT_TRUE(copy.contains("THERE"));
+    EXPECT_THROW(copy.add("BOO"), SetException);
+}
+
+
+TEST(PersistentAVLSetTests, wordCheckersCanUseASnapshot)
+{
+    PersistentAVLSet<std::string> s;
+    s.add("HELLO");
+
+    PersistentAVLSet<std::string>::Snapshot words = s.snapshot();
+    WordChecker checker{words};
+    s.add("THERE");
+
+    EXPECT_TRUE(checker.wordExists("HELLO"));
+    EXPECT_FALSE(checker.wordExists("THERE"));
+}
+
+
+TEST(PersistentAVLSetTests, everyNodeIsDeletedOnceNothingSharesIt)
+{
+    {
+        PersistentAVLSet<Counted>::Snapshot outlives;
+
+        {
+            PersistentAVLSet<Counted> s;
+            for (int i = 0; i < 1000; ++i)
+            {
+                s.add(Counted{i * 7 % 1000});
+
+                if (i == 500)
+                {
+                    outlives = s.snapshot();
+                }
+            }
+
+            // only the current version's nodes, and those of the versions
+            // not yet let go of, are still around
+            EXPECT_LT(Counted::alive, 1000 + 64 * 20 + 501);
+        }
+
+        EXPECT_EQ(501, outlives.size());
+        EXPECT_TRUE(outlives.contains(Counted{7}));
+        EXPECT_EQ(501, Counted::alive);
+    }
+
+    EXPECT_EQ(0, Counted::alive);
+}
+
+
+TEST(PersistentAVLSetTests, readersSeeAConsistentVersionWhileAWriterAdds)
+{
+    PersistentAVLSet<int> s;
+    const int count = 20000;
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistencies{0};
+
+    // the writer adds 0, 1, 2, ... in order, so every version is exactly
+    // the elements less than its size
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&s, &done, &inconsistencies, r]()
+        {
+            std::mt19937 random(r);
+
+            while (!done.load())
+            {
+                PersistentAVLSet<int>::Snapshot snapshot = s.snapshot();
+                int n = static_cast<int>(snapshot.size());
+
+                if (n > 0 && (!snapshot.contains(static_cast<int>(random() % n)) || snapshot.contains(n)))
+                {
+                    inconsistencies++;
+                }
+
+                if (n > 0 && !s.contains(n - 1))
+                {
+                    inconsistencies++;
+                }
+            }
+        });
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        s.add(i);
+    }
+
+    done.store(true);
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    EXPECT_EQ(0, inconsistencies.load());
+    EXPECT_EQ(count, s.size());
+}
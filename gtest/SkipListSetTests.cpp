@@ -0,0 +1,238 @@
+// SkipListSetTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the parts of SkipListSet that go beyond what the sanity
+// checks cover.
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AllocationCounter.hpp"
+#include "SkipListSet.hpp"
+#include "SkipListTestSupport.hpp"
+
+
+namespace
+{
+    // an int that counts how many times it's been compared with <
+    struct Compared
+    {
+        static unsigned long long comparisons;
+
+        int value;
+
+        bool operator<(const Compared& c) const { comparisons++; return value < c.value; }
+        bool operator==(const Compared& c) const { return value == c.value; }
+    };
+
+    unsigned long long Compared::comparisons = 0;
+
+
+    class AlwaysGrowLevelTester : public SkipListLevelTester<int>
+    {
+    public:
+        virtual bool shouldOccupyNextLevel(const int&) override
+        {
+            return true;
+        }
+
+        virtual std::unique_ptr<SkipListLevelTester<int>> clone() override
+        {
+            return std::make_unique<AlwaysGrowLevelTester>();
+        }
+    };
+}
+
+
+TEST(SkipListSetTests, levelsFollowTheLevelTester)
+{
+    SkipListSet<int> s{std::make_unique<TrailingZerosLevelTester>()};
+    for (int i = 1; i <= 64; ++i)
+    {
+        s.add(i);
+    }
+
+    expectTrailingZerosShape(s);
+}
+
+
+TEST(SkipListSetTests, levelsAreCappedBasedOnSize)
+{
+    SkipListSet<int> s{std::make_unique<AlwaysGrowLevelTester>()};
+    s.add(1);
+    EXPECT_EQ(12, s.levelCount());
+
+    for (int i = 2; i <= 1000; ++i)
+    {
+        s.add(i);
+    }
+
+    // 3 * ceil(log2 1000)
+    EXPECT_EQ(30, s.levelCount());
+    // only the elements added after there were 512 reach the top
+    EXPECT_EQ(488, s.elementsOnLevel(29));
+    EXPECT_TRUE(s.isElementOnLevel(1000, 29));
+    EXPECT_FALSE(s.isElementOnLevel(1, 12));
+}
+
+
+TEST(SkipListSetTests, containsWhatWasAddedInAnyOrder)
+{
+    SkipListSet<std::string> s;
+    expectToContainWhatWasAdded(s);
+}
+
+
+TEST(SkipListSetTests, nodesComeFromAPool)
+{
+    SkipListSet<int> s{std::make_unique<TrailingZerosLevelTester>()};
+
+    unsigned long long before = allocationCount();
+    for (int i = 1; i <= 10000; ++i)
+    {
+        s.add(i);
+    }
+
+    // about 20000 nodes, but only a few dozen blocks
+    EXPECT_LT(allocationCount() - before, 100);
+}
+
+
+TEST(SkipListSetTests, copiesHaveTheSameLevelsAndAreIndependent)
+{
+    SkipListSet<int> s{std::make_unique<TrailingZerosLevelTester>()};
+    for (int i = 1; i <= 100; ++i)
+    {
+        s.add(i);
+    }
+
+    SkipListSet<int> copy{s};
+
+    EXPECT_EQ(100, copy.size());
+    EXPECT_EQ(s.levelCount(), copy.levelCount());
+    for (unsigned int level = 0; level < copy.levelCount(); ++level)
+    {
+        EXPECT_EQ(s.elementsOnLevel(level), copy.elementsOnLevel(level));
+    }
+    for (int i = 1; i <= 100; ++i)
+    {
+        ASSERT_TRUE(copy.contains(i));
+        EXPECT_EQ(s.isElementOnLevel(i, 3), copy.isElementOnLevel(i, 3));
+    }
+
+    s.add(1000);
+    EXPECT_FALSE(copy.contains(1000));
+
+    // the copy has its own level tester
+    copy.add(128);
+    EXPECT_TRUE(copy.isElementOnLevel(128, 7));
+
+    copy = s;
+    EXPECT_TRUE(copy.contains(1000));
+}
+
+
+TEST(SkipListSetTests, movedFromSetsAreEmptyAndReusable)
+{
+    SkipListSet<int> s;
+    s.add(1);
+    s.add(2);
+
+    SkipListSet<int> moved{std::move(s)};
+    EXPECT_EQ(2, moved.size());
+    EXPECT_TRUE(moved.contains(2));
+
+    EXPECT_EQ(0, s.size());
+    EXPECT_EQ(1, s.levelCount());
+    EXPECT_FALSE(s.contains(1));
+
+    s.add(3);
+    EXPECT_TRUE(s.contains(3));
+    EXPECT_FALSE(moved.contains(3));
+}
+
+
+TEST(SkipListSetTests, containsSortedAgreesWithContains)
+{
+    SkipListSet<int> s;
+    bool results[1] = {true};
+
+    // an empty range has no results to write
+    std::vector<int> none;
+    s.containsSorted(none.begin(), none.end(), results);
+    EXPECT_TRUE(results[0]);
+
+    // and an empty set contains nothing
+    std::vector<int> one{1};
+    s.containsSorted(one.begin(), one.end(), results);
+    EXPECT_FALSE(results[0]);
+
+    for (int i = 0; i < 5000; i += 3)
+    {
+        s.add(i);
+    }
+
+    // ascending with repeats, then a jump back to the beginning, and
+    // elements past both ends
+    std::vector<int> elements;
+    for (int i = -10; i < 5010; ++i)
+    {
+        elements.push_back(i);
+        if (i % 100 == 0)
+        {
+            elements.push_back(i);
+        }
+    }
+    for (int i = 0; i < 300; i += 7)
+    {
+        elements.push_back(i);
+    }
+
+    std::unique_ptr<bool[]> found{new bool[elements.size()]};
+    s.containsSorted(elements.begin(), elements.end(), found.get());
+
+    for (std::size_t i = 0; i < elements.size(); ++i)
+    {
+        ASSERT_EQ(s.contains(elements[i]), found[i]) << elements[i];
+    }
+}
+
+
+TEST(SkipListSetTests, containsSortedSearchesFromTheFinger)
+{
+    SkipListSet<Compared> s;
+    std::vector<Compared> elements;
+    for (int i = 0; i < 100000; ++i)
+    {
+        s.add(Compared{i * 2});
+
+        if (i >= 50000 && i < 51000)
+        {
+            elements.push_back(Compared{i * 2});
+            elements.push_back(Compared{i * 2 + 1});
+        }
+    }
+
+    Compared::comparisons = 0;
+    for (const Compared& element : elements)
+    {
+        s.contains(element);
+    }
+    unsigned long long fromTheTop = Compared::comparisons;
+
+    std::unique_ptr<bool[]> found{new bool[elements.size()]};
+    Compared::comparisons = 0;
+    s.containsSorted(elements.begin(), elements.end(), found.get());
+    unsigned long long fromTheFinger = Compared::comparisons;
+
+    // neighboring elements are about one step apart, instead of log2 n
+    // levels' worth of steps
+    EXPECT_LT(fromTheFinger * 4, fromTheTop);
+    for (std::size_t i = 0; i < elements.size(); ++i)
+    {
+        ASSERT_EQ(i % 2 == 0, found[i]);
+    }
+}
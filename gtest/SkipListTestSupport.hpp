@@ -0,0 +1,109 @@
+// SkipListTestSupport.hpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// What the tests of SkipListSet, ConcurrentSkipListSet, and
+// PackedSkipListSet have in common: a level tester that gives a skip list
+// of consecutive integers a predictable shape, and checks that every kind
+// of skip list has to pass.  The checks are templates, since the skip
+// lists share an interface but not a base class (other than Set).
+
+#ifndef SKIPLISTTESTSUPPORT_HPP
+#define SKIPLISTTESTSUPPORT_HPP
+
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <gtest/gtest.h>
+#include "SkipListSet.hpp"
+
+
+
+// A TrailingZerosLevelTester puts each element on as many levels as it
+// has trailing 0 bits, plus one, which is the shape a perfectly balanced
+// skip list of consecutive integers would have.
+class TrailingZerosLevelTester : public SkipListLevelTester<int>
+{
+public:
+    virtual bool shouldOccupyNextLevel(const int& element) override
+    {
+        if (element != last)
+        {
+            last = element;
+            flips = 0;
+        }
+
+        flips++;
+        return flips <= 31 && (element & ((1 << flips) - 1)) == 0;
+    }
+
+    virtual std::unique_ptr<SkipListLevelTester<int>> clone() override
+    {
+        return std::make_unique<TrailingZerosLevelTester>();
+    }
+
+private:
+    int last = -1;
+    int flips = 0;
+};
+
+
+
+// expectTrailingZerosShape() checks the levels of a skip list that holds
+// the integers 1 through 64 (added in any order) and was given a
+// TrailingZerosLevelTester.
+template <typename SkipListType>
+void expectTrailingZerosShape(const SkipListType& s)
+{
+    // 64 has six trailing zeros, so it's on levels 0 through 6
+    EXPECT_EQ(7, s.levelCount());
+    EXPECT_EQ(64, s.elementsOnLevel(0));
+    EXPECT_EQ(32, s.elementsOnLevel(1));
+    EXPECT_EQ(16, s.elementsOnLevel(2));
+    EXPECT_EQ(1, s.elementsOnLevel(6));
+    EXPECT_EQ(0, s.elementsOnLevel(7));
+
+    EXPECT_TRUE(s.isElementOnLevel(48, 4));
+    EXPECT_FALSE(s.isElementOnLevel(48, 5));
+    EXPECT_TRUE(s.isElementOnLevel(64, 6));
+    EXPECT_FALSE(s.isElementOnLevel(65, 0));
+    EXPECT_FALSE(s.isElementOnLevel(64, 7));
+}
+
+
+// expectToContainWhatWasAdded() adds thousands of words to an empty skip
+// list with random coin flips, in a scattered order and with repeats, and
+// checks that it contains exactly those words afterward and that it isn't
+// shaped too strangely.
+template <typename SkipListType>
+void expectToContainWhatWasAdded(SkipListType& s)
+{
+    std::set<std::string> expected;
+
+    std::mt19937 random{46};
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::string word = std::to_string(random() % 40000);
+        s.add(word);
+        expected.insert(word);
+    }
+
+    EXPECT_EQ(expected.size(), s.size());
+    EXPECT_EQ(expected.size(), s.elementsOnLevel(0));
+    for (int i = 0; i < 40000; ++i)
+    {
+        std::string word = std::to_string(i);
+        ASSERT_EQ(expected.count(word) == 1, s.contains(word)) << word;
+    }
+
+    // with fair coin flips, the list is very unlikely to be much taller
+    // than log2 n
+    EXPECT_LE(s.levelCount(), 3 * 15);
+    EXPECT_GE(s.levelCount(), 8);
+}
+
+
+
+#endif // SKIPLISTTESTSUPPORT_HPP
@@ -0,0 +1,138 @@
+// StringArenaTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for StringArena, ArenaString, and ArenaStringSet.
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "ArenaStringSet.hpp"
+#include "AVLSet.hpp"
+#include "HashSet.hpp"
+#include "StringArena.hpp"
+#include "WordChecker.hpp"
+
+
+TEST(StringArenaTests, storedStringsKeepTheirCharacters)
+{
+    StringArena arena;
+    std::string hello = "HELLO";
+
+    ArenaString stored = arena.store(hello);
+    hello[0] = 'J';
+
+    EXPECT_EQ("HELLO", stored.str());
+    EXPECT_NE(hello.data(), stored.data());
+    EXPECT_EQ(5, arena.bytesUsed());
+}
+
+
+TEST(StringArenaTests, handlesStayValidAsTheArenaGrowsAndMoves)
+{
+    StringArena arena;
+    std::vector<ArenaString> stored;
+    for (int i = 0; i < 20000; ++i)
+    {
+        stored.push_back(arena.store("WORD" + std::to_string(i)));
+    }
+
+    // one string bigger than a whole chunk
+    ArenaString big = arena.store(std::string(100000, 'Z'));
+
+    StringArena moved{std::move(arena)};
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        ASSERT_EQ("WORD" + std::to_string(i), stored[i].str());
+    }
+    EXPECT_EQ(std::string(100000, 'Z'), big.str());
+    EXPECT_GE(moved.bytesAllocated(), moved.bytesUsed());
+    EXPECT_EQ(0, arena.bytesUsed());
+}
+
+
+TEST(StringArenaTests, forgetLastTakesBackOnlyTheLastString)
+{
+    StringArena arena;
+    ArenaString first = arena.store(std::string{"FIRST"});
+    ArenaString second = arena.store(std::string{"SECOND"});
+
+    arena.forgetLast(first);
+    EXPECT_EQ(11, arena.bytesUsed());
+
+    arena.forgetLast(second);
+    EXPECT_EQ(5, arena.bytesUsed());
+}
+
+
+TEST(StringArenaTests, arenaStringsCompareLikeStdStrings)
+{
+    std::vector<std::string> strings{"", "A", "AB", "ABC", "ABD", "B", "\xff"};
+
+    for (const std::string& a : strings)
+    {
+        for (const std::string& b : strings)
+        {
+            ArenaString x = ArenaString::viewOf(a);
+            ArenaString y = ArenaString::viewOf(b);
+
+            EXPECT_EQ(a == b, x == y);
+            EXPECT_EQ(a != b, x != y);
+            EXPECT_EQ(a < b, x < y);
+            EXPECT_EQ(a > b, x > y);
+        }
+    }
+}
+
+
+TEST(StringArenaTests, arenaStringSetWorksOverAHashSet)
+{
+    ArenaStringSet<HashSet<ArenaString>> s{hashArenaString};
+    s.add("HELLO");
+    s.add("THERE");
+    s.add("HELLO");
+
+    EXPECT_TRUE(s.isImplemented());
+    EXPECT_EQ(2, s.size());
+    EXPECT_TRUE(s.contains("HELLO"));
+    EXPECT_TRUE(s.contains("THERE"));
+    EXPECT_FALSE(s.contains("HELL"));
+
+    // the duplicate's characters were taken back
+    EXPECT_EQ(10, s.arena().bytesUsed());
+    EXPECT_EQ(2, s.underlying().size());
+}
+
+
+TEST(StringArenaTests, arenaStringSetWorksOverAnAVLSet)
+{
+    ArenaStringSet<AVLSet<ArenaString>> s;
+    s.add("BOO");
+    s.add("HELLO");
+    s.add("THERE");
+
+    EXPECT_EQ(3, s.size());
+    EXPECT_TRUE(s.contains("BOO"));
+    EXPECT_FALSE(s.contains("BO"));
+
+    std::vector<std::string> inOrder;
+    s.underlying().inorder([&](const ArenaString& word) { inOrder.push_back(word.str()); });
+    EXPECT_EQ((std::vector<std::string>{"BOO", "HELLO", "THERE"}), inOrder);
+}
+
+
+TEST(StringArenaTests, wordCheckerCanUseAnArenaStringSet)
+{
+    ArenaStringSet<HashSet<ArenaString>> s{hashArenaString};
+    s.add("ABDC");
+    s.add("ZZZZZ");
+
+    WordChecker checker{s};
+
+    EXPECT_TRUE(checker.wordExists("ABDC"));
+    std::vector<std::string> suggestions = checker.findSuggestions("ABCD");
+    ASSERT_EQ(1, suggestions.size());
+    EXPECT_EQ("ABDC", suggestions[0]);
+}
@@ -0,0 +1,130 @@
+// StringHashesTests.cpp
+//
+// ICS 46 Winter 2019
+// Project #3: Set the Controls for the Heart of the Sun
+//
+// Unit tests for the string hash functions in StringHashes.hpp.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "HashSet.hpp"
+#include "StringArena.hpp"
+#include "StringHashes.hpp"
+
+
+namespace
+{
+    using Hash64 = unsigned long long (*)(const char*, std::size_t, unsigned long long);
+
+
+    std::string bytes(unsigned int length, unsigned int seed)
+    {
+        std::string s;
+        unsigned int x = seed * 2654435761u + 1;
+        for (unsigned int i = 0; i < length; ++i)
+        {
+            x = x * 1103515245u + 12345u;
+            s.push_back(static_cast<char>(x >> 16));
+        }
+        return s;
+    }
+
+
+    // flipping any one bit of the input should change the hash
+    void expectEveryBitMatters(Hash64 hash, unsigned int length)
+    {
+        std::string s = bytes(length, length);
+        unsigned long long original = hash(s.data(), s.size(), 0);
+
+        for (unsigned int i = 0; i < length * 8; ++i)
+        {
+            std::string flipped = s;
+            flipped[i / 8] = static_cast<char>(flipped[i / 8] ^ (1 << (i % 8)));
+            EXPECT_NE(original, hash(flipped.data(), flipped.size(), 0))
+                << "length " << length << ", bit " << i;
+        }
+    }
+}
+
+
+TEST(StringHashesTests, fnv1aMatchesPublishedValues)
+{
+    EXPECT_EQ(0xcbf29ce484222325ull, fnv1aHash64("", 0));
+    EXPECT_EQ(0xaf63dc4c8601ec8cull, fnv1aHash64("a", 1));
+    EXPECT_EQ(0x85944171f73967e8ull, fnv1aHash64("foobar", 6));
+}
+
+
+TEST(StringHashesTests, everyBitOfTheInputMatters)
+{
+    for (unsigned int length : {1u, 3u, 4u, 7u, 8u, 9u, 16u, 17u, 33u, 100u, 128u, 129u, 300u})
+    {
+        expectEveryBitMatters(wyHash64, length);
+        expectEveryBitMatters(xxh3Hash64, length);
+    }
+}
+
+
+TEST(StringHashesTests, lengthMattersEvenForRepeatedBytes)
+{
+    std::vector<unsigned long long> seen;
+    for (unsigned int length = 0; length <= 300; ++length)
+    {
+        std::string s(length, 'A');
+        seen.push_back(wyHash64(s.data(), s.size()));
+        seen.push_back(xxh3Hash64(s.data(), s.size()));
+    }
+
+    std::sort(seen.begin(), seen.end());
+    EXPECT_EQ(seen.end(), std::adjacent_find(seen.begin(), seen.end()));
+}
+
+
+TEST(StringHashesTests, seedChangesTheHash)
+{
+    std::string s = "HELLO";
+    EXPECT_NE(fnv1aHash64(s.data(), s.size(), 0), fnv1aHash64(s.data(), s.size(), 1));
+    EXPECT_NE(wyHash64(s.data(), s.size(), 0), wyHash64(s.data(), s.size(), 1));
+    EXPECT_NE(xxh3Hash64(s.data(), s.size(), 0), xxh3Hash64(s.data(), s.size(), 1));
+}
+
+
+TEST(StringHashesTests, xxh3LongKeysMatchTheScalarPath)
+{
+    for (unsigned int length = 0; length <= 2000; length += 7)
+    {
+        std::string s = bytes(length, length + 1);
+        EXPECT_EQ(xxh3Hash64Scalar(s.data(), s.size(), 42), xxh3Hash64(s.data(), s.size(), 42))
+            << "length " << length;
+    }
+}
+
+
+TEST(StringHashesTests, adaptersHashStringsAndArenaStringsAlike)
+{
+    std::string s = "THERE";
+    ArenaString view = ArenaString::viewOf(s);
+
+    EXPECT_EQ(fnv1aHash(s), fnv1aHash(view));
+    EXPECT_EQ(wyHash(s), wyHash(view));
+    EXPECT_EQ(xxh3Hash(s), xxh3Hash(view));
+}
+
+
+TEST(StringHashesTests, spreadsWordsEvenlyAcrossAHashSet)
+{
+    HashSet<std::string> s{wyHash<std::string>};
+    s.reserve(10000);
+    for (unsigned int i = 0; i < 10000; ++i)
+    {
+        s.add("WORD" + std::to_string(i));
+    }
+
+    // a uniformly random hash would leave chains of about 1.6 on average
+    // and rarely any longer than 8
+    HashSetStats stats = s.stats();
+    EXPECT_LT(stats.meanChainLength(), 1.8);
+    EXPECT_LE(stats.longestChain, 9);
+}